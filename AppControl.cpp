@@ -28,6 +28,8 @@ SOFTWARE.
 #include "preview_mode.h"
 #include "iracing.h"
 #include "stub_data.h"
+#include "Profiler.h"
+#include "Logger.h"
 #include <cassert>
 #include <cctype>
 
@@ -118,6 +120,22 @@ void app_set_startup_enabled(bool on)
     RegCloseKey(hKey);
 }
 
+bool app_export_profile_csv()
+{
+    return Profiler::instance().exportCsv("profile.csv");
+}
+
+bool app_dump_trace()
+{
+    const float seconds = g_cfg.getFloat("General", "trace_seconds", 10.0f);
+    const bool ok = Tracer::dump("trace.json", seconds);
+    if (ok)
+        Logger::instance().logInfo("Wrote trace.json");
+    else
+        Logger::instance().logError("Failed to write trace.json");
+    return ok;
+}
+
 static void setOverlayEnabled(const char* sectionKey, bool on)
 {
 	g_cfg.setBool(sectionKey, "enabled", on);
@@ -246,30 +264,36 @@ std::string app_get_state_json()
     const std::string buddiesJson = buildStringArrayJson("General", "buddies");
     const std::string flaggedJson = buildStringArrayJson("General", "flagged");
 
-    // Build ghost telemetry files list from assets/tracks/telemetry
+    // Build ghost telemetry files list from assets/tracks/telemetry: CSV exports and binary .ifg laps,
+    // leaving out the "<name>.csv.ifg" files converted from a CSV
     auto buildGhostFilesJson = [&]() -> std::string {
         std::string out = "";
         std::wstring dir = resolveAssetPathW(L"assets\\tracks\\telemetry\\");
-        WIN32_FIND_DATAW fd = {};
-        HANDLE h = FindFirstFileW((dir + L"*.csv").c_str(), &fd);
-        if (h != INVALID_HANDLE_VALUE)
+        bool first = true;
+        for (const wchar_t* pattern : { L"*.csv", L"*.ifg" })
         {
-            bool first = true;
-            do {
-                if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
-                    continue;
-                std::wstring fnameW(fd.cFileName);
-                // Convert to UTF-8
-                int required = WideCharToMultiByte(CP_UTF8, 0, fnameW.c_str(), -1, nullptr, 0, nullptr, nullptr);
-                std::string fname;
-                if (required > 1) {
-                    fname.resize(required - 1);
-                    WideCharToMultiByte(CP_UTF8, 0, fnameW.c_str(), -1, fname.data(), required - 1, nullptr, nullptr);
-                }
-                if (!first) out += ","; else first = false;
-                out += "\"" + escapeJson(fname) + "\"";
-            } while (FindNextFileW(h, &fd));
-            FindClose(h);
+            WIN32_FIND_DATAW fd = {};
+            HANDLE h = FindFirstFileW((dir + pattern).c_str(), &fd);
+            if (h != INVALID_HANDLE_VALUE)
+            {
+                do {
+                    if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                        continue;
+                    std::wstring fnameW(fd.cFileName);
+                    if (fnameW.size() > 8 && _wcsicmp(fnameW.c_str() + fnameW.size() - 8, L".csv.ifg") == 0)
+                        continue;
+                    // Convert to UTF-8
+                    int required = WideCharToMultiByte(CP_UTF8, 0, fnameW.c_str(), -1, nullptr, 0, nullptr, nullptr);
+                    std::string fname;
+                    if (required > 1) {
+                        fname.resize(required - 1);
+                        WideCharToMultiByte(CP_UTF8, 0, fnameW.c_str(), -1, fname.data(), required - 1, nullptr, nullptr);
+                    }
+                    if (!first) out += ","; else first = false;
+                    out += "\"" + escapeJson(fname) + "\"";
+                } while (FindNextFileW(h, &fd));
+                FindClose(h);
+            }
         }
         return out;
     };
@@ -306,12 +330,12 @@ std::string app_get_state_json()
         "\"ghostTelemetry\":{\"files\":[%s],\"selected\":\"%s\"},"
         "\"overlays\":{"
         "\"OverlayStandings\":%s,\"OverlayDDU\":%s,\"OverlayFuel\":%s,\"OverlayInputs\":%s,\"OverlayRelative\":%s,\"OverlayCover\":%s,\"OverlayWeather\":%s,\"OverlayFlags\":%s,\"OverlayDelta\":%s,\"OverlayRadar\":%s,\"OverlayTrack\":%s,\"OverlayTire\":%s,\"OverlayPit\":%s,\"OverlayTraffic\":%s},"
-        "\"config\":{\"General\":{\"units\":\"%s\",\"performance_mode_30hz\":%s,\"launch_at_startup\":%s,\"show_overlays_help\":%s,\"buddies\":[%s],\"flagged\":[%s]},"
-        "\"OverlayStandings\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"show_class_header_single\":%s,\"show_pit\":%s,\"show_license\":%s,\"show_irating\":%s,\"show_car_brand\":%s,\"show_positions_gained\":%s,\"show_gap\":%s,\"show_best\":%s,\"show_lap_time\":%s,\"show_delta\":%s,\"show_L5\":%s,\"show_SoF\":%s,\"show_laps\":%s,\"show_session_end\":%s,\"show_track_temp\":%s,\"show_tire_compound\":%s,\"show_full_name\":%s,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
+        "\"config\":{\"General\":{\"units\":\"%s\",\"performance_mode_30hz\":%s,\"launch_at_startup\":%s,\"show_overlays_help\":%s,\"profiler_enabled\":%s,\"trace_enabled\":%s,\"buddies\":[%s],\"flagged\":[%s]},"
+        "\"OverlayStandings\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"show_class_header_single\":%s,\"show_pit\":%s,\"show_license\":%s,\"show_irating\":%s,\"show_ir_pred\":%s,\"show_car_brand\":%s,\"show_positions_gained\":%s,\"show_gap\":%s,\"show_best\":%s,\"show_lap_time\":%s,\"show_sectors\":%s,\"show_delta\":%s,\"show_L5\":%s,\"show_SoF\":%s,\"show_laps\":%s,\"show_session_end\":%s,\"show_track_temp\":%s,\"show_tire_compound\":%s,\"show_full_name\":%s,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
 		"\"OverlayDDU\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
-        "\"OverlayFuel\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"fuel_estimate_factor\":%.2f,\"fuel_reserve_margin\":%.2f,\"fuel_target_lap\":%d,\"fuel_decimal_places\":%d,\"fuel_estimate_avg_green_laps\":%d,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
-        "\"OverlayInputs\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"steering_wheel\":\"%s\",\"left_side\":%s,\"show_steering_line\":%s,\"show_steering_wheel\":%s,\"show_ghost_data\":%s,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
-        "\"OverlayRelative\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"minimap_enabled\":%s,\"minimap_is_relative\":%s,\"show_ir_pred\":%s,\"show_irating\":%s,\"show_last\":%s,\"show_delta_in_replay\":%s,\"show_license\":%s,\"show_pit_age\":%s,\"show_sr\":%s,\"show_positions_gained\":%s,\"show_tire_compound\":%s,\"show_full_name\":%s,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
+        "\"OverlayFuel\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"fuel_estimate_factor\":%.2f,\"fuel_reserve_margin\":%.2f,\"fuel_target_lap\":%d,\"fuel_decimal_places\":%d,\"fuel_estimate_avg_green_laps\":%d,\"show_strategy\":%s,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
+        "\"OverlayInputs\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"steering_wheel\":\"%s\",\"left_side\":%s,\"show_steering_line\":%s,\"show_steering_wheel\":%s,\"show_ghost_data\":%s,\"use_pb_ghost\":%s,\"record_pb_ghost\":%s,\"time_based_trace\":%s,\"trace_seconds\":%.1f,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
+        "\"OverlayRelative\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"minimap_enabled\":%s,\"minimap_is_relative\":%s,\"show_ir_pred\":%s,\"show_irating\":%s,\"show_last\":%s,\"show_sectors\":%s,\"show_delta_in_replay\":%s,\"show_license\":%s,\"show_pit_age\":%s,\"show_sr\":%s,\"show_positions_gained\":%s,\"show_tire_compound\":%s,\"show_full_name\":%s,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
 		"\"OverlayCover\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
 		"\"OverlayWeather\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"preview_weather_type\":%d,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
 		"\"OverlayFlags\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"preview_flag\":\"%s\",\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
@@ -321,8 +345,8 @@ std::string app_get_state_json()
         "\"OverlayTire\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"show_only_in_pitlane\":%s,\"advanced_mode\":%s,\"pressure_use_psi\":%s,\"temp_cool_c\":%.1f,\"temp_opt_c\":%.1f,\"temp_hot_c\":%.1f,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
         "\"OverlayPit\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d},"
         "\"OverlayTraffic\":{\"enabled\":%s,\"toggle_hotkey\":\"%s\",\"opacity\":%d,\"target_fps\":%d,\"show_in_menu\":%s,\"show_in_race\":%s,\"show_in_replay\":%s,"
-            "\"require_different_class\":%s,\"ignore_cars_on_pit_road\":%s,\"hide_if_self_on_pit_road\":%s,\"show_distance_m\":%s,"
-            "\"warn_gap_seconds\":%.2f,\"urgent_gap_seconds\":%.2f,\"hold_seconds\":%.2f,\"faster_class_laptime_margin_s\":%.2f,"
+            "\"require_different_class\":%s,\"ignore_cars_on_pit_road\":%s,\"hide_if_self_on_pit_road\":%s,\"show_distance_m\":%s,\"ignore_not_closing\":%s,\"show_catch\":%s,"
+            "\"warn_gap_seconds\":%.2f,\"urgent_gap_seconds\":%.2f,\"hold_seconds\":%.2f,\"faster_class_laptime_margin_s\":%.2f,\"warn_catch_seconds\":%.2f,\"urgent_catch_seconds\":%.2f,"
             "\"font\":\"%s\",\"font_size\":%.2f,\"font_spacing\":%.2f,\"font_style\":\"%s\",\"font_weight\":%d}"
         "}}",
 		(s_uiEdit && *s_uiEdit) ? "true":"false",
@@ -353,6 +377,8 @@ std::string app_get_state_json()
 		boolStr(g_cfg.getBool("General","performance_mode_30hz",false)),
         launchAtStartup ? "true" : "false",
         boolStr(g_cfg.getBool("General","show_overlays_help", true)),
+        boolStr(g_cfg.getBool("General","profiler_enabled", false)),
+        boolStr(g_cfg.getBool("General","trace_enabled", false)),
         buddiesJson.c_str(),
         flaggedJson.c_str(),
 		// OverlayStandings config
@@ -367,11 +393,13 @@ std::string app_get_state_json()
 		boolStr(g_cfg.getBool("OverlayStandings","show_pit",true)),
 		boolStr(g_cfg.getBool("OverlayStandings","show_license",true)),
 		boolStr(g_cfg.getBool("OverlayStandings","show_irating",true)),
+		boolStr(g_cfg.getBool("OverlayStandings","show_ir_pred",false)),
 		boolStr(g_cfg.getBool("OverlayStandings","show_car_brand",true)),
 		boolStr(g_cfg.getBool("OverlayStandings","show_positions_gained",true)),
 		boolStr(g_cfg.getBool("OverlayStandings","show_gap",true)),
 		boolStr(g_cfg.getBool("OverlayStandings","show_best",true)),
 		boolStr(g_cfg.getBool("OverlayStandings","show_lap_time",true)),
+		boolStr(g_cfg.getBool("OverlayStandings","show_sectors",false)),
 		boolStr(g_cfg.getBool("OverlayStandings","show_delta",true)),
 		boolStr(g_cfg.getBool("OverlayStandings","show_L5",true)),
 		boolStr(g_cfg.getBool("OverlayStandings","show_SoF",true)),
@@ -412,6 +440,7 @@ std::string app_get_state_json()
         g_cfg.getInt("OverlayFuel","fuel_target_lap",0),
         g_cfg.getInt("OverlayFuel","fuel_decimal_places",2),
         g_cfg.getInt("OverlayFuel","fuel_estimate_avg_green_laps",4),
+        boolStr(g_cfg.getBool("OverlayFuel","show_strategy",false)),
         // Typography (per-overlay with built-in defaults)
         escapeJson(g_cfg.getString("OverlayFuel","font","Poppins")).c_str(),
         g_cfg.getFloat("OverlayFuel","font_size", 16.0f),
@@ -431,6 +460,10 @@ std::string app_get_state_json()
 		boolStr(g_cfg.getBool("OverlayInputs","show_steering_line",false)),
         boolStr(g_cfg.getBool("OverlayInputs","show_steering_wheel",true)),
         boolStr(g_cfg.getBool("OverlayInputs","show_ghost_data",false)),
+        boolStr(g_cfg.getBool("OverlayInputs","use_pb_ghost",true)),
+        boolStr(g_cfg.getBool("OverlayInputs","record_pb_ghost",true)),
+        boolStr(g_cfg.getBool("OverlayInputs","time_based_trace",false)),
+        g_cfg.getFloat("OverlayInputs","trace_seconds",5.0f),
 		escapeJson(g_cfg.getString("OverlayInputs","font","Poppins")).c_str(),
 		g_cfg.getFloat("OverlayInputs","font_size", 16.0f),
 		g_cfg.getFloat("OverlayInputs","font_spacing", 0.30f),
@@ -449,6 +482,7 @@ std::string app_get_state_json()
 		boolStr(g_cfg.getBool("OverlayRelative","show_ir_pred",false)),
 		boolStr(g_cfg.getBool("OverlayRelative","show_irating",true)),
 		boolStr(g_cfg.getBool("OverlayRelative","show_last",true)),
+		boolStr(g_cfg.getBool("OverlayRelative","show_sectors",false)),
         boolStr(g_cfg.getBool("OverlayRelative","show_delta_in_replay",false)),
 		boolStr(g_cfg.getBool("OverlayRelative","show_license",true)),
 		boolStr(g_cfg.getBool("OverlayRelative","show_pit_age",true)),
@@ -594,10 +628,14 @@ std::string app_get_state_json()
 		boolStr(g_cfg.getBool("OverlayTraffic","ignore_cars_on_pit_road",true)),
 		boolStr(g_cfg.getBool("OverlayTraffic","hide_if_self_on_pit_road",true)),
 		boolStr(g_cfg.getBool("OverlayTraffic","show_distance_m",true)),
+		boolStr(g_cfg.getBool("OverlayTraffic","ignore_not_closing",true)),
+		boolStr(g_cfg.getBool("OverlayTraffic","show_catch",true)),
 		g_cfg.getFloat("OverlayTraffic","warn_gap_seconds",2.5f),
 		g_cfg.getFloat("OverlayTraffic","urgent_gap_seconds",1.2f),
 		g_cfg.getFloat("OverlayTraffic","hold_seconds",1.25f),
 		g_cfg.getFloat("OverlayTraffic","faster_class_laptime_margin_s",1.0f),
+		g_cfg.getFloat("OverlayTraffic","warn_catch_seconds",8.0f),
+		g_cfg.getFloat("OverlayTraffic","urgent_catch_seconds",3.0f),
 		escapeJson(g_cfg.getString("OverlayTraffic","font","Poppins")).c_str(),
 		g_cfg.getFloat("OverlayTraffic","font_size", 16.0f),
 		g_cfg.getFloat("OverlayTraffic","font_spacing", 0.30f),
@@ -59,6 +59,12 @@ std::string app_get_state_json();
 bool app_is_startup_enabled();
 void app_set_startup_enabled(bool on);
 
+// Write the profiler's current rolling percentiles to profile.csv next to the exe
+bool app_export_profile_csv();
+
+// Write the last General.trace_seconds of traced events to trace.json (Chrome trace format)
+bool app_dump_trace();
+
 // Overlay movement functions
 void app_move_overlay(const char* sectionKey, int deltaX, int deltaY);
 void app_center_overlay(const char* sectionKey);
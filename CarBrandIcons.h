@@ -0,0 +1,464 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Car brand icons, decoded on demand.
+// Only the file names under assets/carIcons are enumerated at startup. A brand's PNG is decoded on a
+// background thread the first time a car of that brand shows up, and copied into one shared CPU-side
+// atlas. Decoded icons are persisted to a small cache file (raw premultiplied BGRA, stamped with the
+// source file's size and write time), so later starts only hit WIC for icons that changed or were never
+// seen before.
+// The atlas is mirrored into one D2D bitmap per D2D device, shared by every overlay on that device like
+// ImageAssets. Drawing never waits on a decode: a brand whose icon isn't in the atlas yet is skipped.
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <stdint.h>
+#include <d2d1_3.h>
+#include <wincodec.h>
+#include <wrl.h>
+#include "util.h"
+#include "Tracer.h"
+#include "ImageAssets.h"
+
+class CarBrandIcons
+{
+    public:
+
+        static constexpr int    CellSize   = 72;            // icons are normalized to this size
+        static constexpr int    CellStride = CellSize + 2;  // 1px transparent gutter against filtering bleed
+        static constexpr int    Columns    = 8;
+
+        static CarBrandIcons& instance()
+        {
+            static CarBrandIcons s_instance;
+            return s_instance;
+        }
+
+        // Enumerates available brands and reads the cache file. Does not decode anything.
+        // Call once at startup, before any brandForCar().
+        bool init()
+        {
+            m_brands.clear();
+            m_carToBrand.clear();
+            m_atlas.clear();
+            m_bitmaps.clear();
+            m_rows = 0;
+            m_slotsUsed = 0;
+            m_revision++;
+
+            m_dir = resolveAssetPathW(L"assets\\carIcons\\");
+            WIN32_FIND_DATAW fd = {};
+            HANDLE h = FindFirstFileW((m_dir + L"*.png").c_str(), &fd);
+            if (h == INVALID_HANDLE_VALUE)
+                return false;
+            do {
+                if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                    continue;
+
+                // Key name = filename without extension (lowercased)
+                std::wstring fnameW(fd.cFileName);
+                const size_t dot = fnameW.find_last_of(L'.');
+                if (dot != std::wstring::npos) fnameW = fnameW.substr(0, dot);
+
+                Brand b;
+                b.file = fd.cFileName;
+                b.key.reserve(fnameW.size());
+                for (wchar_t c : fnameW) b.key.push_back((char)tolower((unsigned short)c));
+                b.stamp = ((uint64_t)fd.ftLastWriteTime.dwHighDateTime << 32 | fd.ftLastWriteTime.dwLowDateTime) ^ fd.nFileSizeLow;
+                m_brands.push_back(std::move(b));
+            } while (FindNextFileW(h, &fd));
+            FindClose(h);
+
+            loadCacheFile();
+            return !m_brands.empty();
+        }
+
+        // Stops the decode thread and writes the cache file if anything new was decoded this run.
+        void shutdown()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+                m_queue.clear();
+            }
+            m_cv.notify_all();
+            if (m_worker.joinable())
+                m_worker.join();
+
+            if (m_cacheDirty)
+                saveCacheFile();
+            m_cacheDirty = false;
+            releaseDeviceResources();
+        }
+
+        // Drop the GPU copies of the atlas, e.g. when the shared D2D device goes away.
+        void releaseDeviceResources()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bitmaps.clear();
+        }
+
+        // Drop a copy keyed on the render target itself (see ImageAssets::forgetTarget).
+        void forgetTarget(ID2D1RenderTarget* rt)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::erase_if(m_bitmaps, [rt](const DeviceBitmap& d){ return d.device == rt; });
+        }
+
+        bool available() const { return !m_brands.empty(); }
+
+        // Brand index for this car (queueing its icon for decoding on first use), or -1 if there is none.
+        // Main thread only.
+        int brandForCar(const std::string& carName)
+        {
+            auto it = m_carToBrand.find(carName);
+            if (it == m_carToBrand.end())
+                it = m_carToBrand.emplace(carName, matchBrand(carName)).first;
+            if (it->second < 0)
+                return -1;
+
+            Brand& b = m_brands[it->second];
+            if (!b.queued)
+            {
+                b.queued = true;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_stop)
+                        return it->second;
+                    m_queue.push_back(it->second);
+                    if (!m_worker.joinable())
+                        m_worker = std::thread(&CarBrandIcons::workerMain, this);
+                }
+                m_cv.notify_one();
+            }
+            return it->second;
+        }
+
+        // Draws a brand's icon into 'dest'. Does nothing until the icon has been decoded.
+        void draw(ID2D1RenderTarget* rt, int brand, const D2D1_RECT_F& dest)
+        {
+            if (!rt || brand < 0 || brand >= (int)m_brands.size())
+                return;
+
+            int slot = -1;
+            ID2D1Bitmap* bmp = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                slot = m_brands[brand].slot;
+                if (slot >= 0)
+                    bmp = syncBitmap(rt);
+            }
+            if (!bmp)
+                return;
+            const D2D1_RECT_F src = slotRect(slot);
+            rt->DrawBitmap(bmp, dest, 1.0f, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR, &src);
+        }
+
+        static D2D1_RECT_F slotRect(int slot)
+        {
+            const float x = (float)((slot % Columns) * CellStride + 1);
+            const float y = (float)((slot / Columns) * CellStride + 1);
+            return D2D1::RectF(x, y, x + CellSize, y + CellSize);
+        }
+
+    private:
+
+        struct Brand
+        {
+            std::string     key;
+            std::wstring    file;
+            uint64_t        stamp = 0;
+            bool            queued = false;     // main thread only
+            int             slot = -1;          // guarded by m_mutex
+        };
+
+        struct CachedIcon
+        {
+            uint64_t                stamp = 0;
+            std::vector<uint32_t>   pixels;     // CellSize x CellSize
+        };
+
+        // GPU copy of the atlas for one D2D device
+        struct DeviceBitmap
+        {
+            const void*                         device = nullptr;  // ImageAssets::deviceKey()
+            Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+            unsigned                            revision = 0;
+        };
+
+        CarBrandIcons() = default;
+        ~CarBrandIcons() { shutdown(); }
+        CarBrandIcons(const CarBrandIcons&) = delete;
+        CarBrandIcons& operator=(const CarBrandIcons&) = delete;
+
+        int atlasWidth() const { return Columns * CellStride; }
+        int atlasHeight() const { return m_rows * CellStride; }
+
+        // Longest brand key contained in the car name; "00error" is the fallback icon.
+        int matchBrand(const std::string& carName) const
+        {
+            std::string name = carName;
+            for (char& c : name) c = (char)tolower((unsigned char)c);
+
+            int best = -1;
+            size_t bestLen = 0;
+            for (int i = 0; i < (int)m_brands.size(); ++i)
+            {
+                const std::string& key = m_brands[i].key;
+                if (key == "00error") { if (best < 0) best = i; continue; }
+                // Allow underscore or space equivalence
+                std::string k = key;
+                for (char& c : k) if (c == '_') c = ' ';
+                if (name.find(k) != std::string::npos && k.length() > bestLen)
+                {
+                    best = i;
+                    bestLen = k.length();
+                }
+            }
+            return best;
+        }
+
+        // Atlas bitmap for rt's device, created or refreshed from the CPU atlas as needed. m_mutex held.
+        ID2D1Bitmap* syncBitmap(ID2D1RenderTarget* rt)
+        {
+            const void* deviceKey = ImageAssets::instance().deviceKey(rt);
+            DeviceBitmap* db = nullptr;
+            for (DeviceBitmap& d : m_bitmaps)
+                if (d.device == deviceKey)
+                    db = &d;
+            if (!db)
+            {
+                m_bitmaps.push_back(DeviceBitmap{ deviceKey });
+                db = &m_bitmaps.back();
+            }
+
+            const D2D1_SIZE_U size = D2D1::SizeU(atlasWidth(), atlasHeight());
+            if (!db->bitmap || db->bitmap->GetPixelSize().height != size.height)
+            {
+                db->bitmap.Reset();
+                const D2D1_BITMAP_PROPERTIES props = D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+                if (FAILED(rt->CreateBitmap(size, m_atlas.data(), size.width * sizeof(uint32_t), &props, &db->bitmap)))
+                    return nullptr;
+                db->revision = m_revision;
+            }
+            else if (db->revision != m_revision)
+            {
+                if (FAILED(db->bitmap->CopyFromMemory(nullptr, m_atlas.data(), size.width * sizeof(uint32_t))))
+                    return nullptr;
+                db->revision = m_revision;
+            }
+            return db->bitmap.Get();
+        }
+
+        void workerMain()
+        {
+            Tracer::setThreadName("car-brand-icons");
+            (void)CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+            Microsoft::WRL::ComPtr<IWICImagingFactory> wic;
+            (void)CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wic));
+
+            for (;;)
+            {
+                int index = -1;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cv.wait(lock, [this]{ return m_stop || !m_queue.empty(); });
+                    if (m_stop)
+                        break;
+                    index = m_queue.front();
+                    m_queue.pop_front();
+                }
+
+                std::vector<uint32_t> icon;
+                bool ok = false;
+                {
+                    TRACE_SCOPE("carbrand.decode");
+                    ok = loadIcon(wic.Get(), m_brands[index], icon);
+                }
+                if (ok)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    addToAtlas(m_brands[index], icon);
+                }
+            }
+
+            wic.Reset();
+            CoUninitialize();
+        }
+
+        // Icon pixels from the cache file, or decoded from the PNG. Decode thread only.
+        bool loadIcon(IWICImagingFactory* wic, const Brand& b, std::vector<uint32_t>& icon)
+        {
+            auto itCached = m_cache.find(b.key);
+            if (itCached != m_cache.end() && itCached->second.stamp == b.stamp && itCached->second.pixels.size() == CellSize*CellSize)
+            {
+                icon = itCached->second.pixels;
+                return true;
+            }
+
+            if (!wic || !decodePng(wic, m_dir + b.file, icon))
+                return false;
+            CachedIcon& c = m_cache[b.key];
+            c.stamp = b.stamp;
+            c.pixels = icon;
+            m_cacheDirty = true;
+            return true;
+        }
+
+        // m_mutex held.
+        void addToAtlas(Brand& b, const std::vector<uint32_t>& icon)
+        {
+            const int slot = m_slotsUsed++;
+            const int row = slot / Columns;
+            if (row >= m_rows)
+            {
+                m_rows = row + 1;
+                m_atlas.resize((size_t)atlasWidth() * atlasHeight(), 0);
+            }
+            const int x0 = (slot % Columns) * CellStride + 1;
+            const int y0 = row * CellStride + 1;
+            for (int y = 0; y < CellSize; ++y)
+                memcpy(&m_atlas[(size_t)(y0 + y) * atlasWidth() + x0], &icon[(size_t)y * CellSize], CellSize * sizeof(uint32_t));
+
+            b.slot = slot;
+            m_revision++;
+        }
+
+        static bool decodePng(IWICImagingFactory* wic, const std::wstring& path, std::vector<uint32_t>& out)
+        {
+            Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+            Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+            Microsoft::WRL::ComPtr<IWICBitmapScaler> scaler;
+            Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+            if (FAILED(wic->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder)))
+                return false;
+            if (FAILED(decoder->GetFrame(0, &frame)))
+                return false;
+
+            IWICBitmapSource* src = frame.Get();
+            UINT w = 0, h = 0;
+            frame->GetSize(&w, &h);
+            if (w != CellSize || h != CellSize)
+            {
+                if (FAILED(wic->CreateBitmapScaler(&scaler)) ||
+                    FAILED(scaler->Initialize(frame.Get(), CellSize, CellSize, WICBitmapInterpolationModeFant)))
+                    return false;
+                src = scaler.Get();
+            }
+
+            if (FAILED(wic->CreateFormatConverter(&converter)))
+                return false;
+            if (FAILED(converter->Initialize(src, GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut)))
+                return false;
+
+            out.assign(CellSize * CellSize, 0);
+            return SUCCEEDED(converter->CopyPixels(nullptr, CellSize * sizeof(uint32_t), (UINT)(out.size() * sizeof(uint32_t)), (BYTE*)out.data()));
+        }
+
+        // Cache file layout (little endian):
+        //   char magic[4] "IFBI", u32 version, u32 cellSize, u32 count
+        //   count x { u16 keyLen, char key[keyLen], u64 stamp, u32 pixels[cellSize*cellSize] }
+        static constexpr uint32_t CacheVersion = 1;
+        static constexpr const char* CacheFile = "carbrand-icons.cache";
+
+        void loadCacheFile()
+        {
+            m_cache.clear();
+            m_cacheDirty = false;
+
+            std::string data;
+            if (!loadFile(CacheFile, data))
+                return;
+
+            size_t pos = 0;
+            auto read = [&](void* dst, size_t n) -> bool {
+                if (pos + n > data.size()) return false;
+                memcpy(dst, data.data() + pos, n);
+                pos += n;
+                return true;
+            };
+
+            char magic[4] = {};
+            uint32_t version = 0, cellSize = 0, count = 0;
+            if (!read(magic, 4) || memcmp(magic, "IFBI", 4) != 0) return;
+            if (!read(&version, 4) || version != CacheVersion) return;
+            if (!read(&cellSize, 4) || cellSize != CellSize) return;
+            if (!read(&count, 4)) return;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint16_t keyLen = 0;
+                if (!read(&keyLen, 2)) break;
+                std::string key(keyLen, '\0');
+                CachedIcon c;
+                c.pixels.resize(CellSize * CellSize);
+                if (!read(key.data(), keyLen) || !read(&c.stamp, 8) || !read(c.pixels.data(), c.pixels.size() * sizeof(uint32_t)))
+                    break;
+                m_cache[key] = std::move(c);
+            }
+        }
+
+        void saveCacheFile() const
+        {
+            FILE* fp = fopen(CacheFile, "wb");
+            if (!fp)
+                return;
+
+            const uint32_t header[3] = { CacheVersion, (uint32_t)CellSize, (uint32_t)m_cache.size() };
+            fwrite("IFBI", 1, 4, fp);
+            fwrite(header, sizeof(header), 1, fp);
+            for (const auto& [key, c] : m_cache)
+            {
+                const uint16_t keyLen = (uint16_t)key.size();
+                fwrite(&keyLen, 2, 1, fp);
+                fwrite(key.data(), 1, keyLen, fp);
+                fwrite(&c.stamp, 8, 1, fp);
+                fwrite(c.pixels.data(), sizeof(uint32_t), c.pixels.size(), fp);
+            }
+            fclose(fp);
+        }
+
+        std::wstring                                m_dir;
+        std::vector<Brand>                          m_brands;       // fixed after init()
+        std::unordered_map<std::string, int>        m_carToBrand;   // car name -> brand index (-1: none), main thread only
+        std::unordered_map<std::string, CachedIcon> m_cache;        // brand key -> decoded pixels, decode thread only after init()
+        bool                                        m_cacheDirty = false;
+        std::vector<DeviceBitmap>                   m_bitmaps;      // guarded by m_mutex
+        std::vector<uint32_t>                       m_atlas;        // premultiplied BGRA, top-down; atlas state guarded by m_mutex
+        int                                         m_rows = 0;
+        int                                         m_slotsUsed = 0;
+        unsigned                                    m_revision = 0; // bumped whenever the atlas contents or size change
+        std::mutex                                  m_mutex;
+        std::condition_variable                     m_cv;
+        std::deque<int>                             m_queue;        // brand indices waiting for decode
+        std::thread                                 m_worker;
+        bool                                        m_stop = false;
+};
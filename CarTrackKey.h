@@ -0,0 +1,55 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Identifies data that belongs to one car on one track layout (fuel.db records, ghost laps).
+// The layout is a hash of the track config name so keys stay fixed-size on disk.
+
+#include <stdint.h>
+#include <string>
+#include "iracing.h"
+#include "util.h"
+
+struct CarTrackKey
+{
+    int         trackId = 0;
+    uint32_t    configHash = 0;
+    int         carId = 0;
+
+    bool operator==( const CarTrackKey& o ) const { return trackId==o.trackId && configHash==o.configHash && carId==o.carId; }
+    bool valid() const { return trackId > 0 && carId > 0; }
+
+    // Our own car on the current track. Car and track info can show up a few ticks after the session.
+    static CarTrackKey current()
+    {
+        CarTrackKey key;
+        key.trackId = ir_session.trackId;
+        if( ir_session.driverCarIdx >= 0 )
+            key.carId = ir_session.cars[ir_session.driverCarIdx].carID;
+        const std::string& cfg = ir_session.trackConfigName;
+        key.configHash = MurmurHash2( cfg.data(), (int)cfg.size(), 0x1F03 );
+        return key;
+    }
+};
@@ -0,0 +1,143 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+// How fast every car closes in on us (or we on it), from the relative gap sampled a few times per
+// second into a short fixed ring per car. The rate is the least-squares slope over the ring, so a
+// single noisy gap doesn't flip it. It is refit only when a new sample is taken, which keeps this
+// cheap enough to run for the whole field every tick.
+//
+// A car's ring starts over when it passes us (or we pass it), when either of us is on pit road, or
+// when the gap jumps (tows, resets, timing-loop hand-overs).
+
+#include <stdint.h>
+#include <math.h>
+#include "iracing.h"
+
+class ClosingRate
+{
+    public:
+
+        static constexpr int    Window = 16;                // samples per car, power of two
+        static constexpr float  SampleInterval = 0.25f;     // seconds -> 4s window
+        static constexpr int    MinSamples = 6;
+        static constexpr float  MaxJump = 1.5f;             // gap change between samples treated as a discontinuity
+
+        void reset()
+        {
+            m_nextSample = 0;
+            for( int i=0; i<IR_MAX_CARS; ++i )
+                resetCar( i );
+        }
+
+        // Arrays indexed by carIdx. relTime is positive for cars ahead, negative for cars behind.
+        void update( double sessionTime, const float* relTime, const float* lapDistPct, const bool* onPitRoad, int selfIdx )
+        {
+            if( sessionTime < m_nextSample - 1.0 )
+                reset();    // time went backwards (replay)
+            if( sessionTime < m_nextSample )
+                return;
+            m_nextSample = sessionTime + SampleInterval;
+
+            const bool selfInPits = selfIdx < 0 || onPitRoad[selfIdx];
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                if( i == selfIdx || selfInPits || lapDistPct[i] < 0 || onPitRoad[i] )
+                {
+                    resetCar( i );
+                    continue;
+                }
+
+                const float gap  = fabsf( relTime[i] );
+                const int8_t side = relTime[i] >= 0 ? 1 : -1;
+                if( m_count[i] && (side != m_side[i] || fabsf( gap - m_gap[i][(m_head[i]-1) & (Window-1)] ) > MaxJump) )
+                    resetCar( i );
+
+                if( !m_count[i] )
+                    m_t0[i] = sessionTime;
+                m_side[i] = side;
+                m_time[i][m_head[i]] = (float)(sessionTime - m_t0[i]);
+                m_gap[i][m_head[i]]  = gap;
+                m_head[i] = (m_head[i] + 1) & (Window-1);
+                if( m_count[i] < Window )
+                    m_count[i]++;
+
+                m_rate[i] = m_count[i] >= MinSamples ? -slope( i ) : 0;
+            }
+        }
+
+        // Seconds of gap lost per second (>0: the gap is shrinking). 0 until there are enough samples.
+        float   closingRate( int carIdx ) const { return m_rate[carIdx]; }
+        bool    hasRate( int carIdx ) const     { return m_count[carIdx] >= MinSamples; }
+
+        // Seconds until the gap to carIdx is gone at the current rate, -1 if it isn't closing
+        float timeToCatch( int carIdx, float gap ) const
+        {
+            const float r = m_rate[carIdx];
+            return r > 0.001f ? fabsf( gap ) / r : -1.0f;
+        }
+
+    private:
+
+        void resetCar( int i )
+        {
+            m_count[i] = 0;
+            m_head[i]  = 0;
+            m_rate[i]  = 0;
+            m_side[i]  = 0;
+        }
+
+        float slope( int i ) const
+        {
+            const int n = m_count[i];
+            float mt = 0, mg = 0;
+            for( int k=0; k<n; ++k )
+            {
+                const int s = (m_head[i] - 1 - k) & (Window-1);
+                mt += m_time[i][s];
+                mg += m_gap[i][s];
+            }
+            mt /= (float)n;
+            mg /= (float)n;
+
+            float stg = 0, stt = 0;
+            for( int k=0; k<n; ++k )
+            {
+                const int   s  = (m_head[i] - 1 - k) & (Window-1);
+                const float dt = m_time[i][s] - mt;
+                stg += dt * (m_gap[i][s] - mg);
+                stt += dt * dt;
+            }
+            return stt > 0 ? stg / stt : 0;
+        }
+
+        double  m_nextSample = 0;
+        double  m_t0[IR_MAX_CARS] = {};                 // sample times are stored relative to this
+        float   m_time[IR_MAX_CARS][Window] = {};
+        float   m_gap[IR_MAX_CARS][Window] = {};        // |relTime|
+        float   m_rate[IR_MAX_CARS] = {};
+        int     m_head[IR_MAX_CARS] = {};
+        int     m_count[IR_MAX_CARS] = {};
+        int8_t  m_side[IR_MAX_CARS] = {};
+};
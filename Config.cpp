@@ -28,6 +28,7 @@ SOFTWARE.
 #include <algorithm>
 #include "Config.h"
 #include "Logger.h"
+#include "Tracer.h"
 
 Config              g_cfg;
 
@@ -55,6 +56,7 @@ static void configWatcher( std::atomic<bool>* m_hasChanged )
 
 bool Config::load()
 {
+    TRACE_SCOPE( "Config::load" );
     std::string json;
     if( !loadFile(m_filename, json) )
     {
@@ -73,6 +75,7 @@ bool Config::load()
 
     m_pj = pjval.get<picojson::object>();
     m_hasChanged = false;
+    m_generation++;
     return true;
 }
 
@@ -202,6 +205,7 @@ void Config::setStringVec( const std::string& component, const std::string& key,
         arr.push_back(val);
     }
     pjcomp[key].set<picojson::array>(arr);
+    m_generation++;
 }
 
 void Config::setInt( const std::string& component, const std::string& key, int v )
@@ -209,24 +213,43 @@ void Config::setInt( const std::string& component, const std::string& key, int v
     picojson::object& pjcomp = getOrInsertComponent( component );
     double d = double(v);
     pjcomp[key].set<double>( d );
+    m_generation++;
 }
 
 void Config::setBool( const std::string& component, const std::string& key, bool v )
 {
     picojson::object& pjcomp = getOrInsertComponent( component );
     pjcomp[key].set<bool>( v );
+    m_generation++;
 }
 
 void Config::setString( const std::string& component, const std::string& key, const std::string& v )
 {
     picojson::object& pjcomp = getOrInsertComponent( component );
     pjcomp[key].set<std::string>( v );
+    m_generation++;
 }
 
 void Config::setFloat( const std::string& component, const std::string& key, float v )
 {
     picojson::object& pjcomp = getOrInsertComponent( component );
     pjcomp[key].set<double>( static_cast<double>(v) );
+    m_generation++;
+}
+
+unsigned Config::hashValue( const std::string& component, const std::string& key ) const
+{
+    auto itComp = m_pj.find( component );
+    if( itComp == m_pj.end() || !itComp->second.is<picojson::object>() )
+        return 0;
+
+    const picojson::object& comp = itComp->second.get<picojson::object>();
+    auto it = comp.find( key );
+    if( it == comp.end() )
+        return 0;
+
+    const std::string s = it->second.serialize();
+    return MurmurHash2( s.data(), (int)s.length(), 0x5eed );
 }
 
 picojson::object& Config::getOrInsertComponent( const std::string& component, bool* existed )
@@ -297,6 +320,7 @@ bool Config::loadCarConfig( const std::string& carName )
     m_filename = carFilename;
     m_currentCarName = carName;
     m_hasChanged = false;
+    m_generation++;
     return true;
 }
 
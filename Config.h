@@ -51,6 +51,11 @@ class Config
         void                        watchForChanges();
         bool                        hasChanged();
 
+        // Bumped on every load/set, so callers can cheaply tell whether any value may have changed.
+        unsigned                    getGeneration() const { return m_generation; }
+        // Hash of the serialized value (0 if the key doesn't exist). Does not insert defaults.
+        unsigned                    hashValue( const std::string& component, const std::string& key ) const;
+
         bool                        getBool( const std::string& component, const std::string& key, bool defaultVal );
         int                         getInt( const std::string& component, const std::string& key, int defaultVal );
         float                       getFloat( const std::string& component, const std::string& key, float defaultVal );
@@ -73,6 +78,7 @@ class Config
 
         picojson::object    m_pj;
         std::atomic<bool>   m_hasChanged = false;
+        unsigned            m_generation = 0;
         std::thread         m_configWatchThread;
         std::string         m_filename = "config.json";
         std::string         m_currentCarName;
@@ -0,0 +1,199 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Own-car lap delta, independent of iRacing's LapDeltaTo* channels. Every sim tick the player's
+// (LapDistPct, SessionTime) sample is folded into the lap being driven, resampled onto a fixed
+// distance grid: bin i holds the elapsed lap time at distance i/GridSize. A completed clean lap
+// becomes the "last" reference and, if quicker, the session best; the user can pin any last lap
+// as a third reference. Comparing against a reference is a single lerp between two bins.
+//
+// Laps that touch pit road, jump or run backwards along the track (resets, tows, replay seeks) or
+// weren't started at the line are never used as references.
+
+#include <math.h>
+#include <string.h>
+
+class DeltaEngine
+{
+    public:
+
+        enum class Ref { LAST, SESSION_BEST, PINNED };
+
+        static constexpr int GridSize = 2048;
+
+        // New session: the last and best laps no longer apply. A pinned lap is the user's and is kept.
+        void reset()
+        {
+            m_cur.valid = m_last.valid = m_best.valid = false;
+            m_recording = false;
+            m_prevPct   = -1;
+            m_prevTime  = 0;
+        }
+
+        // Feed one sample of our own car. pct < 0 or !onTrack means we're not driving.
+        void update( float pct, double sessionTime, bool onTrack, bool onPitRoad )
+        {
+            if( !onTrack || pct < 0 || sessionTime < m_prevTime )
+            {
+                m_recording = false;
+                m_prevPct   = -1;
+                m_prevTime  = sessionTime;
+                return;
+            }
+            if( sessionTime == m_prevTime && m_prevPct >= 0 )
+                return;     // paused
+
+            const bool crossedLine = m_prevPct > 0.75f && pct < 0.25f;
+
+            if( crossedLine )
+            {
+                // Interpolate the moment we crossed the line
+                const float  before = 1.0f - m_prevPct;
+                const double tLine  = m_prevTime + (sessionTime - m_prevTime) * (before / (before + pct));
+
+                if( m_recording && m_cur.valid )
+                {
+                    fill( m_prevPct, m_prevTime, 1.0f, tLine );
+                    m_cur.time[GridSize] = (float)(tLine - m_lapStart);
+                    m_cur.lapTime        = m_cur.time[GridSize];
+                    if( m_filled == GridSize )
+                    {
+                        m_last = m_cur;
+                        if( !m_best.valid || m_cur.lapTime < m_best.lapTime )
+                            m_best = m_cur;
+                    }
+                }
+
+                m_recording = true;
+                m_lapStart  = tLine;
+                m_cur.valid = !onPitRoad;
+                m_cur.time[0] = 0;
+                m_filled    = 0;
+                fill( 0.0f, tLine, pct, sessionTime );
+            }
+            else if( m_recording )
+            {
+                const float step = pct - m_prevPct;
+                if( step < -0.01f || step > 0.1f )
+                    m_recording = false;        // reset, tow or seek
+                else
+                {
+                    if( onPitRoad )
+                        m_cur.valid = false;
+                    fill( m_prevPct, m_prevTime, pct, sessionTime );
+                }
+            }
+
+            m_prevPct  = pct;
+            m_prevTime = sessionTime;
+        }
+
+        void pinLastLap()
+        {
+            if( m_last.valid )
+                m_pinned = m_last;
+        }
+
+        bool  hasRef( Ref ref ) const       { return lap(ref).valid; }
+        float refLapTime( Ref ref ) const   { return lap(ref).valid ? lap(ref).lapTime : 0.0f; }
+
+        // Seconds gained (-) or lost (+) on the lap in progress against the reference, at our current position
+        bool delta( Ref ref, float& out ) const
+        {
+            const Lap& r = lap( ref );
+            if( !m_recording || !r.valid || m_prevPct < 0 )
+                return false;
+            out = (float)(m_prevTime - m_lapStart) - r.at( m_prevPct );
+            return true;
+        }
+
+        // Time our best available reference lap needs to get from one track position to another
+        // (wrapping across the line). Usable as a gap estimate to any car on track, e.g. the one ahead.
+        bool timeBetween( float fromPct, float toPct, float& out ) const
+        {
+            const Lap& r = m_best.valid ? m_best : m_last;
+            if( !r.valid || fromPct < 0 || toPct < 0 )
+                return false;
+            out = r.at( toPct ) - r.at( fromPct );
+            if( out < 0 )
+                out += r.lapTime;
+            return true;
+        }
+
+    private:
+
+        struct Lap
+        {
+            bool    valid = false;
+            float   lapTime = 0;
+            float   time[GridSize+1];   // elapsed lap time at distance i/GridSize
+
+            float at( float pct ) const
+            {
+                const float x = fminf( fmaxf( pct, 0.0f ), 1.0f ) * GridSize;
+                const int   i = (int)x >= GridSize ? GridSize - 1 : (int)x;
+                const float f = x - (float)i;
+                return time[i] + (time[i+1] - time[i]) * f;
+            }
+        };
+
+        const Lap& lap( Ref ref ) const
+        {
+            switch( ref )
+            {
+                case Ref::LAST:         return m_last;
+                case Ref::PINNED:       return m_pinned;
+                default:                return m_best;
+            }
+        }
+
+        // Resample the segment between two samples onto every grid bin it passes
+        void fill( float pct0, double t0, float pct1, double t1 )
+        {
+            const int end = pct1 >= 1.0f ? GridSize : (int)(pct1 * GridSize);
+            if( end <= m_filled || pct1 <= pct0 )
+                return;
+            const double rel0 = t0 - m_lapStart;
+            const double rel1 = t1 - m_lapStart;
+            for( int i=m_filled+1; i<=end; ++i )
+            {
+                const float pct = (float)i / GridSize;
+                const float f   = (pct - pct0) / (pct1 - pct0);
+                m_cur.time[i] = (float)(rel0 + (rel1 - rel0) * f);
+            }
+            m_filled = end;
+        }
+
+        Lap     m_cur;
+        Lap     m_last;
+        Lap     m_best;
+        Lap     m_pinned;
+        int     m_filled = 0;           // highest grid bin written for m_cur
+        bool    m_recording = false;    // m_cur started at the line and is still continuous
+        double  m_lapStart = 0;
+        float   m_prevPct = -1;
+        double  m_prevTime = 0;
+};
@@ -0,0 +1,202 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Recorded draw commands.
+// Overlays that opt in emit into a DisplayList instead of talking to Direct2D, and Overlay replays
+// it through DisplayListD2D. Recording lets a frame be compared with the previous one so unchanged
+// frames skip the GPU submit. Nothing in here depends on Windows headers.
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct DlColor
+{
+    float r = 0, g = 0, b = 0, a = 0;
+    DlColor() = default;
+    DlColor( float _r, float _g, float _b, float _a ) : r(_r), g(_g), b(_b), a(_a) {}
+};
+
+struct DlRect
+{
+    float left = 0, top = 0, right = 0, bottom = 0;
+    DlRect() = default;
+    DlRect( float l, float t, float r, float b ) : left(l), top(t), right(r), bottom(b) {}
+    float width() const { return right - left; }
+    float height() const { return bottom - top; }
+};
+
+enum class DlAlign : uint8_t
+{
+    Leading = 0,
+    Trailing,
+    Center
+};
+
+enum class DlOp : uint8_t
+{
+    Clear = 0,
+    FillRect,
+    FillRoundedRect,
+    DrawRoundedRect,
+    Line,
+    Text,
+    Bitmap
+};
+
+// Fixed-size command record. Text payloads live in the list's string pool so records stay POD
+// and two lists can be compared with a plain memcmp.
+struct DlCommand
+{
+    DlOp        op = DlOp::Clear;
+    DlAlign     align = DlAlign::Leading;
+    uint16_t    resource = 0;       // font id (Text) or bitmap id (Bitmap); ids are backend-defined
+    DlRect      rect;               // Line: (x0,y0,x1,y1). Text: (xmin,ycenter,xmax,-)
+    DlColor     color;              // Bitmap: color.a is the opacity
+    float       radius = 0;         // rounded rects
+    float       width = 0;          // stroke width, or character spacing for Text
+    uint32_t    textOffset = 0;
+    uint32_t    textLength = 0;
+};
+// No padding bytes allowed, otherwise sameAs() would compare garbage
+static_assert( sizeof(DlCommand) == 4 + sizeof(DlRect) + sizeof(DlColor) + 2*sizeof(float) + 2*sizeof(uint32_t), "DlCommand must be tightly packed" );
+
+class DisplayList
+{
+    public:
+
+        void clear()
+        {
+            m_cmds.clear();
+            m_text.clear();
+        }
+
+        void clearTarget( const DlColor& c )
+        {
+            DlCommand& cmd = push( DlOp::Clear );
+            cmd.color = c;
+        }
+
+        void fillRect( const DlRect& r, const DlColor& c )
+        {
+            DlCommand& cmd = push( DlOp::FillRect );
+            cmd.rect = r;
+            cmd.color = c;
+        }
+
+        void fillRoundedRect( const DlRect& r, float radius, const DlColor& c )
+        {
+            DlCommand& cmd = push( DlOp::FillRoundedRect );
+            cmd.rect = r;
+            cmd.radius = radius;
+            cmd.color = c;
+        }
+
+        void drawRoundedRect( const DlRect& r, float radius, const DlColor& c, float strokeWidth )
+        {
+            DlCommand& cmd = push( DlOp::DrawRoundedRect );
+            cmd.rect = r;
+            cmd.radius = radius;
+            cmd.color = c;
+            cmd.width = strokeWidth;
+        }
+
+        void line( float x0, float y0, float x1, float y1, const DlColor& c, float strokeWidth )
+        {
+            DlCommand& cmd = push( DlOp::Line );
+            cmd.rect = DlRect( x0, y0, x1, y1 );
+            cmd.color = c;
+            cmd.width = strokeWidth;
+        }
+
+        // Single-line text, vertically centered on ycenter (same contract as TextCache::render).
+        void text( const wchar_t* str, uint16_t fontId, float xmin, float xmax, float ycenter, const DlColor& c, DlAlign align, float characterSpacing = 0.0f )
+        {
+            if( !str || !*str )
+                return;
+
+            DlCommand& cmd = push( DlOp::Text );
+            cmd.resource = fontId;
+            cmd.rect = DlRect( xmin, ycenter, xmax, 0 );
+            cmd.color = c;
+            cmd.align = align;
+            cmd.width = characterSpacing;
+            cmd.textOffset = (uint32_t)m_text.size();
+            cmd.textLength = (uint32_t)wcslen( str );
+            m_text.append( str, cmd.textLength );
+        }
+
+        void bitmap( uint16_t bitmapId, const DlRect& dest, float opacity = 1.0f )
+        {
+            DlCommand& cmd = push( DlOp::Bitmap );
+            cmd.resource = bitmapId;
+            cmd.rect = dest;
+            cmd.color = DlColor( 1, 1, 1, opacity );
+        }
+
+        const std::vector<DlCommand>&   commands() const { return m_cmds; }
+        size_t                          size() const { return m_cmds.size(); }
+        bool                            empty() const { return m_cmds.empty(); }
+
+        // Text for a Text command. Not null-terminated; use cmd.textLength.
+        const wchar_t* textOf( const DlCommand& cmd ) const { return m_text.data() + cmd.textOffset; }
+
+        // True if replaying 'o' would produce exactly the same frame.
+        bool sameAs( const DisplayList& o ) const
+        {
+            if( m_cmds.size() != o.m_cmds.size() || m_text != o.m_text )
+                return false;
+            return m_cmds.empty() || memcmp( m_cmds.data(), o.m_cmds.data(), m_cmds.size()*sizeof(DlCommand) ) == 0;
+        }
+
+        void swap( DisplayList& o )
+        {
+            m_cmds.swap( o.m_cmds );
+            m_text.swap( o.m_text );
+        }
+
+    private:
+
+        DlCommand& push( DlOp op )
+        {
+            m_cmds.emplace_back();
+            DlCommand& cmd = m_cmds.back();
+            cmd.op = op;
+            return cmd;
+        }
+
+        std::vector<DlCommand>  m_cmds;
+        std::wstring            m_text;
+};
+
+class DisplayListBackend
+{
+    public:
+
+        virtual         ~DisplayListBackend() {}
+        virtual void    replay( const DisplayList& dl ) = 0;
+};
@@ -0,0 +1,165 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Direct2D replay of a DisplayList. Fonts and bitmaps are referenced from the list by small
+// integer ids; the owning overlay binds the actual DWrite/D2D objects to those ids.
+
+#include <vector>
+#include <d2d1_3.h>
+#include <dwrite.h>
+#include <wrl.h>
+#include "DisplayList.h"
+#include "util.h"
+
+inline DlColor toDlColor( const float4& c ) { return DlColor( c.r, c.g, c.b, c.a ); }
+
+class DisplayListD2D : public DisplayListBackend
+{
+    public:
+
+        // Needs to be called whenever the render target or DWrite factory is (re-)created.
+        void setTarget( ID2D1RenderTarget* renderTarget, IDWriteFactory* factory )
+        {
+            m_renderTarget = renderTarget;
+            m_brush.Reset();
+            if( m_renderTarget )
+                HRCHECK(m_renderTarget->CreateSolidColorBrush( float4(0,0,0,1), &m_brush ));
+            if( factory != m_factory )
+            {
+                m_factory = factory;
+                m_text.reset( factory );
+            }
+        }
+
+        void setFont( uint16_t id, IDWriteTextFormat* textFormat )
+        {
+            if( id >= m_fonts.size() )
+                m_fonts.resize( id+1 );
+            m_fonts[id] = textFormat;
+
+            // Layouts are keyed on the text format, so they're stale now
+            m_text.reset( m_factory );
+        }
+
+        void setBitmap( uint16_t id, ID2D1Bitmap* bitmap )
+        {
+            if( id >= m_bitmaps.size() )
+                m_bitmaps.resize( id+1 );
+            m_bitmaps[id] = bitmap;
+        }
+
+        void clearResources()
+        {
+            m_fonts.clear();
+            m_bitmaps.clear();
+            m_text.reset( m_factory );
+        }
+
+        // Caller is responsible for BeginDraw()/EndDraw().
+        virtual void replay( const DisplayList& dl )
+        {
+            if( !m_renderTarget || !m_brush )
+                return;
+
+            for( const DlCommand& cmd : dl.commands() )
+            {
+                const D2D1_RECT_F r = { cmd.rect.left, cmd.rect.top, cmd.rect.right, cmd.rect.bottom };
+                const float4 col( cmd.color.r, cmd.color.g, cmd.color.b, cmd.color.a );
+
+                switch( cmd.op )
+                {
+                    case DlOp::Clear:
+                        m_renderTarget->Clear( col );
+                        break;
+
+                    case DlOp::FillRect:
+                        m_brush->SetColor( col );
+                        m_renderTarget->FillRectangle( &r, m_brush.Get() );
+                        break;
+
+                    case DlOp::FillRoundedRect:
+                    {
+                        const D2D1_ROUNDED_RECT rr = { r, cmd.radius, cmd.radius };
+                        m_brush->SetColor( col );
+                        m_renderTarget->FillRoundedRectangle( &rr, m_brush.Get() );
+                        break;
+                    }
+
+                    case DlOp::DrawRoundedRect:
+                    {
+                        const D2D1_ROUNDED_RECT rr = { r, cmd.radius, cmd.radius };
+                        m_brush->SetColor( col );
+                        m_renderTarget->DrawRoundedRectangle( &rr, m_brush.Get(), cmd.width );
+                        break;
+                    }
+
+                    case DlOp::Line:
+                        m_brush->SetColor( col );
+                        m_renderTarget->DrawLine( float2(r.left,r.top), float2(r.right,r.bottom), m_brush.Get(), cmd.width );
+                        break;
+
+                    case DlOp::Text:
+                    {
+                        IDWriteTextFormat* fmt = cmd.resource < m_fonts.size() ? m_fonts[cmd.resource] : nullptr;
+                        if( !fmt )
+                            break;
+                        m_textBuf.assign( dl.textOf(cmd), cmd.textLength );
+                        m_brush->SetColor( col );
+                        m_text.render( m_renderTarget, m_textBuf.c_str(), fmt, cmd.rect.left, cmd.rect.right, cmd.rect.top, m_brush.Get(), toDWriteAlign(cmd.align), cmd.width );
+                        break;
+                    }
+
+                    case DlOp::Bitmap:
+                    {
+                        ID2D1Bitmap* bmp = cmd.resource < m_bitmaps.size() ? m_bitmaps[cmd.resource] : nullptr;
+                        if( bmp )
+                            m_renderTarget->DrawBitmap( bmp, &r, cmd.color.a );
+                        break;
+                    }
+                }
+            }
+        }
+
+    private:
+
+        static DWRITE_TEXT_ALIGNMENT toDWriteAlign( DlAlign a )
+        {
+            switch( a )
+            {
+                case DlAlign::Trailing: return DWRITE_TEXT_ALIGNMENT_TRAILING;
+                case DlAlign::Center:   return DWRITE_TEXT_ALIGNMENT_CENTER;
+                default:                return DWRITE_TEXT_ALIGNMENT_LEADING;
+            }
+        }
+
+        ID2D1RenderTarget*                                  m_renderTarget = nullptr;
+        IDWriteFactory*                                     m_factory = nullptr;
+        Microsoft::WRL::ComPtr<ID2D1SolidColorBrush>        m_brush;
+        std::vector<IDWriteTextFormat*>                     m_fonts;
+        std::vector<ID2D1Bitmap*>                           m_bitmaps;
+        TextCache                                           m_text;
+        std::wstring                                        m_textBuf;      // NUL-terminated copy of a text op, reused across frames
+};
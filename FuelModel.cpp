@@ -0,0 +1,466 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "FuelModel.h"
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "iracing.h"
+#include "Config.h"
+#include "Logger.h"
+#include "util.h"
+
+FuelModel ir_fuel;
+
+// fuel.db layout (little endian):
+//   char magic[4] "IFFU", u32 version
+//   followed by Record structs until EOF, in the order the laps were driven.
+// Records are appended as laps are driven. A torn record at the end (crash mid-write) is ignored on
+// load and overwritten by the next append. Loads rewrite the file without the records beyond the
+// newest MaxGreenLaps laps and MaxGreenLaps green laps of every key, once that drops a fair number.
+static constexpr uint32_t   DbVersion = 1;
+static constexpr const char* DbFile = "fuel.db";
+static constexpr long       DbHeaderSize = 8;
+
+void FuelModel::update()
+{
+    if( m_loading )
+        finishLoad();
+
+    if( !ir_hasValidDriver() )
+        return;
+
+    const int subsessionId = ir_session.subsessionId;
+    const int sessionNum   = ir_SessionNum.getInt();
+    if( subsessionId != m_subsessionId || sessionNum != m_sessionNum )
+    {
+        m_subsessionId = subsessionId;
+        m_sessionNum   = sessionNum;
+        onSessionChanged();
+    }
+    else if( !m_key.valid() )
+    {
+        refreshKey();   // car/track info can show up a few ticks after the session does
+    }
+
+    const int    carIdx    = ir_session.driverCarIdx;
+    const int    lap       = ir_isPreStart() ? 0 : std::max( 0, ir_CarIdxLap.getInt(carIdx) );
+    const float  fuel      = ir_FuelLevel.getFloat();
+    const bool   onPitRoad = ir_CarIdxOnPitRoad.getBool( carIdx );
+    const double now       = ir_SessionTime.getDouble();
+
+    if( lap != m_prevLap )
+    {
+        // Resets and tows make the lap counter jump or refill the tank; those laps say nothing.
+        const float used = m_lapStartFuel - fuel;
+        if( m_lapValid && lap == m_prevLap+1 && used > 0 )
+        {
+            Lap l;
+            l.used    = used;
+            l.lapTime = (float)(now - m_lapStartTime);
+            l.flags   = m_curFlags;
+            addLap( l );
+        }
+        // Only a crossing from the previous lap starts a lap at the line. The first lap we see after
+        // startup or a session change was joined somewhere along the track.
+        m_lapValid     = m_prevLap >= 0 && lap == m_prevLap+1;
+        m_prevLap      = lap;
+        m_lapStartFuel = fuel;
+        m_lapStartTime = now;
+        m_curFlags     = 0;
+    }
+
+    // Anything but green taints the whole lap (oneLapToGreen only counts outside of test drives)
+    const int notGreen = (((int)ir_session.sessionType != 0) ? irsdk_oneLapToGreen : 0) | irsdk_yellow | irsdk_yellowWaving | irsdk_red | irsdk_checkered | irsdk_crossed | irsdk_caution | irsdk_cautionWaving | irsdk_disqualify | irsdk_repair;
+    if( ir_SessionFlags.getInt() & notGreen )
+        m_curFlags |= FuelCaution;
+    if( onPitRoad )
+        m_curFlags |= FuelPit;
+    if( !ir_IsOnTrack.getBool() )
+        m_lapValid = false;
+
+    // Pit history: record pit-road entry and start a new stint
+    if( onPitRoad && !m_prevOnPitRoad )
+    {
+        PitEntry e;
+        e.pitLap    = lap;
+        e.greenLaps = m_greenSincePit;
+        m_pitHistory.push_back( e );
+        while( (int)m_pitHistory.size() > MaxPitHistory )
+            m_pitHistory.pop_front();
+
+        m_greenSincePit = 0;
+        m_stintMax = 0;
+    }
+    m_prevOnPitRoad = onPitRoad;
+}
+
+void FuelModel::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_quit = true;
+    }
+    m_cv.notify_one();
+    if( m_thread.joinable() )
+        m_thread.join();
+}
+
+float FuelModel::average( int n ) const
+{
+    const int cnt = std::min( n, (int)m_green.size() );
+    if( cnt <= 0 )
+        return 0;
+    float sum = 0;
+    for( int i=(int)m_green.size()-cnt; i<(int)m_green.size(); ++i )
+        sum += m_green[i].used;
+    return sum / (float)cnt;
+}
+
+float FuelModel::recentMax( int n ) const
+{
+    const int cnt = std::min( n, (int)m_green.size() );
+    float mx = 0;
+    for( int i=(int)m_green.size()-cnt; i<(int)m_green.size(); ++i )
+        mx = std::max( mx, m_green[i].used );
+    return mx;
+}
+
+float FuelModel::percentile( float p ) const
+{
+    if( m_sorted.empty() )
+        return 0;
+    const float x  = std::clamp( p, 0.0f, 1.0f ) * (float)(m_sorted.size()-1);
+    const int   i0 = (int)x;
+    const int   i1 = std::min( i0+1, (int)m_sorted.size()-1 );
+    return m_sorted[i0] + (m_sorted[i1]-m_sorted[i0]) * (x-(float)i0);
+}
+
+float FuelModel::trend( int n ) const
+{
+    const int cnt = std::min( n, (int)m_green.size() );
+    if( cnt < 3 )
+        return 0;
+
+    // Slope of used vs. lap index, with x centered so the sums stay small
+    const int   first = (int)m_green.size() - cnt;
+    const float xMean = 0.5f * (float)(cnt-1);
+    float yMean = 0;
+    for( int i=0; i<cnt; ++i )
+        yMean += m_green[first+i].used;
+    yMean /= (float)cnt;
+
+    float sxy = 0, sxx = 0;
+    for( int i=0; i<cnt; ++i )
+    {
+        const float dx = (float)i - xMean;
+        sxy += dx * (m_green[first+i].used - yMean);
+        sxx += dx * dx;
+    }
+    return sxx > 0 ? sxy / sxx : 0;
+}
+
+void FuelModel::onSessionChanged()
+{
+    m_prevLap       = -1;
+    m_lapValid      = false;   // avoid confusing the lap accounting with session changes
+    m_curFlags      = 0;
+    m_lapStartFuel  = ir_FuelLevel.getFloat();
+    m_lapStartTime  = ir_SessionTime.getDouble();
+    m_prevOnPitRoad = false;
+    m_sessionMax    = 0;
+    m_stintMax      = 0;
+    m_greenSincePit = 0;
+    m_pitHistory.clear();
+
+    // Green laps carry over between sessions as long as car and track stay the same
+    refreshKey();
+}
+
+void FuelModel::refreshKey()
+{
+    const Key key = Key::current();
+    if( key == m_key )
+        return;
+
+    m_key = key;
+    m_green.clear();
+    m_sorted.clear();
+    m_bestGreenLapTime = 0;
+    m_legacyKey.clear();
+    if( !key.valid() )
+        return;
+
+    // Key of the old per-car+track average in config.json, only used to seed an empty database
+    std::string cfg = ir_session.trackConfigName;
+    for( char& c : cfg )
+    {
+        if( !( (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ) )
+            c = '_';
+    }
+    char buf[256];
+    _snprintf_s( buf, _countof(buf), _TRUNCATE, "t%d_%s_c%d", key.trackId, cfg.c_str(), key.carId );
+    m_legacyKey = buf;
+
+    startLoad();
+}
+
+void FuelModel::startLoad()
+{
+    // A load for a previous key that is still pending or running is superseded
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_pendingLoad    = m_key;
+        m_hasPendingLoad = true;
+        ++m_loadSeq;
+        if( !m_thread.joinable() )
+            m_thread = std::thread( &FuelModel::worker, this );
+    }
+    m_cv.notify_one();
+    m_loading = true;
+}
+
+void FuelModel::finishLoad()
+{
+    std::vector<Lap> loaded;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        if( m_loadedSeq != m_loadSeq )
+            return;
+        loaded.swap( m_loaded );
+    }
+    m_loading = false;
+
+    // Stored laps go in front of whatever we drove while loading
+    std::vector<Lap> recent;
+    recent.swap( m_green );
+    m_sorted.clear();
+    for( const Lap& l : loaded )
+        insertGreen( l );
+    for( const Lap& l : recent )
+        insertGreen( l );
+
+    if( m_green.empty() && !m_legacyKey.empty() )
+    {
+        const float cachedAvgPerLap = g_cfg.getFloat( "FuelCache", m_legacyKey, -1.0f );
+        if( cachedAvgPerLap > 0 )
+        {
+            Lap l;
+            l.used  = cachedAvgPerLap;
+            l.flags = FuelGreen;
+            insertGreen( l );
+        }
+    }
+}
+
+void FuelModel::addLap( Lap lap )
+{
+    if( !(lap.flags & (FuelCaution|FuelPit)) )
+    {
+        lap.flags |= FuelGreen;
+        if( lap.lapTime > 0 )
+        {
+            const float best = m_bestGreenLapTime > 0 ? std::min( m_bestGreenLapTime, lap.lapTime ) : lap.lapTime;
+            if( lap.lapTime <= best * 1.01f )
+                lap.flags |= FuelPush;
+        }
+    }
+
+    if( m_key.valid() )
+    {
+        Record r = {};
+        r.trackId    = m_key.trackId;
+        r.configHash = m_key.configHash;
+        r.carId      = m_key.carId;
+        r.used       = lap.used;
+        r.lapTime    = lap.lapTime;
+        r.flags      = lap.flags;
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_pendingRecs.push_back( r );
+            if( !m_thread.joinable() )
+                m_thread = std::thread( &FuelModel::worker, this );
+        }
+        m_cv.notify_one();
+    }
+
+    if( lap.flags & FuelGreen )
+    {
+        insertGreen( lap );
+        m_sessionMax = std::max( m_sessionMax, lap.used );
+        m_stintMax   = std::max( m_stintMax, lap.used );
+        m_greenSincePit++;
+    }
+}
+
+void FuelModel::insertGreen( const Lap& lap )
+{
+    if( m_green.size() >= MaxGreenLaps )
+    {
+        // Drop the oldest quarter in one go and rebuild the sorted copy
+        m_green.erase( m_green.begin(), m_green.begin() + MaxGreenLaps/4 );
+        m_sorted.clear();
+        for( const Lap& l : m_green )
+            m_sorted.push_back( l.used );
+        std::sort( m_sorted.begin(), m_sorted.end() );
+    }
+
+    m_green.push_back( lap );
+    m_sorted.insert( std::upper_bound( m_sorted.begin(), m_sorted.end(), lap.used ), lap.used );
+    if( lap.lapTime > 0 )
+        m_bestGreenLapTime = m_bestGreenLapTime > 0 ? std::min( m_bestGreenLapTime, lap.lapTime ) : lap.lapTime;
+}
+
+void FuelModel::appendToDb( const std::vector<Record>& recs )
+{
+    if( recs.empty() )
+        return;
+
+    FILE* fp = fopen( DbFile, "r+b" );
+    if( !fp )
+        fp = fopen( DbFile, "w+b" );
+    if( !fp )
+    {
+        Logger::instance().logError( std::string("Failed to open ") + DbFile );
+        return;
+    }
+
+    fseek( fp, 0, SEEK_END );
+    long size = ftell( fp );
+    if( size < DbHeaderSize )
+    {
+        fseek( fp, 0, SEEK_SET );
+        fwrite( "IFFU", 1, 4, fp );
+        fwrite( &DbVersion, 4, 1, fp );
+        size = DbHeaderSize;
+    }
+
+    // Skip past a torn record, if any
+    const long end = DbHeaderSize + (size - DbHeaderSize) / (long)sizeof(Record) * (long)sizeof(Record);
+    fseek( fp, end, SEEK_SET );
+    fwrite( recs.data(), sizeof(Record), recs.size(), fp );
+    fclose( fp );
+}
+
+void FuelModel::worker()
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    while( true )
+    {
+        m_cv.wait( lock, [this]{ return m_quit || m_hasPendingLoad || !m_pendingRecs.empty(); } );
+
+        // A load requested before laps of its key were queued must not see them twice: load first
+        const bool     quit = m_quit;
+        const bool     load = m_hasPendingLoad && !quit;
+        const Key      key  = m_pendingLoad;
+        const unsigned seq  = m_loadSeq;
+        std::vector<Record> recs;
+        recs.swap( m_pendingRecs );
+        m_hasPendingLoad = false;
+        lock.unlock();
+
+        std::vector<Lap> laps;
+        if( load )
+            loadFromDb( key, laps );
+        appendToDb( recs );
+
+        lock.lock();
+        if( load )
+        {
+            m_loaded.swap( laps );
+            m_loadedSeq = seq;
+        }
+        if( quit )
+            return;
+    }
+}
+
+void FuelModel::loadFromDb( const Key& key, std::vector<Lap>& out )
+{
+    std::string data;
+    if( !loadFile( DbFile, data ) || data.size() < (size_t)DbHeaderSize )
+        return;
+
+    uint32_t version = 0;
+    memcpy( &version, data.data()+4, 4 );
+    if( memcmp( data.data(), "IFFU", 4 ) != 0 || version != DbVersion )
+    {
+        Logger::instance().logWarning( std::string("Ignoring ") + DbFile + ": unknown format" );
+        return;
+    }
+
+    // Walk newest to oldest, counting laps per key to decide what is worth keeping
+    struct KeyCount { Key key; size_t all = 0; size_t green = 0; };
+    std::vector<KeyCount> counts;
+    const size_t count = (data.size() - DbHeaderSize) / sizeof(Record);
+    std::vector<uint8_t> keep( count, 0 );
+    size_t kept = 0;
+    for( size_t i=count; i-- > 0; )
+    {
+        Record r;
+        memcpy( &r, data.data() + DbHeaderSize + i*sizeof(Record), sizeof(Record) );
+        Key k;
+        k.trackId    = r.trackId;
+        k.configHash = r.configHash;
+        k.carId      = r.carId;
+
+        auto it = std::find_if( counts.begin(), counts.end(), [&]( const KeyCount& c ){ return c.key == k; } );
+        if( it == counts.end() )
+        {
+            counts.push_back( KeyCount{ k } );
+            it = counts.end() - 1;
+        }
+
+        const bool green = (r.flags & FuelGreen) != 0;
+        if( it->all++ < MaxGreenLaps || (green && it->green < MaxGreenLaps) )
+        {
+            keep[i] = 1;
+            kept++;
+            if( green && k == key )
+            {
+                Lap l;
+                l.used    = r.used;
+                l.lapTime = r.lapTime;
+                l.flags   = r.flags;
+                out.push_back( l );
+            }
+        }
+        if( green )
+            it->green++;
+    }
+    std::reverse( out.begin(), out.end() );
+
+    // Rewriting costs about as much as this load did; only bother when it shrinks the file noticeably
+    if( count - kept >= MaxGreenLaps/4 )
+    {
+        std::string compacted( data.data(), DbHeaderSize );
+        compacted.reserve( DbHeaderSize + kept * sizeof(Record) );
+        for( size_t i=0; i<count; ++i )
+            if( keep[i] )
+                compacted.append( data.data() + DbHeaderSize + i*sizeof(Record), sizeof(Record) );
+        if( !replaceFileW( toWide(DbFile), compacted ) )
+            Logger::instance().logError( std::string("Failed to compact ") + DbFile );
+    }
+}
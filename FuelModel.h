@@ -0,0 +1,164 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "CarTrackKey.h"
+
+// Per-lap fuel usage of our own car, shared by the Fuel and DDU overlays.
+// Every completed lap is appended to a small binary database (fuel.db) together with its lap time
+// and flags, keyed by track, track config and car. All file access happens on one worker thread:
+// it appends finished laps, and on session change loads the laps for the current key, dropping
+// records no one will load again. Until a load finishes, queries only see the laps driven since.
+// Green laps are kept in chronological order for "last N" averages and trends, and in a sorted copy
+// for percentiles.
+
+class FuelModel
+{
+    public:
+
+        enum LapFlags : uint8_t
+        {
+            FuelGreen   = 1 << 0,   // whole lap under green, off pit road: usable for estimates
+            FuelCaution = 1 << 1,   // caution, pace or pre-green at some point during the lap
+            FuelPit     = 1 << 2,   // touched pit road during the lap
+            FuelPush    = 1 << 3,   // green lap within 1% of our best green lap time
+        };
+
+        struct Lap
+        {
+            float   used = 0;       // liters
+            float   lapTime = 0;    // seconds, 0 if unknown
+            uint8_t flags = 0;
+        };
+
+        struct PitEntry { int pitLap = 0; int greenLaps = 0; };
+
+        // Call once per loop, after ir_tick().
+        void        update();
+
+        // Writes pending laps and stops the worker. Call before exit.
+        void        shutdown();
+
+        bool        isLoading() const { return m_loading; }
+
+        // Fuel level at the start of the lap in progress
+        float       lapStartFuel() const { return m_lapStartFuel; }
+
+        // Mean / max of the last n green laps, this session or earlier ones. 0 if there are none.
+        float       average( int n ) const;
+        float       recentMax( int n ) const;
+
+        // p in [0,1] over all known green laps for this car/track, linearly interpolated. 0 if there are none.
+        float       percentile( float p ) const;
+
+        // Least-squares slope over the last n green laps, in liters per lap per lap. 0 with fewer than three.
+        float       trend( int n ) const;
+
+        int         numGreenLaps() const { return (int)m_green.size(); }
+
+        // Worst green lap this session / since the last pit stop
+        float       sessionMax() const { return m_sessionMax; }
+        float       stintMax() const { return m_stintMax; }
+        int         greenLapsSincePit() const { return m_greenSincePit; }
+
+        // Most recent pit stops this session, oldest first
+        const std::deque<PitEntry>& pitHistory() const { return m_pitHistory; }
+
+    private:
+
+        using Key = CarTrackKey;
+
+        static constexpr int    MaxPitHistory = 6;
+        static constexpr size_t MaxGreenLaps = 1024;    // per key, oldest are dropped (also from fuel.db)
+
+        // On-disk record, see FuelModel.cpp
+        struct Record
+        {
+            int32_t     trackId;
+            uint32_t    configHash;
+            int32_t     carId;
+            float       used;
+            float       lapTime;
+            uint8_t     flags;
+            uint8_t     pad[3];
+        };
+
+        void        onSessionChanged();
+        void        refreshKey();
+        void        startLoad();
+        void        finishLoad();
+        void        addLap( Lap lap );
+        void        insertGreen( const Lap& lap );
+        void        worker();
+        static void appendToDb( const std::vector<Record>& recs );
+        static void loadFromDb( const Key& key, std::vector<Lap>& out );
+
+        // Current key, and the legacy per-key average from config.json's FuelCache
+        Key                 m_key;
+        std::string         m_legacyKey;
+
+        // Green laps for the current key, chronological and sorted
+        std::vector<Lap>    m_green;
+        std::vector<float>  m_sorted;
+        float               m_bestGreenLapTime = 0;
+
+        // Lap in progress
+        int                 m_subsessionId = -1;
+        int                 m_sessionNum = -1;
+        int                 m_prevLap = -1;
+        float               m_lapStartFuel = 0;
+        double              m_lapStartTime = 0;
+        uint8_t             m_curFlags = 0;
+        bool                m_lapValid = false;     // lap in progress was started by a line crossing we saw
+        bool                m_prevOnPitRoad = false;
+
+        // Session and stint
+        float               m_sessionMax = 0;
+        float               m_stintMax = 0;
+        int                 m_greenSincePit = 0;
+        std::deque<PitEntry> m_pitHistory;
+
+        // Worker. A load queued while another is pending replaces it; results of superseded loads
+        // are dropped by sequence number.
+        std::thread             m_thread;
+        std::mutex              m_mutex;
+        std::condition_variable m_cv;
+        bool                    m_quit = false;         // guarded by m_mutex, like everything below but m_loading
+        std::vector<Record>     m_pendingRecs;
+        Key                     m_pendingLoad;
+        bool                    m_hasPendingLoad = false;
+        unsigned                m_loadSeq = 0;          // newest load requested
+        unsigned                m_loadedSeq = 0;        // load whose result is in m_loaded
+        std::vector<Lap>        m_loaded;
+        bool                    m_loading = false;      // main thread: waiting for load m_loadSeq
+};
+
+extern FuelModel ir_fuel;
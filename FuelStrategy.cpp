@@ -0,0 +1,174 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "FuelStrategy.h"
+#include <algorithm>
+#include <math.h>
+
+FuelStrategy ir_strategy;
+
+bool FuelStrategy::Inputs::differsFrom( const Inputs& o ) const
+{
+    // Fuel level and consumption creep every frame; only re-plan once they've moved a bit
+    return fabsf( fuel - o.fuel ) >= 0.1f
+        || fabsf( perLap - o.perLap ) >= 0.005f
+        || fabsf( timeRemaining - o.timeRemaining ) >= 5.0f
+        || fabsf( lapTime - o.lapTime ) >= 0.25f
+        || lapsRemaining != o.lapsRemaining
+        || capacity != o.capacity
+        || reserve != o.reserve
+        || pitLoss != o.pitLoss
+        || fillRate != o.fillRate
+        || saveFraction != o.saveFraction;
+}
+
+void FuelStrategy::submit( const Inputs& in )
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    if( m_hasLast && !in.differsFrom( m_last ) )
+        return;
+
+    m_last = in;
+    m_hasLast = true;
+    m_pending = in;
+    m_hasPending = true;
+    if( !m_thread.joinable() )
+        m_thread = std::thread( &FuelStrategy::worker, this );
+    m_cv.notify_one();
+}
+
+FuelStrategy::Plan FuelStrategy::plan() const
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_plan;
+}
+
+void FuelStrategy::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_quit = true;
+    }
+    m_cv.notify_one();
+    if( m_thread.joinable() )
+        m_thread.join();
+}
+
+void FuelStrategy::worker()
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    while( true )
+    {
+        m_cv.wait( lock, [this]{ return m_quit || m_hasPending; } );
+        if( m_quit )
+            return;
+
+        const Inputs in = m_pending;
+        m_hasPending = false;
+
+        lock.unlock();
+        Plan p = solve( in );
+        lock.lock();
+
+        p.seq = m_plan.seq + 1;
+        m_plan = p;
+    }
+}
+
+namespace
+{
+    // Laps still to drive. In timed races every stop costs track time, so fewer laps fit in.
+    float lapsToGoWith( const FuelStrategy::Inputs& in, int stops, float addTotal )
+    {
+        if( in.timeRemaining < 0 )
+            return (float)in.lapsRemaining;
+        const float pitTime = stops * in.pitLoss + (in.fillRate > 0 ? addTotal / in.fillRate : 0);
+        // The leader takes the flag after time runs out, so the lap in progress then still counts
+        return ceilf( std::max( 0.0f, in.timeRemaining - pitTime ) / in.lapTime );
+    }
+
+    int stopsFor( float need, float perStop )
+    {
+        return need <= 0 ? 0 : (int)ceilf( need / perStop );
+    }
+}
+
+FuelStrategy::Plan FuelStrategy::solve( const Inputs& in )
+{
+    Plan p;
+
+    const float perLap  = in.perLap * (1.0f - std::clamp( in.saveFraction, 0.0f, 0.5f ));
+    const float perStop = in.capacity - in.reserve;     // most we can add: arrive on reserve, leave full
+    const bool  timed   = in.timeRemaining >= 0;
+    if( perLap <= 0 || perStop <= 0 || (timed ? in.lapTime <= 0 : in.lapsRemaining < 0) )
+        return p;
+
+    // In timed races laps and stops depend on each other; a few rounds settle it
+    float lapsToGo = lapsToGoWith( in, 0, 0 );
+    int   stops = 0;
+    float need = 0;
+    for( int i=0; i<4; ++i )
+    {
+        need  = lapsToGo * perLap + in.reserve - in.fuel;
+        stops = stopsFor( need, perStop );
+        const float next = lapsToGoWith( in, stops, std::max( 0.0f, need ) );
+        if( next == lapsToGo )
+            break;
+        lapsToGo = next;
+    }
+
+    p.valid       = true;
+    p.lapsToGo    = lapsToGo;
+    p.perLap      = perLap;
+    p.stops       = stops;
+    p.totalAdd    = std::max( 0.0f, need );
+    p.fillPerStop = stops ? p.totalAdd / stops : 0;
+    p.pitTime     = stops * in.pitLoss + (in.fillRate > 0 ? p.totalAdd / in.fillRate : 0);
+
+    // Equal fills. Stop k can happen once the tank has room for the fill, and must happen before
+    // we'd run into the reserve.
+    float earliest = 0;
+    for( int k=0; k<std::min( stops, MaxStops ); ++k )
+    {
+        const float fuelBefore = in.fuel + k * p.fillPerStop;
+        earliest = std::max( earliest, ceilf( (fuelBefore + p.fillPerStop - in.capacity) / perLap ) );
+        p.windowOpen[k]  = (int)earliest;
+        p.windowClose[k] = std::max( (int)earliest, (int)floorf( (fuelBefore - in.reserve) / perLap ) );
+    }
+
+    // Fuel-saving target that would drop a stop, if that's still possible at all
+    if( stops > 0 )
+    {
+        const int   fewer = stops - 1;
+        const float laps  = lapsToGoWith( in, fewer, fewer * perStop );
+        if( laps > 0 )
+        {
+            const float perLapMax = (in.fuel - in.reserve + fewer * perStop) / laps;
+            if( perLapMax > 0 && perLapMax >= perLap * 0.5f )
+                p.perLapForOneLess = perLapMax;
+        }
+    }
+
+    return p;
+}
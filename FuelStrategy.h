@@ -0,0 +1,99 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+// Pit-stop planner for the rest of the race: the fewest stops that get us to the flag, how much to
+// add at each of them, the lap window for each stop, and how much fuel we'd have to save per lap to
+// get away with one stop less. Solving runs on a worker thread; overlays submit their inputs every
+// frame and read back the latest plan. Submissions that don't change the inputs meaningfully are
+// dropped without waking the worker.
+
+class FuelStrategy
+{
+    public:
+
+        static constexpr int MaxStops = 16;
+
+        struct Inputs
+        {
+            float   fuel = 0;               // liters in the tank now
+            float   perLap = 0;             // expected use per lap, liters
+            float   capacity = 0;           // tank size, liters
+            float   reserve = 0;            // never plan to arrive with less than this
+            int     lapsRemaining = -1;     // lap-limited races; -1 if the race is timed or unknown
+            float   timeRemaining = -1;     // timed races, seconds; -1 otherwise
+            float   lapTime = 0;            // expected lap time, seconds (timed races)
+            float   pitLoss = 0;            // time lost driving through pit lane, seconds
+            float   fillRate = 0;           // liters per second while refueling
+            float   saveFraction = 0;       // fuel-saving target, fraction of perLap (0.05 = 5%)
+
+            bool    differsFrom( const Inputs& o ) const;
+        };
+
+        struct Plan
+        {
+            bool    valid = false;
+            unsigned seq = 0;               // bumped on every new plan
+            int     stops = 0;
+            float   lapsToGo = 0;
+            float   perLap = 0;             // use per lap the plan assumes, after saving
+            float   totalAdd = 0;           // liters over all stops
+            float   fillPerStop = 0;        // liters, same for every stop
+            float   pitTime = 0;            // total seconds spent on pit lane, incl. refueling
+            int     windowOpen[MaxStops] = {};  // earliest lap for each stop, counted from now
+            int     windowClose[MaxStops] = {}; // last lap for each stop before we'd dip into the reserve
+            float   perLapForOneLess = 0;   // max use per lap that saves a stop, 0 if there is none to save
+        };
+
+        // Hands the inputs to the worker if they differ meaningfully from the last ones.
+        void        submit( const Inputs& in );
+
+        // Latest plan. Not valid until the first solve has finished.
+        Plan        plan() const;
+
+        void        shutdown();
+
+        // The actual solver, for anyone who needs a plan synchronously
+        static Plan solve( const Inputs& in );
+
+    private:
+
+        void        worker();
+
+        mutable std::mutex      m_mutex;
+        std::condition_variable m_cv;
+        std::thread             m_thread;
+        Inputs                  m_last;
+        Inputs                  m_pending;
+        bool                    m_hasLast = false;
+        bool                    m_hasPending = false;
+        bool                    m_quit = false;
+        Plan                    m_plan;
+};
+
+extern FuelStrategy ir_strategy;
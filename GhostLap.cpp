@@ -0,0 +1,299 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "GhostLap.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include "Logger.h"
+#include "util.h"
+
+// .ifg layout (little endian, every array 4-byte aligned):
+//   Header
+//   float    lapPct[sampleCount]       ascending, unique
+//   float    throttle[sampleCount]
+//   float    brake[sampleCount]
+//   float    steerAngle[sampleCount]
+//   uint32_t lut[lutSize+1]            lut[b] = last sample with lapPct <= b/lutSize (0 if none)
+static constexpr uint32_t GhostVersion = 1;
+static constexpr uint32_t MaxSamples   = 200000;
+static constexpr uint32_t MinLutSize   = 256;
+static constexpr uint32_t MaxLutSize   = 65536;
+
+static bool endsWithI( const std::wstring& s, const wchar_t* suffix )
+{
+    const size_t n = wcslen( suffix );
+    return s.size() >= n && _wcsicmp( s.c_str() + s.size() - n, suffix ) == 0;
+}
+
+bool GhostLap::open( const std::wstring& path )
+{
+    close();
+
+    if( !endsWithI( path, L".csv" ) )
+    {
+        if( openMapped( path ) )
+            return true;
+        if( m_map.data() )
+            Logger::instance().log( LogLevel::Warning, L"Ignoring ghost lap " + path + L": unknown format" );
+        close();
+        return false;
+    }
+
+    // A cache that is stale, truncated or from an older format version is rebuilt from the CSV
+    const std::wstring binPath = path + L".ifg";
+    if( isFileUpToDateW( binPath, path ) )
+    {
+        if( openMapped( binPath ) )
+            return true;
+        Logger::instance().log( LogLevel::Warning, L"Rebuilding ghost lap cache " + binPath + L": unknown format" );
+        close();
+    }
+    return convertCsv( path, binPath );
+}
+
+bool GhostLap::openMapped( const std::wstring& binPath )
+{
+    return m_map.open( binPath ) && attach( m_map.data(), m_map.size() );
+}
+
+bool GhostLap::convertCsv( const std::wstring& csvPath, const std::wstring& binPath )
+{
+    std::string csv;
+    std::vector<Sample> samples;
+    if( !loadFileW( csvPath, csv ) || !parseCsv( csv, samples ) )
+        return false;
+
+    std::string blob;
+    buildBlob( std::move(samples), 0.0f, blob );
+    if( !replaceFileW( binPath, blob ) )
+    {
+        // Read-only location: serve the converted lap from memory
+        return openBlob( std::move(blob) );
+    }
+    if( openMapped( binPath ) )
+        return true;
+    close();
+    return openBlob( std::move(blob) );
+}
+
+bool GhostLap::openBlob( std::string&& blob )
+{
+    close();
+    m_owned = std::move( blob );
+    if( attach( m_owned.data(), m_owned.size() ) )
+        return true;
+    close();
+    return false;
+}
+
+void GhostLap::close()
+{
+    m_map.close();
+    m_owned.clear();
+
+    m_pct = m_throttle = m_brake = m_steer = nullptr;
+    m_lut = nullptr;
+    m_count = 0;
+    m_lutSize = 0;
+    m_lapTime = 0;
+}
+
+bool GhostLap::attach( const char* data, size_t size )
+{
+    if( size < sizeof(Header) )
+        return false;
+
+    Header h;
+    memcpy( &h, data, sizeof(h) );
+    if( memcmp( h.magic, "IFGH", 4 ) != 0 || h.version != GhostVersion )
+        return false;
+    if( h.sampleCount == 0 || h.sampleCount > MaxSamples || h.lutSize == 0 || h.lutSize > MaxLutSize )
+        return false;
+
+    const size_t n = h.sampleCount;
+    const size_t need = sizeof(Header) + 4 * n * sizeof(float) + (h.lutSize + 1) * sizeof(uint32_t);
+    if( size < need )
+        return false;
+
+    const float* arrays = (const float*)(data + sizeof(Header));
+    const uint32_t* lut = (const uint32_t*)(arrays + 4 * n);
+    for( uint32_t b=0; b<=h.lutSize; ++b )
+        if( lut[b] >= h.sampleCount )
+            return false;
+
+    m_pct      = arrays;
+    m_throttle = arrays + n;
+    m_brake    = arrays + 2 * n;
+    m_steer    = arrays + 3 * n;
+    m_lut      = lut;
+    m_count    = h.sampleCount;
+    m_lutSize  = h.lutSize;
+    m_lapTime  = h.lapTime;
+    return true;
+}
+
+GhostLap::Sample GhostLap::sample( float pct ) const
+{
+    Sample s;
+    if( !m_count )
+        return s;
+
+    pct = std::max( 0.0f, std::min( 1.0f, pct ) );
+    const uint32_t b = std::min( m_lutSize, (uint32_t)(pct * (float)m_lutSize) );
+
+    // The table lands on (or one past, through rounding) the last sample at or before pct
+    uint32_t i = m_lut[b];
+    while( i > 0 && m_pct[i] > pct )
+        --i;
+    while( i + 1 < m_count && m_pct[i + 1] <= pct )
+        ++i;
+
+    const uint32_t j = i + 1 < m_count ? i + 1 : i;
+    float t = (m_pct[j] > m_pct[i]) ? (pct - m_pct[i]) / (m_pct[j] - m_pct[i]) : 0.0f;
+    t = std::max( 0.0f, std::min( 1.0f, t ) );
+
+    s.lapPct     = pct;
+    s.throttle   = m_throttle[i] * (1.0f - t) + m_throttle[j] * t;
+    s.brake      = m_brake[i] * (1.0f - t) + m_brake[j] * t;
+    s.steerAngle = m_steer[i] * (1.0f - t) + m_steer[j] * t;
+    return s;
+}
+
+void GhostLap::buildBlob( std::vector<Sample> samples, float lapTime, std::string& out )
+{
+    samples.erase( std::remove_if( samples.begin(), samples.end(), []( const Sample& s ) { return !(s.lapPct >= 0.0f && s.lapPct <= 1.0f); } ), samples.end() );
+    std::stable_sort( samples.begin(), samples.end(), []( const Sample& a, const Sample& b ) { return a.lapPct < b.lapPct; } );
+
+    // Deduplicate equal lapPct by keeping last
+    size_t n = 0;
+    for( size_t i=0; i<samples.size(); ++i )
+    {
+        if( n > 0 && samples[i].lapPct <= samples[n-1].lapPct )
+            samples[n-1] = samples[i];
+        else
+            samples[n++] = samples[i];
+    }
+    n = std::min( n, (size_t)MaxSamples );
+
+    Header h = {};
+    memcpy( h.magic, "IFGH", 4 );
+    h.version     = GhostVersion;
+    h.sampleCount = (uint32_t)n;
+    h.lutSize     = std::max( MinLutSize, std::min( MaxLutSize, (uint32_t)n ) );
+    h.lapTime     = lapTime;
+
+    out.assign( sizeof(Header) + 4 * n * sizeof(float) + (h.lutSize + 1) * sizeof(uint32_t), '\0' );
+    memcpy( &out[0], &h, sizeof(h) );
+
+    float* arrays = (float*)&out[sizeof(Header)];
+    for( size_t i=0; i<n; ++i )
+    {
+        arrays[i]         = samples[i].lapPct;
+        arrays[n + i]     = samples[i].throttle;
+        arrays[2 * n + i] = samples[i].brake;
+        arrays[3 * n + i] = samples[i].steerAngle;
+    }
+
+    uint32_t* lut = (uint32_t*)(arrays + 4 * n);
+    uint32_t i = 0;
+    for( uint32_t b=0; b<=h.lutSize; ++b )
+    {
+        const float x = (float)b / (float)h.lutSize;
+        while( i + 1 < n && arrays[i + 1] <= x )
+            ++i;
+        lut[b] = i;
+    }
+}
+
+bool GhostLap::parseCsv( const std::string& csv, std::vector<Sample>& out )
+{
+    out.clear();
+
+    const char* p   = csv.c_str();
+    const char* end = p + csv.size();
+
+    // Header: find the columns we need
+    int idxLapPct = -1, idxThr = -1, idxBrk = -1, idxSteer = -1;
+    const char* eol = (const char*)memchr( p, '\n', end - p );
+    if( !eol )
+        return false;
+    {
+        int col = 0;
+        for( const char* f = p; f <= eol; ++col )
+        {
+            const char* c = (const char*)memchr( f, ',', eol - f );
+            const char* fe = c ? c : eol;
+            size_t len = fe - f;
+            if( len && f[len-1] == '\r' )
+                --len;
+            const std::string k( f, len );
+            if( k == "LapDistPct" ) idxLapPct = col;
+            else if( k == "Throttle" ) idxThr = col;
+            else if( k == "Brake" ) idxBrk = col;
+            else if( k == "SteeringWheelAngle" ) idxSteer = col;
+            f = fe + 1;
+        }
+    }
+    if( idxLapPct < 0 || idxThr < 0 || idxBrk < 0 || idxSteer < 0 )
+        return false;
+    const int lastCol = std::max( std::max( idxLapPct, idxThr ), std::max( idxBrk, idxSteer ) );
+
+    out.reserve( std::min( (size_t)MaxSamples, csv.size() / 32 ) );
+
+    // Rows: parse the wanted fields in place, no per-field strings
+    for( p = eol + 1; p < end && out.size() < MaxSamples; )
+    {
+        eol = (const char*)memchr( p, '\n', end - p );
+        if( !eol )
+            eol = end;
+
+        float vals[4] = {};
+        int col = 0;
+        for( const char* f = p; f <= eol && col <= lastCol; ++col )
+        {
+            const char* c = (const char*)memchr( f, ',', eol - f );
+            const char* fe = c ? c : eol;
+            // strtof skips leading whitespace, so never hand it an empty field
+            const float v = fe > f ? strtof( f, nullptr ) : 0.0f;
+            if( col == idxLapPct ) vals[0] = v;
+            else if( col == idxThr ) vals[1] = v;
+            else if( col == idxBrk ) vals[2] = v;
+            else if( col == idxSteer ) vals[3] = v;
+            f = fe + 1;
+        }
+
+        if( col > lastCol )
+        {
+            Sample s;
+            s.lapPct     = vals[0];
+            s.throttle   = vals[1];
+            s.brake      = vals[2];
+            s.steerAngle = vals[3];  // radians per CSV header semantics
+            out.push_back( s );
+        }
+        p = eol + 1;
+    }
+    return !out.empty();
+}
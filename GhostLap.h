@@ -0,0 +1,105 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// A recorded reference lap ("ghost") for the Inputs overlay: throttle, brake and steering angle
+// sampled against LapDistPct. Stored on disk in a compact binary format (.ifg) that is memory-mapped
+// as-is: a fixed header, four float arrays (structure of arrays) and a uniform lookup table over lap
+// distance, so sampling at any lap position costs a table read plus a short forward scan.
+// Legacy CSV exports are converted once to "<name>.csv.ifg" next to the CSV (or in memory if that
+// location isn't writable) and served from the binary form afterwards.
+
+class GhostLap
+{
+    public:
+
+        struct Sample
+        {
+            float lapPct = 0;
+            float throttle = 0;
+            float brake = 0;
+            float steerAngle = 0;   // radians
+        };
+
+        struct Header
+        {
+            char     magic[4];      // "IFGH"
+            uint32_t version;
+            uint32_t sampleCount;
+            uint32_t lutSize;       // lut has lutSize+1 entries covering lapPct 0..1
+            float    lapTime;       // seconds, 0 if unknown
+            uint32_t reserved[3];
+        };
+
+        GhostLap() = default;
+        ~GhostLap() { close(); }
+        GhostLap( const GhostLap& ) = delete;
+        GhostLap& operator=( const GhostLap& ) = delete;
+
+        // Opens a .ifg file, or a .csv file through its converted cache. Returns false (and leaves the
+        // ghost closed) if the file is missing or malformed.
+        bool        open( const std::wstring& path );
+
+        // Takes over an .ifg blob already in memory
+        bool        openBlob( std::string&& blob );
+        void        close();
+
+        bool        isOpen() const { return m_count > 0; }
+        int         sampleCount() const { return (int)m_count; }
+        float       lapTime() const { return m_lapTime; }
+
+        // Linearly interpolated values at lap position pct (clamped to [0,1])
+        Sample      sample( float pct ) const;
+
+        // Serializes samples (any order; sorted and de-duplicated here) into a .ifg blob
+        static void buildBlob( std::vector<Sample> samples, float lapTime, std::string& out );
+
+        // Parses a LapDistPct/Throttle/Brake/SteeringWheelAngle CSV export
+        static bool parseCsv( const std::string& csv, std::vector<Sample>& out );
+
+    private:
+
+        bool        attach( const char* data, size_t size );
+        bool        openMapped( const std::wstring& binPath );
+        bool        convertCsv( const std::wstring& csvPath, const std::wstring& binPath );
+
+        // Backing storage: either a read-only file view or an owned copy
+        MappedFile  m_map;
+        std::string m_owned;
+
+        const float*    m_pct = nullptr;
+        const float*    m_throttle = nullptr;
+        const float*    m_brake = nullptr;
+        const float*    m_steer = nullptr;
+        const uint32_t* m_lut = nullptr;
+        uint32_t        m_count = 0;
+        uint32_t        m_lutSize = 0;
+        float           m_lapTime = 0;
+};
@@ -0,0 +1,349 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "GhostRecorder.h"
+#include <windows.h>
+#include <algorithm>
+#include <stdio.h>
+#include "iracing.h"
+#include "Config.h"
+#include "Logger.h"
+#include "util.h"
+
+GhostRecorder ir_ghost;
+
+static constexpr const wchar_t* GhostDir = L"ghosts";
+static constexpr size_t         MinLapSamples = 100;
+
+GhostRecorder::GhostRecorder()
+{
+    m_capture.reserve( MaxLapSamples );
+    m_queued.reserve( MaxLapSamples );
+    m_saveBuf.reserve( MaxLapSamples );
+}
+
+void GhostRecorder::update()
+{
+    if( m_loading )
+        finishLoad();
+    if( m_saving )
+        finishSave();
+    startSave();
+
+    if( !ir_hasValidDriver() )
+    {
+        m_prevPct = -1;
+        return;
+    }
+
+    if( ir_session.subsessionId != m_subsessionId )
+    {
+        m_subsessionId = ir_session.subsessionId;
+        m_prevLap      = -1;
+        m_lapValid     = false;
+        m_prevPct      = -1;
+        m_lineTime     = -1;
+        refreshKey();
+    }
+    else if( !m_key.valid() )
+    {
+        refreshKey();   // car/track info can show up a few ticks after the session does
+    }
+
+    const int    carIdx    = ir_session.driverCarIdx;
+    const int    lap       = ir_isPreStart() ? 0 : std::max( 0, ir_CarIdxLap.getInt(carIdx) );
+    const double now       = ir_SessionTime.getDouble();
+    const int    incidents = ir_PlayerCarMyIncidentCount.getInt();
+    const float  pct       = ir_LapDistPct.getFloat();
+
+    // Interpolate the moment LapDistPct wraps between the samples either side of the line, so lap
+    // times don't depend on which tick we happen to notice the new lap on
+    if( pct >= 0 && m_prevPct >= 0 && now > m_prevTime && pct < m_prevPct - 0.5f )
+    {
+        const float step = pct + 1.0f - m_prevPct;
+        if( step <= 0.25f )
+            m_lineTime = m_prevTime + (now - m_prevTime) * ((1.0f - m_prevPct) / step);
+    }
+
+    if( lap != m_prevLap )
+    {
+        // Resets and tows make the lap counter jump; an incident anywhere spoils the lap
+        const double lineTime = lineCrossingTime( pct, now );
+        if( m_lapValid && lap == m_prevLap+1 && incidents == m_lapStartIncidents )
+            onLapCompleted( (float)(lineTime - m_lapStartTime) );
+        m_prevLap           = lap;
+        m_lapStartTime      = lineTime;
+        m_lapStartIncidents = incidents;
+        m_lapValid          = true;
+        m_capture.clear();
+    }
+    if( now != m_prevTime || m_prevPct < 0 )   // keep the last distinct sim sample when we run faster than the sim
+    {
+        m_prevPct  = pct;
+        m_prevTime = now;
+    }
+
+    if( !ir_IsOnTrack.getBool() || ir_CarIdxOnPitRoad.getBool(carIdx) )
+        m_lapValid = false;
+    if( !m_lapValid )
+        return;
+
+    // The line crossing can report the old lap's position for a tick. After that only keep samples
+    // that move forward, which also drops repeats when we run faster than the sim ticks.
+    if( m_capture.empty() ? pct > 0.5f : pct <= m_capture.back().lapPct )
+        return;
+    if( m_capture.size() >= MaxLapSamples )
+    {
+        m_lapValid = false;
+        return;
+    }
+
+    GhostLap::Sample s;
+    s.lapPct     = pct;
+    s.throttle   = ir_Throttle.getFloat();
+    s.brake      = ir_Brake.getFloat();
+    s.steerAngle = ir_SteeringWheelAngle.getFloat();
+    m_capture.push_back( s );
+}
+
+void GhostRecorder::shutdown()
+{
+    // Let the load and save in flight finish, so a best lap queued behind them still gets written.
+    // The second round waits for that write.
+    for( int round=0; round<2 && (m_loading || m_saving); ++round )
+    {
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_doneCv.wait( lock, [this]{ return (!m_loading || m_loadedSeq == m_loadSeq) && (!m_saving || m_saveFinished); } );
+        }
+        if( m_loading )
+            finishLoad();
+        if( m_saving )
+            finishSave();
+        startSave();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_quit = true;
+    }
+    m_cv.notify_one();
+    if( m_thread.joinable() )
+        m_thread.join();
+}
+
+// The lap counter and LapDistPct don't always change on the same tick. If the position has already
+// wrapped, use the crossing interpolated then; if it still shows the end of the old lap, extrapolate
+// from the last step. Falls back to the current time when neither is plausible (resets, tows).
+double GhostRecorder::lineCrossingTime( float pct, double now ) const
+{
+    if( pct >= 0 && pct < 0.5f )
+        return m_lineTime >= 0 && now >= m_lineTime && now - m_lineTime < 1.0 ? m_lineTime : now;
+
+    const float step = pct - m_prevPct;
+    if( m_prevPct >= 0 && now > m_prevTime && step > 0 && step <= 0.25f )
+        return now + (now - m_prevTime) * ((1.0f - pct) / step);
+    return now;
+}
+
+void GhostRecorder::onLapCompleted( float lapTime )
+{
+    // Must cover the lap from line to line
+    if( m_capture.size() < MinLapSamples || m_capture.front().lapPct > 0.05f || m_capture.back().lapPct < 0.95f )
+        return;
+    if( lapTime <= 0 || (m_bestTime > 0 && lapTime >= m_bestTime) || (m_hasQueued && lapTime >= m_queuedTime) )
+        return;
+    if( !m_key.valid() || !g_cfg.getBool( "OverlayInputs", "record_pb_ghost", true ) )
+        return;
+
+    // Replaces a slower lap still waiting in the queue; both buffers keep their capacity
+    m_capture.swap( m_queued );
+    m_queuedTime = lapTime;
+    m_queuedKey  = m_key;
+    m_hasQueued  = true;
+    startSave();
+}
+
+// Hands the queued lap to the worker once the stored best is known and nothing is being written
+void GhostRecorder::startSave()
+{
+    if( !m_hasQueued || m_loading || m_saving )
+        return;
+
+    m_hasQueued = false;
+    if( !(m_queuedKey == m_key) || (m_bestTime > 0 && m_queuedTime >= m_bestTime) )
+        return;     // car or track changed, or the stored best turned out faster
+
+    m_queued.swap( m_saveBuf );
+    m_bestTime = m_queuedTime;
+    m_saveTime = m_queuedTime;
+    m_saveKey  = m_queuedKey;
+    m_saving   = true;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_hasSaveJob   = true;
+        m_saveFinished = false;
+        startWorker();
+    }
+    m_cv.notify_one();
+}
+
+void GhostRecorder::refreshKey()
+{
+    const Key key = Key::current();
+    if( key == m_key )
+        return;
+
+    m_key = key;
+    m_best.close();
+    m_bestTime = 0;
+    ++m_generation;
+    startLoad();
+}
+
+void GhostRecorder::startLoad()
+{
+    // Supersedes a load for a previous key that is still pending or running
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_loadKey    = m_key;
+        m_hasLoadJob = m_key.valid();
+        ++m_loadSeq;
+        if( !m_hasLoadJob )
+            m_loadedSeq = m_loadSeq;    // nothing to load
+        else
+            startWorker();
+    }
+    m_cv.notify_one();
+    m_loading = true;
+}
+
+void GhostRecorder::finishLoad()
+{
+    std::string loaded;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        if( m_loadedSeq != m_loadSeq )
+            return;
+        loaded.swap( m_loaded );
+    }
+    m_loading = false;
+
+    if( !loaded.empty() )
+    {
+        if( m_best.openBlob( std::move(loaded) ) )
+        {
+            m_bestTime = m_best.lapTime();
+            ++m_generation;
+        }
+        else
+        {
+            Logger::instance().log( LogLevel::Warning, L"Ignoring ghost lap " + fileFor(m_key) + L": unknown format" );
+        }
+    }
+}
+
+void GhostRecorder::finishSave()
+{
+    std::string saved;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        if( !m_saveFinished )
+            return;
+        saved.swap( m_saved );
+    }
+    m_saving = false;
+
+    // Serve the new best straight from the serialized blob, unless car or track changed meanwhile
+    if( m_saveKey == m_key && !saved.empty() && m_best.openBlob( std::move(saved) ) )
+    {
+        m_bestTime = m_saveTime;
+        ++m_generation;
+    }
+    m_saveBuf.clear();
+}
+
+// Call with m_mutex held
+void GhostRecorder::startWorker()
+{
+    if( !m_thread.joinable() )
+        m_thread = std::thread( &GhostRecorder::worker, this );
+}
+
+void GhostRecorder::worker()
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    while( true )
+    {
+        m_cv.wait( lock, [this]{ return m_quit || m_hasLoadJob || m_hasSaveJob; } );
+
+        if( m_hasSaveJob )
+        {
+            m_hasSaveJob = false;
+            lock.unlock();
+
+            std::string blob;
+            const std::wstring path = fileFor( m_saveKey );
+            GhostLap::buildBlob( m_saveBuf, m_saveTime, blob );
+            CreateDirectoryW( GhostDir, nullptr );
+            if( !replaceFileW( path, blob ) )
+                Logger::instance().log( LogLevel::Error, L"Failed to save ghost lap " + path );
+
+            lock.lock();
+            m_saved.swap( blob );
+            m_saveFinished = true;
+            m_doneCv.notify_all();
+        }
+
+        if( m_hasLoadJob )
+        {
+            const Key      key = m_loadKey;
+            const unsigned seq = m_loadSeq;
+            m_hasLoadJob = false;
+            lock.unlock();
+
+            std::string data;
+            if( !loadFileW( fileFor(key), data ) )
+                data.clear();
+
+            lock.lock();
+            if( seq == m_loadSeq )
+            {
+                m_loaded.swap( data );
+                m_loadedSeq = seq;
+                m_doneCv.notify_all();
+            }
+        }
+
+        if( m_quit && !m_hasLoadJob && !m_hasSaveJob )
+            return;
+    }
+}
+
+std::wstring GhostRecorder::fileFor( const Key& key )
+{
+    char buf[64];
+    _snprintf_s( buf, _countof(buf), _TRUNCATE, "pb_%d_%08x_%d.ifg", key.trackId, key.configHash, key.carId );
+    return std::wstring(GhostDir) + L"\\" + toWide(buf);
+}
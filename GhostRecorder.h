@@ -0,0 +1,128 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "GhostLap.h"
+#include "CarTrackKey.h"
+
+// Records our own inputs against LapDistPct on every lap and keeps the fastest clean lap per
+// track, track config and car as a ghost for the Inputs overlay (ghosts\pb_*.ifg).
+// Samples go into buffers sized for a very long lap up front, so capturing never allocates. A lap
+// that beats the best is swapped out of the capture buffer and queued; one worker thread serializes
+// and writes it while the next lap is being captured. A lap that finishes while the stored best is
+// still loading, or while the previous best is being written, waits in the queue until then.
+// The best lap for the current key is loaded on the same worker, and is served from memory so the
+// file is never mapped while it may be replaced.
+
+class GhostRecorder
+{
+    public:
+
+        GhostRecorder();
+
+        // Call once per loop, after ir_tick().
+        void            update();
+
+        // Writes a pending best lap and stops the worker. Call before exit.
+        void            shutdown();
+
+        // Best lap for the current car/track; not open if there is none yet
+        const GhostLap& personalBest() const { return m_best; }
+
+        // Bumped whenever personalBest() changes
+        unsigned        generation() const { return m_generation; }
+
+    private:
+
+        using Key = CarTrackKey;
+
+        static constexpr size_t MaxLapSamples = 60 * 60 * 15;   // 15 minutes at 60 Hz
+
+        double          lineCrossingTime( float pct, double now ) const;
+
+        void            refreshKey();
+        void            startLoad();
+        void            finishLoad();
+        void            startSave();
+        void            finishSave();
+        void            onLapCompleted( float lapTime );
+        void            startWorker();
+        void            worker();
+        static std::wstring fileFor( const Key& key );
+
+        Key             m_key;
+        GhostLap        m_best;
+        float           m_bestTime = 0;
+        unsigned        m_generation = 0;
+
+        // Lap in progress
+        std::vector<GhostLap::Sample> m_capture;
+        int             m_subsessionId = -1;
+        int             m_prevLap = -1;
+        double          m_lapStartTime = 0;     // interpolated time we crossed the line
+        int             m_lapStartIncidents = 0;
+        float           m_prevPct = -1;
+        double          m_prevTime = 0;
+        double          m_lineTime = -1;        // last time LapDistPct wrapped, interpolated
+        bool            m_lapValid = false;     // false until we've seen a full lap from the line
+
+        // Best lap waiting for the stored best to load or the previous save to finish
+        std::vector<GhostLap::Sample> m_queued;
+        float               m_queuedTime = 0;
+        Key                 m_queuedKey;
+        bool                m_hasQueued = false;
+
+        // Main thread: waiting for load m_loadSeq / for the save of m_saveBuf
+        bool                m_loading = false;
+        bool                m_saving = false;
+
+        // Worker. m_saveBuf, m_saveTime and m_saveKey belong to the worker while m_saving is set;
+        // everything else below is guarded by m_mutex. A newer load supersedes an older one, whose
+        // result is dropped by sequence number.
+        std::thread             m_thread;
+        std::mutex              m_mutex;
+        std::condition_variable m_cv;           // work for the worker
+        std::condition_variable m_doneCv;       // work finished, for shutdown()
+        bool                    m_quit = false;
+        Key                     m_loadKey;
+        bool                    m_hasLoadJob = false;
+        unsigned                m_loadSeq = 0;
+        unsigned                m_loadedSeq = 0;
+        std::string             m_loaded;
+        bool                    m_hasSaveJob = false;
+        bool                    m_saveFinished = false;
+        std::string             m_saved;
+        std::vector<GhostLap::Sample> m_saveBuf;
+        float                   m_saveTime = 0;
+        Key                     m_saveKey;
+};
+
+extern GhostRecorder ir_ghost;
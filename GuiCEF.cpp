@@ -54,6 +54,7 @@ SOFTWARE.
 #include "include/wrapper/cef_message_router.h"
 #include "AppControl.h"
 #include "Config.h"
+#include "Tracer.h"
 #include "util.h"
 
 namespace {
@@ -277,6 +278,7 @@ namespace {
 			bool persistent,
 			CefRefPtr<CefMessageRouterBrowserSide::Callback> callback) override
 		{
+			TRACE_SCOPE("cef.query");
 			std::string req = request.ToString();
 			auto has = [&](const char* k){ return req.find(k) != std::string::npos; };
 			if (has("\"cmd\":\"getState\"")) {
@@ -567,6 +569,16 @@ namespace {
 				}
 				return true;
 			}
+			if (has("\"cmd\":\"dumpTrace\"")) {
+				app_dump_trace();
+				callback->Success(app_get_state_json());
+				return true;
+			}
+			if (has("\"cmd\":\"exportProfile\"")) {
+				app_export_profile_csv();
+				callback->Success(app_get_state_json());
+				return true;
+			}
 			if (has("\"cmd\":\"resetConfig\"")) {
 				// Remove config.json to reset to defaults, then reload and propagate
 				DeleteFileW(L"config.json");
@@ -0,0 +1,142 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+// Live iRating change estimate per car, following the "iRacing SOF iRating Calculator v1_1.xlsx"
+// spreadsheet logic (popularized via SIMRacingApps), which uses the "chance" function from
+// https://github.com/Turbo87/irating-rs rather than the classic base-10 / 400 Elo logistic.
+//
+// iRating is only won or lost against drivers of the same car class, so everything is per class.
+// A driver's expected score depends only on the iRatings in their class: it is computed once per
+// roster (O(n^2) per class, no exp() in the inner loop) and cached. The position-dependent part is
+// linear, so a position change only recomputes that car's delta. All live drivers count as starters.
+
+#include <math.h>
+#include "iracing.h"
+
+class IRatingPredictor
+{
+    public:
+
+        // Arrays indexed by carIdx. A car takes part when position > 0.
+        void update( const int* classId, const int* irating, const int* position )
+        {
+            bool rosterChanged = false;
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                const bool in = position[i] > 0;
+                if( in != m_in[i] || (in && (classId[i] != m_classId[i] || irating[i] != m_irating[i])) )
+                {
+                    rosterChanged = true;
+                    break;
+                }
+            }
+
+            if( rosterChanged )
+                rebuildExpectedScores( classId, irating, position );
+
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                if( !m_in[i] )
+                    m_delta[i] = 0;
+                else if( rosterChanged || position[i] != m_position[i] )
+                    m_delta[i] = linearDelta( i, position[i] );
+                m_position[i] = position[i];
+            }
+        }
+
+        int deltaFor( int carIdx ) const
+        {
+            return (carIdx >= 0 && carIdx < IR_MAX_CARS) ? m_delta[carIdx] : 0;
+        }
+
+        const int* deltas() const { return m_delta; }
+
+    private:
+
+        void rebuildExpectedScores( const int* classId, const int* irating, const int* position )
+        {
+            const float br1 = 1600.0f / logf( 2.0f );
+
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                m_in[i]      = position[i] > 0;
+                m_classId[i] = classId[i];
+                m_irating[i] = irating[i];
+                m_expIr[i]   = m_in[i] ? expf( -(float)irating[i] / br1 ) : 0.0f;
+            }
+
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                m_classSize[i] = 0;
+                m_expected[i]  = 0;
+                if( !m_in[i] )
+                    continue;
+
+                float sum = 0.0f;
+                int   n   = 0;
+                const float ea = m_expIr[i];
+                for( int j=0; j<IR_MAX_CARS; ++j )
+                {
+                    if( !m_in[j] || m_classId[j] != m_classId[i] )
+                        continue;
+                    ++n;
+                    sum += chance( ea, m_expIr[j] );
+                }
+                m_classSize[i] = n;
+                m_expected[i]  = sum - 0.5f;
+            }
+        }
+
+        // Port of the irating-rs chance function, taking exp(-iR/br1) of both drivers
+        static float chance( float ea, float eb )
+        {
+            const float numerator = (1.0f - ea) * eb;
+            const float denominator = (1.0f - eb) * ea + (1.0f - ea) * eb;
+            if( denominator <= 0.0f )
+                return 0.5f;
+            return numerator / denominator;
+        }
+
+        int linearDelta( int carIdx, int position ) const
+        {
+            const int n = m_classSize[carIdx];
+            if( n <= 1 )
+                return 0;
+
+            // Fudge factor per the spreadsheet implementation (no non-starters, so x = n)
+            const float fudge = ((float)n / 2.0f - (float)position) / 100.0f;
+            const float change = ((float)n - (float)position - m_expected[carIdx] - fudge) * 200.0f / (float)n;
+            return (int)lroundf( change );
+        }
+
+        bool    m_in[IR_MAX_CARS] = {};
+        int     m_classId[IR_MAX_CARS] = {};
+        int     m_irating[IR_MAX_CARS] = {};
+        int     m_position[IR_MAX_CARS] = {};
+        int     m_classSize[IR_MAX_CARS] = {};
+        float   m_expIr[IR_MAX_CARS] = {};
+        float   m_expected[IR_MAX_CARS] = {};
+        int     m_delta[IR_MAX_CARS] = {};
+};
@@ -0,0 +1,323 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Shared image assets (icons, wheel images, ...).
+// Each asset is resolved and decoded to premultiplied BGRA once, on a background thread, and turned
+// into one D2D bitmap per D2D device on first use. Overlays hold ImageAssets::Ref handles; the GPU
+// bitmaps are dropped once the last handle to an asset goes away. Decoded pixels stay around so
+// re-enabling an overlay is instant.
+// Acquiring never blocks on disk or PNG decode: until the worker has finished an image, Ref::Get()
+// returns nullptr and callers simply skip drawing it.
+// Refs don't remember a render target: overlays recreate theirs on move/resize, so Get() takes the
+// current one and the bitmap is looked up for that target's device. The device behind each target is
+// looked up once; overlays call forgetTarget() before dropping a target.
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <stdint.h>
+#include <d2d1_3.h>
+#include <wincodec.h>
+#include <wrl.h>
+#include "util.h"
+#include "Logger.h"
+#include "Tracer.h"
+
+class ImageAssets
+{
+    private:
+        struct Entry;
+
+    public:
+
+        // Handle to a shared image. Keeps the decoded asset (and its GPU bitmaps) alive.
+        class Ref
+        {
+            public:
+
+                Ref() = default;
+                Ref( const Ref& o ) : m_entry(o.m_entry) { if( m_entry ) m_entry->refs++; }
+                Ref& operator=( const Ref& o ) { if( this != &o ) { Reset(); m_entry = o.m_entry; if( m_entry ) m_entry->refs++; } return *this; }
+                ~Ref() { Reset(); }
+
+                // Bitmap usable on 'rt', or nullptr if the image isn't decoded (yet). Don't hold on to
+                // the result past the frame: it belongs to rt's device.
+                ID2D1Bitmap* Get( ID2D1RenderTarget* rt ) const
+                {
+                    if( !m_entry || !rt )
+                        return nullptr;
+                    return ImageAssets::instance().bitmapFor( *m_entry, rt );
+                }
+
+                void Reset()
+                {
+                    if( m_entry )
+                        ImageAssets::instance().release( *m_entry );
+                    m_entry = nullptr;
+                }
+
+            private:
+
+                friend class ImageAssets;
+                explicit Ref( Entry* e ) : m_entry(e) { if( m_entry ) m_entry->refs++; }
+
+                Entry*  m_entry = nullptr;
+        };
+
+        static ImageAssets& instance()
+        {
+            static ImageAssets s_instance;
+            return s_instance;
+        }
+
+        // Queue assets (paths relative to the asset root) for background decoding.
+        void prefetch( const std::vector<std::wstring>& relPaths )
+        {
+            for( const std::wstring& rel : relPaths )
+                findOrQueue( rel );
+        }
+
+        // Main thread only.
+        Ref acquire( const std::wstring& relPath )
+        {
+            return Ref( findOrQueue(relPath) );
+        }
+
+        // Drop all GPU bitmaps, e.g. when the shared D2D device goes away. Handles re-create them on demand.
+        void releaseDeviceResources()
+        {
+            for( auto& e : m_entries )
+                e->bitmaps.clear();
+            m_targetDevices.clear();
+        }
+
+        // Key for the D2D device 'rt' draws with, so resources can be shared by all targets on it.
+        // Targets without a device context are their own key. Main thread only.
+        const void* deviceKey( ID2D1RenderTarget* rt )
+        {
+            for( const TargetDevice& td : m_targetDevices )
+                if( td.target == rt )
+                    return td.device;
+
+            const void* key = rt;
+            Microsoft::WRL::ComPtr<ID2D1DeviceContext> dc;
+            if( SUCCEEDED(rt->QueryInterface(IID_PPV_ARGS(&dc))) )
+            {
+                Microsoft::WRL::ComPtr<ID2D1Device> device;
+                dc->GetDevice( &device );
+                if( device )
+                    key = device.Get();
+            }
+            m_targetDevices.push_back( { rt, key } );
+            return key;
+        }
+
+        // Call before releasing a render target, so a later target at the same address isn't mistaken
+        // for it. Bitmaps keyed on the target itself go with it.
+        void forgetTarget( ID2D1RenderTarget* rt )
+        {
+            for( size_t i=0; i<m_targetDevices.size(); ++i )
+            {
+                if( m_targetDevices[i].target != rt )
+                    continue;
+                if( m_targetDevices[i].device == rt )
+                {
+                    for( auto& e : m_entries )
+                        std::erase_if( e->bitmaps, [rt]( const auto& b ){ return b.first == rt; } );
+                }
+                m_targetDevices.erase( m_targetDevices.begin() + i );
+                break;
+            }
+        }
+
+        void shutdown()
+        {
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_stop = true;
+                m_queue.clear();
+            }
+            m_cv.notify_all();
+            if( m_worker.joinable() )
+                m_worker.join();
+            releaseDeviceResources();
+        }
+
+    private:
+
+        enum class State { Queued, Ready, Failed };
+
+        struct Entry
+        {
+            std::wstring            relPath;
+            State                   state = State::Queued;  // guarded by m_mutex
+            UINT                    width = 0;              // width/height/pixels are written by the worker
+            UINT                    height = 0;             // before state becomes Ready, read-only after
+            std::vector<uint32_t>   pixels;
+
+            // Main thread only
+            int                     refs = 0;
+            // Per deviceKey(). A bitmap keeps its device alive, so the key can't be reused by another device.
+            std::vector<std::pair<const void*,Microsoft::WRL::ComPtr<ID2D1Bitmap>>> bitmaps;
+        };
+
+        struct TargetDevice
+        {
+            ID2D1RenderTarget*  target;
+            const void*         device;
+        };
+
+        ImageAssets() = default;
+        ~ImageAssets() { shutdown(); }
+        ImageAssets( const ImageAssets& ) = delete;
+        ImageAssets& operator=( const ImageAssets& ) = delete;
+
+        Entry* findOrQueue( const std::wstring& relPath )
+        {
+            for( auto& e : m_entries )
+                if( e->relPath == relPath )
+                    return e.get();
+
+            m_entries.push_back( std::make_unique<Entry>() );
+            Entry* e = m_entries.back().get();
+            e->relPath = relPath;
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                if( m_stop )
+                {
+                    e->state = State::Failed;
+                    return e;
+                }
+                m_queue.push_back( e );
+                if( !m_worker.joinable() )
+                    m_worker = std::thread( &ImageAssets::workerMain, this );
+            }
+            m_cv.notify_one();
+            return e;
+        }
+
+        void release( Entry& e )
+        {
+            if( --e.refs == 0 )
+                e.bitmaps.clear();
+        }
+
+        ID2D1Bitmap* bitmapFor( Entry& e, ID2D1RenderTarget* rt )
+        {
+            // Bitmaps can be shared by every render target on the same D2D device, so a recreated
+            // target finds the existing bitmap.
+            const void* key = deviceKey( rt );
+            for( auto& [k, bmp] : e.bitmaps )
+                if( k == key )
+                    return bmp.Get();
+
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                if( e.state != State::Ready )
+                    return nullptr;
+            }
+
+            Microsoft::WRL::ComPtr<ID2D1Bitmap> bmp;
+            const D2D1_BITMAP_PROPERTIES props = D2D1::BitmapProperties( D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED) );
+            if( FAILED(rt->CreateBitmap(D2D1::SizeU(e.width, e.height), e.pixels.data(), e.width * sizeof(uint32_t), &props, &bmp)) )
+                return nullptr;
+            e.bitmaps.emplace_back( key, bmp );
+            return bmp.Get();
+        }
+
+        void workerMain()
+        {
+            Tracer::setThreadName( "image-assets" );
+            (void)CoInitializeEx( nullptr, COINIT_MULTITHREADED );
+            Microsoft::WRL::ComPtr<IWICImagingFactory> wic;
+            if( FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wic))) )
+                Logger::instance().logError( "ImageAssets: failed to create WIC factory" );
+
+            for( ;; )
+            {
+                Entry* e = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock( m_mutex );
+                    m_cv.wait( lock, [this]{ return m_stop || !m_queue.empty(); } );
+                    if( m_stop )
+                        break;
+                    e = m_queue.front();
+                    m_queue.pop_front();
+                }
+
+                bool ok = false;
+                {
+                    TRACE_SCOPE( "image.decode" );
+                    ok = wic && decode( wic.Get(), resolveAssetPathW(e->relPath), *e );
+                }
+                if( !ok )
+                    Logger::instance().log( LogLevel::Warning, L"ImageAssets: failed to load " + e->relPath );
+
+                std::lock_guard<std::mutex> lock( m_mutex );
+                e->state = ok ? State::Ready : State::Failed;
+            }
+
+            wic.Reset();
+            CoUninitialize();
+        }
+
+        static bool decode( IWICImagingFactory* wic, const std::wstring& path, Entry& e )
+        {
+            Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+            Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+            Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+            if( FAILED(wic->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder)) )
+                return false;
+            if( FAILED(decoder->GetFrame(0, &frame)) )
+                return false;
+            if( FAILED(wic->CreateFormatConverter(&converter)) )
+                return false;
+            if( FAILED(converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut)) )
+                return false;
+
+            UINT w = 0, h = 0;
+            if( FAILED(converter->GetSize(&w, &h)) || !w || !h )
+                return false;
+            e.pixels.assign( (size_t)w * h, 0 );
+            if( FAILED(converter->CopyPixels(nullptr, w * sizeof(uint32_t), (UINT)(e.pixels.size() * sizeof(uint32_t)), (BYTE*)e.pixels.data())) )
+                return false;
+            e.width = w;
+            e.height = h;
+            return true;
+        }
+
+        std::vector<std::unique_ptr<Entry>> m_entries;  // main thread only; entries are never removed
+        std::vector<TargetDevice>           m_targetDevices;    // main thread only
+        std::mutex                          m_mutex;
+        std::condition_variable             m_cv;
+        std::deque<Entry*>                  m_queue;
+        std::thread                         m_worker;
+        bool                                m_stop = false;
+};
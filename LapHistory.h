@@ -0,0 +1,276 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Per-car lap history for the whole field, filled from telemetry when CarIdxLapCompleted ticks over.
+// Each car has a fixed ring of the most recent laps, stored struct-of-arrays so queries only touch
+// the columns they need. Alongside every lap we keep running totals of the "clean" laps (no pit
+// road, caution or invalid time), which turns averages and deviations over the last N laps or the
+// current stint into two lookups instead of a walk over the ring. Best laps are kept in a short
+// sorted list per car.
+//
+// A stint starts when a car leaves pit road; the out-lap belongs to the new stint, the in-lap to
+// the old one.
+
+#include <stdint.h>
+#include <math.h>
+#include <algorithm>
+#include "iracing.h"
+
+class LapHistory
+{
+    public:
+
+        static constexpr int Capacity = 64;     // laps kept per car, power of two
+        static constexpr int BestKeep = 5;      // best clean laps kept per car
+
+        enum LapFlags : uint8_t
+        {
+            LapPit      = 1 << 0,   // touched pit road during the lap
+            LapCaution  = 1 << 1,   // caution, pace or pre-green at some point during the lap
+            LapInvalid  = 1 << 2,   // no usable lap time was reported
+        };
+
+        LapHistory()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            for( int i=0; i<IR_MAX_CARS; ++i )
+                resetCar( i );
+            m_sessionNum = -1;
+        }
+
+        // Arrays indexed by carIdx. Call once per sim tick.
+        void update( int sessionNum, bool underCaution, const int* lapCompleted, const float* lastLapTime, const bool* onPitRoad, const int* compound )
+        {
+            if( sessionNum != m_sessionNum )
+            {
+                reset();
+                m_sessionNum = sessionNum;
+            }
+
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                if( lapCompleted[i] < 0 )
+                    continue;           // not in the world right now
+                if( lapCompleted[i] < m_lapCompleted[i] )
+                    resetCar( i );      // e.g. a different driver took over the slot
+
+                // Stint boundary on pit exit
+                if( m_wasOnPitRoad[i] && !onPitRoad[i] )
+                {
+                    m_stint[i]++;
+                    m_stintStart[i] = m_count[i];
+                }
+                m_wasOnPitRoad[i] = onPitRoad[i];
+
+                if( onPitRoad[i] )
+                    m_curFlags[i] |= LapPit;
+                if( underCaution )
+                    m_curFlags[i] |= LapCaution;
+
+                if( lapCompleted[i] > m_lapCompleted[i] )
+                {
+                    // CarIdxLastLapTime can trail the lap counter by a few ticks, so hold the lap
+                    // until the time changes or we give up on it.
+                    if( m_lapCompleted[i] >= 0 && m_pendingTicks[i] < 0 )
+                    {
+                        m_pendingTicks[i] = 0;
+                        m_pendingFlags[i] = m_curFlags[i];
+                        m_pendingStint[i] = m_stint[i];
+                        m_curFlags[i] = onPitRoad[i] ? LapPit : 0;
+                    }
+                    m_lapCompleted[i] = lapCompleted[i];
+                }
+
+                if( m_pendingTicks[i] >= 0 )
+                {
+                    const float t = lastLapTime[i];
+                    const bool  fresh = t > 0 && t != m_lastRawTime[i];
+                    if( fresh || ++m_pendingTicks[i] > PendingTimeoutTicks )
+                    {
+                        push( i, fresh ? t : 0.0f, fresh ? m_pendingFlags[i] : (uint8_t)(m_pendingFlags[i] | LapInvalid), compound[i], m_pendingStint[i] );
+                        if( fresh )
+                            m_lastRawTime[i] = t;
+                        m_pendingTicks[i] = -1;
+                    }
+                }
+            }
+        }
+
+        // Laps recorded this session, and how many of them are still in the ring
+        int     count( int carIdx ) const       { return valid(carIdx) ? m_count[carIdx] : 0; }
+        int     available( int carIdx ) const   { return std::min( count(carIdx), Capacity ); }
+        int     currentStint( int carIdx ) const { return valid(carIdx) ? m_stint[carIdx] : 0; }
+        int     lapsInStint( int carIdx ) const { return valid(carIdx) ? m_count[carIdx] - m_stintStart[carIdx] : 0; }
+
+        // Individual laps, back=0 is the most recent. Check against available() first.
+        float   lapTime( int carIdx, int back ) const   { return m_time[carIdx][slot(carIdx,back)]; }
+        uint8_t lapFlags( int carIdx, int back ) const  { return m_flags[carIdx][slot(carIdx,back)]; }
+        int     lapCompound( int carIdx, int back ) const { return m_compound[carIdx][slot(carIdx,back)]; }
+        int     lapStint( int carIdx, int back ) const  { return m_lapStint[carIdx][slot(carIdx,back)]; }
+
+        // Mean of the clean laps among the last n recorded laps (n < Capacity). 0 if there are none.
+        float average( int carIdx, int n ) const
+        {
+            double sum, sumSq;
+            const int cnt = window( carIdx, n, sum, sumSq );
+            return cnt ? (float)(sum / cnt) : 0.0f;
+        }
+
+        // Standard deviation of the clean laps among the last n recorded laps. 0 with fewer than two.
+        float stdDev( int carIdx, int n ) const
+        {
+            double sum, sumSq;
+            const int cnt = window( carIdx, n, sum, sumSq );
+            if( cnt < 2 )
+                return 0.0f;
+            const double mean = sum / cnt;
+            return (float)sqrt( std::max( 0.0, sumSq / cnt - mean * mean ) );
+        }
+
+        // Mean of the clean laps in the current stint (as far back as the ring reaches)
+        float stintAverage( int carIdx ) const
+        {
+            return average( carIdx, lapsInStint(carIdx) );
+        }
+
+        // Mean of the n best clean laps this session (n <= BestKeep). 0 if there are fewer than n.
+        float bestN( int carIdx, int n ) const
+        {
+            if( !valid(carIdx) || n <= 0 || n > BestKeep || m_numBest[carIdx] < n )
+                return 0.0f;
+            float sum = 0;
+            for( int k=0; k<n; ++k )
+                sum += m_best[carIdx][k];
+            return sum / n;
+        }
+
+    private:
+
+        static constexpr int    PendingTimeoutTicks = 120;  // ~2s at 60Hz
+        static constexpr uint8_t DirtyMask = LapPit | LapCaution | LapInvalid;
+
+        static bool valid( int carIdx ) { return carIdx >= 0 && carIdx < IR_MAX_CARS; }
+
+        int slot( int carIdx, int back ) const
+        {
+            return (m_count[carIdx] - 1 - back) & (Capacity - 1);
+        }
+
+        void resetCar( int carIdx )
+        {
+            m_count[carIdx]        = 0;
+            m_stint[carIdx]        = 0;
+            m_stintStart[carIdx]   = 0;
+            m_numBest[carIdx]      = 0;
+            m_curFlags[carIdx]     = 0;
+            m_pendingTicks[carIdx] = -1;
+            m_lastRawTime[carIdx]  = 0;
+            m_lapCompleted[carIdx] = -1;
+            m_wasOnPitRoad[carIdx] = false;
+        }
+
+        void push( int carIdx, float time, uint8_t flags, int compound, int stint )
+        {
+            const int  prev  = m_count[carIdx] > 0 ? slot( carIdx, 0 ) : -1;
+            const int  s     = m_count[carIdx] & (Capacity - 1);
+            const bool clean = !(flags & DirtyMask);
+
+            m_time[carIdx][s]     = time;
+            m_flags[carIdx][s]    = flags;
+            m_compound[carIdx][s] = (int8_t)compound;
+            m_lapStint[carIdx][s] = (uint16_t)stint;
+            m_cumTime[carIdx][s]  = (prev >= 0 ? m_cumTime[carIdx][prev] : 0.0) + (clean ? time : 0.0);
+            m_cumSq[carIdx][s]    = (prev >= 0 ? m_cumSq[carIdx][prev] : 0.0) + (clean ? (double)time * time : 0.0);
+            m_cumClean[carIdx][s] = (prev >= 0 ? m_cumClean[carIdx][prev] : 0) + (clean ? 1 : 0);
+            m_count[carIdx]++;
+
+            if( clean )
+            {
+                // Insert into the short sorted best list
+                float* best = m_best[carIdx];
+                int&   nb   = m_numBest[carIdx];
+                int k = std::min( nb, BestKeep - 1 );
+                if( nb < BestKeep || time < best[k] )
+                {
+                    while( k > 0 && best[k-1] > time ) {
+                        best[k] = best[k-1];
+                        --k;
+                    }
+                    best[k] = time;
+                    nb = std::min( nb + 1, BestKeep );
+                }
+            }
+        }
+
+        // Sums over the clean laps among the last n laps, from the running totals
+        int window( int carIdx, int n, double& sum, double& sumSq ) const
+        {
+            sum = sumSq = 0;
+            if( !valid(carIdx) || n <= 0 || m_count[carIdx] == 0 )
+                return 0;
+            n = std::min( { n, m_count[carIdx], Capacity - 1 } );
+            const int end = slot( carIdx, 0 );
+            sum   = m_cumTime[carIdx][end];
+            sumSq = m_cumSq[carIdx][end];
+            int cnt = m_cumClean[carIdx][end];
+            if( n < m_count[carIdx] )
+            {
+                const int start = slot( carIdx, n );
+                sum   -= m_cumTime[carIdx][start];
+                sumSq -= m_cumSq[carIdx][start];
+                cnt   -= m_cumClean[carIdx][start];
+            }
+            return cnt;
+        }
+
+        // Ring columns
+        float       m_time[IR_MAX_CARS][Capacity] = {};
+        uint8_t     m_flags[IR_MAX_CARS][Capacity] = {};
+        int8_t      m_compound[IR_MAX_CARS][Capacity] = {};
+        uint16_t    m_lapStint[IR_MAX_CARS][Capacity] = {};
+        double      m_cumTime[IR_MAX_CARS][Capacity] = {};     // running totals over clean laps, up to and including this lap
+        double      m_cumSq[IR_MAX_CARS][Capacity] = {};
+        int         m_cumClean[IR_MAX_CARS][Capacity] = {};
+
+        // Per-car state
+        int         m_count[IR_MAX_CARS] = {};
+        int         m_stint[IR_MAX_CARS] = {};
+        int         m_stintStart[IR_MAX_CARS] = {};         // m_count at the start of the current stint
+        float       m_best[IR_MAX_CARS][BestKeep] = {};
+        int         m_numBest[IR_MAX_CARS] = {};
+        uint8_t     m_curFlags[IR_MAX_CARS] = {};           // accumulated over the lap in progress
+        uint8_t     m_pendingFlags[IR_MAX_CARS] = {};
+        int         m_pendingStint[IR_MAX_CARS] = {};
+        int         m_pendingTicks[IR_MAX_CARS] = {};       // -1 when no lap is waiting for its time
+        float       m_lastRawTime[IR_MAX_CARS] = {};
+        int         m_lapCompleted[IR_MAX_CARS] = {};
+        bool        m_wasOnPitRoad[IR_MAX_CARS] = {};
+        int         m_sessionNum = -1;
+};
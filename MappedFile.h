@@ -0,0 +1,96 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Read-only view of a whole file, for binary assets that are used in place instead of being
+// parsed into copies. The file stays open (shared for reading and deleting) while mapped.
+
+#include <windows.h>
+#include <string>
+
+class MappedFile
+{
+    public:
+
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+        MappedFile( const MappedFile& ) = delete;
+        MappedFile& operator=( const MappedFile& ) = delete;
+
+        bool open( const std::wstring& path )
+        {
+            close();
+
+            m_file = CreateFileW( path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+            if( m_file == INVALID_HANDLE_VALUE )
+            {
+                m_file = nullptr;
+                return false;
+            }
+
+            LARGE_INTEGER size = {};
+            if( !GetFileSizeEx( m_file, &size ) || size.QuadPart <= 0 )
+            {
+                close();
+                return false;
+            }
+
+            m_mapping = CreateFileMappingW( m_file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+            if( m_mapping )
+                m_view = MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 );
+            if( !m_view )
+            {
+                close();
+                return false;
+            }
+            m_size = (size_t)size.QuadPart;
+            return true;
+        }
+
+        void close()
+        {
+            if( m_view )
+                UnmapViewOfFile( m_view );
+            if( m_mapping )
+                CloseHandle( m_mapping );
+            if( m_file )
+                CloseHandle( m_file );
+            m_view = nullptr;
+            m_mapping = nullptr;
+            m_file = nullptr;
+            m_size = 0;
+        }
+
+        bool        isOpen() const { return m_view != nullptr; }
+        const char* data() const { return (const char*)m_view; }
+        size_t      size() const { return m_size; }
+
+    private:
+
+        HANDLE      m_file = nullptr;
+        HANDLE      m_mapping = nullptr;
+        const void* m_view = nullptr;
+        size_t      m_size = 0;
+};
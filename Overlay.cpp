@@ -28,12 +28,26 @@ SOFTWARE.
 #include "Overlay.h"
 #include "Config.h"
 #include "Logger.h"
+#include "iracing.h"
+#include "RaceState.h"
+#include "preview_mode.h"
+#include "StyleBrushes.h"
+#include "ImageAssets.h"
+#include "CarBrandIcons.h"
 #include <string>
+#include <cmath>
 
 using namespace Microsoft::WRL;
 
 static const int ResizeBorderWidth = 25;
 
+// All overlays are created and drawn on the main thread, so they share one D3D device and one
+// single-threaded D2D factory. That way device-dependent D2D resources (see StyleBrushes.h) can
+// be created once and used by every overlay.
+static ComPtr<ID3D11Device>     s_sharedD3dDevice;
+static ComPtr<ID2D1Factory2>    s_sharedD2dFactory;
+static int                      s_sharedDeviceUsers = 0;
+
 static LRESULT CALLBACK windowProc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam )
 {
     Overlay* o = (Overlay*)GetWindowLongPtr( hwnd, GWLP_USERDATA );
@@ -103,7 +117,12 @@ static LRESULT CALLBACK windowProc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM l
 
 Overlay::Overlay( const std::string name )
     : m_name( name )
-{}
+{
+    m_profUpdate  = Profiler::instance().zone( m_name + ".update" );
+    m_profDraw    = Profiler::instance().zone( m_name + ".draw" );
+    m_profPresent = Profiler::instance().zone( m_name + ".present" );
+    m_traceName   = Tracer::intern( m_name );
+}
 
 Overlay::~Overlay()
 {
@@ -115,6 +134,11 @@ std::string Overlay::getName() const
     return m_name;
 }
 
+bool Overlay::isEnabledInConfig() const
+{
+    return g_cfg.getBool( m_name, "enabled", true );
+}
+
 void Overlay::enable( bool on )
 {
     if( on && !m_hwnd )
@@ -151,8 +175,10 @@ void Overlay::enable( bool on )
         const bool isdebug = false;
 #endif
 
-        // D3D11 device
-        HRCHECK(D3D11CreateDevice( NULL, D3D_DRIVER_TYPE_HARDWARE, NULL, D3D11_CREATE_DEVICE_SINGLETHREADED | D3D11_CREATE_DEVICE_BGRA_SUPPORT, NULL, 0, D3D11_SDK_VERSION, &m_d3dDevice, NULL, NULL ));
+        // D3D11 device (shared)
+        if( !s_sharedD3dDevice )
+            HRCHECK(D3D11CreateDevice( NULL, D3D_DRIVER_TYPE_HARDWARE, NULL, D3D11_CREATE_DEVICE_SINGLETHREADED | D3D11_CREATE_DEVICE_BGRA_SUPPORT, NULL, 0, D3D11_SDK_VERSION, &s_sharedD3dDevice, NULL, NULL ));
+        m_d3dDevice = s_sharedD3dDevice;
 
         // DXGI device
         ComPtr<IDXGIDevice> dxgiDevice;
@@ -179,10 +205,15 @@ void Overlay::enable( bool on )
         ComPtr<IDXGISurface2> dxgiSurface;
         HRCHECK(m_swapChain->GetBuffer( 0, IID_PPV_ARGS(&dxgiSurface) ));
 
-        // D2D factory
-        D2D1_FACTORY_OPTIONS factoryOptions = {};
-        factoryOptions.debugLevel = isdebug ? D2D1_DEBUG_LEVEL_INFORMATION : D2D1_DEBUG_LEVEL_NONE;
-        HRCHECK(D2D1CreateFactory( D2D1_FACTORY_TYPE_SINGLE_THREADED, __uuidof(m_d2dFactory), &factoryOptions, &m_d2dFactory ));
+        // D2D factory (shared)
+        if( !s_sharedD2dFactory )
+        {
+            D2D1_FACTORY_OPTIONS factoryOptions = {};
+            factoryOptions.debugLevel = isdebug ? D2D1_DEBUG_LEVEL_INFORMATION : D2D1_DEBUG_LEVEL_NONE;
+            HRCHECK(D2D1CreateFactory( D2D1_FACTORY_TYPE_SINGLE_THREADED, __uuidof(s_sharedD2dFactory), &factoryOptions, &s_sharedD2dFactory ));
+        }
+        m_d2dFactory = s_sharedD2dFactory;
+        s_sharedDeviceUsers++;
 
         // D2D render target
         D2D1_RENDER_TARGET_PROPERTIES targetProperties = {};
@@ -205,6 +236,8 @@ void Overlay::enable( bool on )
         // Default brush
         HRCHECK(m_renderTarget->CreateSolidColorBrush( float4(0,0,0,1), &m_brush ));
 
+        m_dlRenderer.setTarget( m_renderTarget.Get(), m_dwriteFactory.Get() );
+
         //
         // Finalize enable
         //
@@ -217,15 +250,30 @@ void Overlay::enable( bool on )
     {
         onDisable();
 
+        m_dlRenderer.clearResources();
+        m_dlRenderer.setTarget( nullptr, nullptr );
+        m_displayList.clear();
+        m_prevDisplayList.clear();
+
         m_dwriteFactory.Reset();
         m_compositionVisual.Reset();
         m_compositionTarget.Reset();
         m_compositionDevice.Reset();
-        m_renderTarget.Reset();
+        releaseRenderTarget();
         m_d2dFactory.Reset();
         m_swapChain.Reset();
         m_d3dDevice.Reset();
 
+        // Last overlay gone: release the shared device and everything created on it
+        if( --s_sharedDeviceUsers == 0 )
+        {
+            StyleBrushes::releaseAll();
+            ImageAssets::instance().releaseDeviceResources();
+            CarBrandIcons::instance().releaseDeviceResources();
+            s_sharedD2dFactory.Reset();
+            s_sharedD3dDevice.Reset();
+        }
+
         DestroyWindow( m_hwnd );
         m_hwnd = 0;
         m_enabled = false;
@@ -240,6 +288,7 @@ bool Overlay::isEnabled() const
 void Overlay::enableUiEdit( bool on )
 {
     m_uiEditEnabled = on;
+    requestRedraw();
     update();
 }
 
@@ -294,12 +343,32 @@ void Overlay::update()
     m_lastUpdateTick = now;
     if( m_staticMode && !m_forceNextUpdate )
         return;
+
+    TRACE_SCOPE( m_traceName );
+
+    // Retained mode: nothing we declared as an input changed, so the last presented frame is
+    // still correct. A slow idle refresh guards against inputs an overlay forgot to declare.
+    const bool inputsChanged = redrawInputsChanged();
+    if( m_trackRedrawInputs && !inputsChanged && !m_forceNextUpdate && !m_uiEditEnabled && !preview_mode_get() )
+    {
+        const DWORD idleMs = (DWORD)std::max( 0, g_cfg.getInt(m_name, "idle_refresh_ms", 1000) );
+        if( idleMs == 0 || (now - m_lastRedrawTick) < idleMs )
+            return;
+    }
+    const bool forced = m_forceNextUpdate;
     m_forceNextUpdate = false;
+    m_lastRedrawTick = now;
 
     const float w = (float)m_width;
     const float h = (float)m_height;
     const float cornerRadius = g_cfg.getFloat( m_name, "corner_radius", m_name=="OverlayInputs"?2.0f:6.0f );
 
+    if( usesDisplayList() )
+    {
+        drawDisplayList( forced, cornerRadius );
+        return;
+    }
+
     // Clear/draw background
     if( !hasCustomBackground() )
     {
@@ -321,7 +390,10 @@ void Overlay::update()
     }
 
     // Overlay-specific logic and rendering
-    onUpdate();
+    {
+        ProfileScope prof( m_profUpdate );
+        onUpdate();
+    }
 
     if( m_uiEditEnabled )
     {
@@ -338,7 +410,55 @@ void Overlay::update()
         m_renderTarget->EndDraw();
     }
 
+    ProfileScope prof( m_profPresent );
+    HRCHECK(m_swapChain->Present( 1, 0 ));
+}
+
+void Overlay::drawDisplayList( bool forced, float cornerRadius )
+{
+    const float w = (float)m_width;
+    const float h = (float)m_height;
+    const DlRect frame( 0.5f, 0.5f, w-0.5f, h-0.5f );
+
+    DisplayList& dl = m_displayList;
+    dl.clear();
+    dl.clearTarget( DlColor(0,0,0,0) );
+
+    if( !hasCustomBackground() )
+    {
+        float4 bgColor = g_cfg.getFloat4( m_name, "global_background_col", float4(0,0,0,1.0f) );
+        bgColor.w *= getGlobalOpacity();
+        dl.fillRoundedRect( frame, cornerRadius, toDlColor(bgColor) );
+    }
+
+    {
+        ProfileScope prof( m_profUpdate );
+        onDisplayList( dl );
+    }
+
+    if( m_uiEditEnabled )
+    {
+        const DlColor c( 1, 1, 1, 0.7f );
+        dl.drawRoundedRect( frame, cornerRadius, c, 2 );
+        dl.line( w-0.5f, h-0.5f-ResizeBorderWidth, w-0.5f-ResizeBorderWidth, h-0.5f-ResizeBorderWidth, c, 2 );
+        dl.line( w-0.5f-ResizeBorderWidth, h-0.5f, w-0.5f-ResizeBorderWidth, h-0.5f-ResizeBorderWidth, c, 2 );
+    }
+
+    // Same commands as what's already on screen: no need to touch the GPU at all
+    if( !forced && dl.sameAs(m_prevDisplayList) )
+        return;
+
+    {
+        ProfileScope prof( m_profDraw );
+        m_renderTarget->BeginDraw();
+        m_dlRenderer.replay( dl );
+        m_renderTarget->EndDraw();
+    }
+
+    ProfileScope prof( m_profPresent );
     HRCHECK(m_swapChain->Present( 1, 0 ));
+
+    m_prevDisplayList.swap( m_displayList );
 }
 
 void Overlay::setWindowPosAndSize( int x, int y, int w, int h, bool callSetWindowPos )
@@ -354,7 +474,7 @@ void Overlay::setWindowPosAndSize( int x, int y, int w, int h, bool callSetWindo
     m_width = w;
     m_height = h;
 
-    m_renderTarget.Reset(); 
+    releaseRenderTarget();
 
     HRCHECK(m_swapChain->ResizeBuffers( 0, w, h, DXGI_FORMAT_UNKNOWN, 0 ));
 
@@ -366,6 +486,18 @@ void Overlay::setWindowPosAndSize( int x, int y, int w, int h, bool callSetWindo
     targetProperties.pixelFormat.format = DXGI_FORMAT_UNKNOWN;
     targetProperties.pixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
     HRCHECK(m_d2dFactory->CreateDxgiSurfaceRenderTarget( dxgiSurface.Get(), &targetProperties, &m_renderTarget ));
+    m_dlRenderer.setTarget( m_renderTarget.Get(), m_dwriteFactory.Get() );
+
+    // Buffer contents are gone after ResizeBuffers
+    requestRedraw();
+}
+
+// Shared image caches look up the device behind a target once and remember it by address
+void Overlay::releaseRenderTarget()
+{
+    ImageAssets::instance().forgetTarget( m_renderTarget.Get() );
+    CarBrandIcons::instance().forgetTarget( m_renderTarget.Get() );
+    m_renderTarget.Reset();
 }
 
 void Overlay::saveWindowPosAndSize()
@@ -459,6 +591,8 @@ void Overlay::onConfigChanged() {}
 void Overlay::onSessionChanged() {}
 float2 Overlay::getDefaultSize() { return float2(400,300); }
 bool Overlay::hasCustomBackground() { return false; }
+bool Overlay::usesDisplayList() const { return false; }
+void Overlay::onDisplayList( DisplayList& /*dl*/ ) {}
 
 void Overlay::onMouseWheel( int /*delta*/, int /*x*/, int /*y*/ ) {}
 
@@ -540,6 +674,28 @@ void Overlay::createGlobalTextFormat( float scale,
     outFormat->SetWordWrapping( DWRITE_WORD_WRAPPING_NO_WRAP );
 }
 
+void Overlay::drawSectorStrip( float left, float right, float y, float height, int carIdx, bool preview )
+{
+    const SectorTiming& st = ir_race.sectors;
+    const int n = preview ? 3 : st.numSectors();
+    if( n <= 0 || carIdx < 0 || carIdx >= IR_MAX_CARS || right <= left )
+        return;
+
+    const float opacity = getGlobalOpacity();
+    const float gap = 2.0f;
+    const float w = (right - left - gap * (n - 1)) / n;
+    for( int s=0; s<n; ++s )
+    {
+        const SectorTiming::State state = preview ? (SectorTiming::State)((carIdx + s) % 4) : st.state( carIdx, s );
+        float4 col = SectorTiming::stateColor( state, float4(1, 1, 1, 0.15f) );
+        col.a *= opacity;
+        const float x0 = left + s * (w + gap);
+        D2D1_RECT_F r = { x0, y - height / 2, x0 + w, y + height / 2 };
+        m_brush->SetColor( col );
+        m_renderTarget->FillRectangle( &r, m_brush.Get() );
+    }
+}
+
 void Overlay::setTargetFPS( int fps )
 {
     m_targetFPS = std::max(10, fps);
@@ -560,3 +716,63 @@ bool Overlay::isStaticMode() const
     return m_staticMode;
 }
 
+void Overlay::clearRedrawDependencies()
+{
+    m_redrawVars.clear();
+    m_redrawCfgKeys.clear();
+    m_trackRedrawInputs = false;
+    m_haveInputFingerprint = false;
+}
+
+void Overlay::addRedrawDependency( irsdkCVar& var, double quantum )
+{
+    m_redrawVars.push_back( { &var, quantum } );
+    m_trackRedrawInputs = true;
+    m_haveInputFingerprint = false;
+}
+
+void Overlay::addRedrawConfigKey( const std::string& key )
+{
+    m_redrawCfgKeys.push_back( key );
+    m_trackRedrawInputs = true;
+    m_haveInputFingerprint = false;
+}
+
+bool Overlay::redrawInputsChanged()
+{
+    if( !m_trackRedrawInputs )
+        return true;
+
+    // Config values only need re-hashing when something was actually loaded or set
+    const unsigned cfgGen = g_cfg.getGeneration();
+    if( !m_haveInputFingerprint || cfgGen != m_cfgGeneration )
+    {
+        unsigned h = 0x5eed;
+        for( const std::string& key : m_redrawCfgKeys )
+        {
+            const unsigned v = g_cfg.hashValue( m_name, key );
+            h = MurmurHash2( &v, sizeof(v), h );
+        }
+        m_cfgFingerprint = h;
+        m_cfgGeneration = cfgGen;
+    }
+
+    unsigned h = m_cfgFingerprint;
+    for( const RedrawDependency& dep : m_redrawVars )
+    {
+        const int count = dep.var->isValid() ? dep.var->getCount() : 0;
+        h = MurmurHash2( &count, sizeof(count), h );
+        for( int i=0; i<count; ++i )
+        {
+            double d = dep.var->getDouble( i );
+            if( dep.quantum > 0.0 )
+                d = std::floor( d / dep.quantum + 0.5 );
+            h = MurmurHash2( &d, sizeof(d), h );
+        }
+    }
+
+    const bool changed = !m_haveInputFingerprint || h != m_inputFingerprint;
+    m_inputFingerprint = h;
+    m_haveInputFingerprint = true;
+    return changed;
+}
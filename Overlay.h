@@ -26,6 +26,7 @@ SOFTWARE.
 
 #include <windows.h>
 #include <string>
+#include <vector>
 #include <dxgi1_6.h>
 #include <d3d11_4.h>
 #include <d2d1_3.h>
@@ -34,6 +35,10 @@ SOFTWARE.
 #include <dwrite_1.h>
 #include <wrl.h>
 #include "util.h"
+#include "DisplayListD2D.h"
+#include "Profiler.h"
+
+class irsdkCVar;
 
 class Overlay
 {
@@ -45,6 +50,8 @@ class Overlay
         std::string     getName() const;
         virtual bool    canEnableWhileNotDriving() const;
         virtual bool    canEnableWhileDisconnected() const;
+        // Whether the user turned this overlay on (the "enabled" key unless overridden)
+        virtual bool    isEnabledInConfig() const;
 
         void            setTargetFPS( int fps );
         int             getTargetFPS() const;
@@ -86,6 +93,12 @@ class Overlay
         virtual bool    hasCustomBackground();
         virtual void    onMouseWheel( int delta, int x, int y );
 
+        // Display-list path: overlays returning true from usesDisplayList() record their frame
+        // into 'dl' instead of drawing in onUpdate(). The base class adds background and UI edit
+        // frame, replays through m_dlRenderer, and skips the GPU submit if the list is unchanged.
+        virtual bool    usesDisplayList() const;
+        virtual void    onDisplayList( DisplayList& dl );
+
         // Global font helpers (centralized typography settings)
         float getGlobalFontSpacing() const;
         void createGlobalTextFormat( 
@@ -99,6 +112,10 @@ class Overlay
             Microsoft::WRL::ComPtr<IDWriteTextFormat>& outFormat 
         ) const;
 
+        // One small bar per sector for a car, colored from the shared sector timing
+        // (purple: class best, green: personal best, yellow: slower). Fake states in preview mode.
+        void drawSectorStrip( float left, float right, float y, float height, int carIdx, bool preview );
+
         std::string     m_name;
         HWND            m_hwnd = 0;
         bool            m_enabled = false;
@@ -118,6 +135,8 @@ class Overlay
         Microsoft::WRL::ComPtr<IDWriteFactory>          m_dwriteFactory;
         Microsoft::WRL::ComPtr<ID2D1SolidColorBrush>    m_brush;
 
+        DisplayListD2D  m_dlRenderer;
+
         // Simple frame pacing (CPU optimization)
         DWORD           m_lastUpdateTick = 0;
         int             m_targetFPS = 60;
@@ -126,4 +145,40 @@ class Overlay
 
         // Allow derived/owners to request a redraw outside normal cadence
         void            requestRedraw() { m_forceNextUpdate = true; }
+
+        // Retained-mode redraw: an overlay that declares *everything* its output depends on
+        // gets onUpdate()/Present() skipped while those inputs are unchanged. Values are
+        // compared after rounding to 'quantum' (0 = exact), so noise below display precision
+        // doesn't trigger redraws. Declare from onEnable()/onConfigChanged().
+        void            clearRedrawDependencies();
+        void            addRedrawDependency( irsdkCVar& var, double quantum=0.0 );
+        void            addRedrawConfigKey( const std::string& key );
+
+    private:
+
+        bool            redrawInputsChanged();
+        void            drawDisplayList( bool forced, float cornerRadius );
+        void            releaseRenderTarget();
+
+        struct RedrawDependency
+        {
+            irsdkCVar*  var;
+            double      quantum;
+        };
+        std::vector<RedrawDependency>   m_redrawVars;
+        std::vector<std::string>        m_redrawCfgKeys;
+        bool            m_trackRedrawInputs = false;
+        bool            m_haveInputFingerprint = false;
+        unsigned        m_inputFingerprint = 0;
+        unsigned        m_cfgFingerprint = 0;
+        unsigned        m_cfgGeneration = 0;
+        DWORD           m_lastRedrawTick = 0;
+
+        DisplayList     m_displayList;
+        DisplayList     m_prevDisplayList;
+
+        Profiler::Zone* m_profUpdate = nullptr;     // onUpdate() / onDisplayList()
+        Profiler::Zone* m_profDraw = nullptr;       // display-list replay
+        Profiler::Zone* m_profPresent = nullptr;
+        const char*     m_traceName = nullptr;      // interned m_name for TRACE_SCOPE
 };
\ No newline at end of file
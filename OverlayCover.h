@@ -41,8 +41,11 @@ class OverlayCover : public Overlay
         {
             // Per-overlay FPS (configurable; default 10)
             setTargetFPS(g_cfg.getInt(m_name, "target_fps", 10));
-            // Cover is static – only redraw on demand
-            setStaticMode(true);
+            // Cover has no telemetry inputs – only its look can change
+            clearRedrawDependencies();
+            addRedrawConfigKey("global_background_col");
+            addRedrawConfigKey("opacity");
+            addRedrawConfigKey("corner_radius");
             requestRedraw();
         }
 };
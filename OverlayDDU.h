@@ -33,6 +33,7 @@ SOFTWARE.
 #include "Config.h"
 #include "OverlayDebug.h"
 #include "stub_data.h"
+#include "FuelModel.h"
 
 class OverlayDDU : public Overlay
 {
@@ -76,6 +77,7 @@ class OverlayDDU : public Overlay
         virtual void onDisable()
         {
             m_text.reset();
+            m_num.reset();
         }
 
         virtual void onConfigChanged()
@@ -83,6 +85,7 @@ class OverlayDDU : public Overlay
             // Font stuff (centralized)
             {
                 m_text.reset( m_dwriteFactory.Get() );
+                m_num.reset( m_dwriteFactory.Get(), &m_text );
                 createGlobalTextFormat(1.0f, m_textFormat);
                 // Bold variant (override weight)
                 createGlobalTextFormat(1.0f, (int)DWRITE_FONT_WEIGHT_BLACK, "", m_textFormatBold);
@@ -214,36 +217,6 @@ class OverlayDDU : public Overlay
             //bmpTarget->Release();
         }
 
-        virtual void onSessionChanged()
-        {
-            m_isValidFuelLap = false;  // avoid confusing the fuel calculator logic with session changes
-            m_lapStartRemainingFuel = ir_FuelLevel.getFloat();
-
-            // Build cache key based on car+track combination
-            std::string newCacheKey = buildFuelCacheKey();
-            m_cacheSavedThisSession = false;
-
-            // Only clear fuel data if car or track changed, otherwise preserve as filler values
-            if (newCacheKey != m_cacheKey && !m_cacheKey.empty())
-            {
-                m_fuelUsedLastLaps.clear();
-            }
-
-            m_cacheKey = newCacheKey;
-
-            // If we don't have fuel data, try to seed from cache
-            if (m_fuelUsedLastLaps.empty() && !m_cacheKey.empty())
-            {
-                const float cachedAvgPerLap = g_cfg.getFloat("FuelCache", m_cacheKey, -1.0f);
-                if (cachedAvgPerLap > 0.0f)
-                {
-                    const int numLapsToAvg = g_cfg.getInt(m_name, "fuel_estimate_avg_green_laps", 4);
-                    for (int i = 0; i < numLapsToAvg; ++i)
-                        m_fuelUsedLastLaps.push_back(cachedAvgPerLap);
-                }
-            }
-        }
-
         virtual void onUpdate()
         {
             const float4 outlineCol         = g_cfg.getFloat4( m_name, "outline_col", float4(0.7f,0.7f,0.7f,0.9f) );
@@ -383,7 +356,7 @@ class OverlayDDU : public Overlay
                 else
                     gearC = char(gear + 48);
                 swprintf( s, _countof(s), L"%C", gearC );
-                m_text.render( m_renderTarget.Get(), s, m_textFormatGear.Get(), m_boxGear.x0, m_boxGear.x1, m_boxGear.y0+m_boxGear.h*0.41f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                m_num.render( m_renderTarget.Get(), s, m_textFormatGear.Get(), m_boxGear.x0, m_boxGear.x1, m_boxGear.y0+m_boxGear.h*0.41f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
 
                 const float speedMps = ir_Speed.getFloat();
                 if( speedMps >= 0 )
@@ -394,7 +367,7 @@ class OverlayDDU : public Overlay
                     else
                         speed = speedMps * 2.23694f;
                     swprintf( s, _countof(s), L"%d", (int)(speed+0.5f) );
-                    m_text.render( m_renderTarget.Get(), s, m_textFormatBold.Get(), m_boxGear.x0, m_boxGear.x1, m_boxGear.y0+m_boxGear.h*0.8f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), s, m_textFormatBold.Get(), m_boxGear.x0, m_boxGear.x1, m_boxGear.y0+m_boxGear.h*0.8f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
                 }
             }
             
@@ -409,7 +382,7 @@ class OverlayDDU : public Overlay
                 else
                     _snprintf_s( lapsStr, _countof(lapsStr), _TRUNCATE, "%d", totalLaps );
                 swprintf( s, _countof(s), L"%d / %S", currentLap, lapsStr );
-                m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxLaps.x0, m_boxLaps.x1, m_boxLaps.y0+m_boxLaps.h*0.25f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                m_num.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxLaps.x0, m_boxLaps.x1, m_boxLaps.y0+m_boxLaps.h*0.25f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
 
                 if( remainingLaps < 0 )
                     _snprintf_s( lapsStr, _countof(lapsStr), _TRUNCATE, "--" );
@@ -418,7 +391,7 @@ class OverlayDDU : public Overlay
                 else
                     _snprintf_s( lapsStr, _countof(lapsStr), _TRUNCATE, "%d", remainingLaps );
                 swprintf( s, _countof(s), L"%S", lapsStr );
-                m_text.render( m_renderTarget.Get(), s, m_textFormatLarge.Get(), m_boxLaps.x0, m_boxLaps.x1, m_boxLaps.y0+m_boxLaps.h*0.55f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                m_num.render( m_renderTarget.Get(), s, m_textFormatLarge.Get(), m_boxLaps.x0, m_boxLaps.x1, m_boxLaps.y0+m_boxLaps.h*0.55f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
 
                 m_text.render( m_renderTarget.Get(), L"TO GO", m_textFormatVerySmall.Get(), m_boxLaps.x0, m_boxLaps.x1, m_boxLaps.y0+m_boxLaps.h*0.75f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
             }
@@ -429,7 +402,7 @@ class OverlayDDU : public Overlay
                 if( pos )
                 {
                     swprintf( s, _countof(s), L"%d", pos );
-                    m_text.render( m_renderTarget.Get(), s, m_textFormatLarge.Get(), m_boxPos.x0, m_boxPos.x1, m_boxPos.y0+m_boxPos.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), s, m_textFormatLarge.Get(), m_boxPos.x0, m_boxPos.x1, m_boxPos.y0+m_boxPos.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
                 }
             }
 
@@ -439,7 +412,7 @@ class OverlayDDU : public Overlay
                 if( lapDelta )
                 {
                     swprintf( s, _countof(s), L"%d", lapDelta );
-                    m_text.render( m_renderTarget.Get(), s, m_textFormatLarge.Get(), m_boxLapDelta.x0, m_boxLapDelta.x1, m_boxLapDelta.y0+m_boxLapDelta.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), s, m_textFormatLarge.Get(), m_boxLapDelta.x0, m_boxLapDelta.x1, m_boxLapDelta.y0+m_boxLapDelta.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
                 }
             }
 
@@ -483,7 +456,7 @@ class OverlayDDU : public Overlay
 
                     m_brush->SetColor( textCol );
                     std::string str = formatLaptime( t );
-                    m_text.render( m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), m_boxBest.x0, m_boxBest.x1, m_boxBest.y0+m_boxBest.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), m_boxBest.x0, m_boxBest.x1, m_boxBest.y0+m_boxBest.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
                 }
             }
 
@@ -493,7 +466,7 @@ class OverlayDDU : public Overlay
                 if( t > 0 )
                 {
                     std::string str = formatLaptime( t );
-                    m_text.render( m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), m_boxLast.x0, m_boxLast.x1, m_boxLast.y0+m_boxLast.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), m_boxLast.x0, m_boxLast.x1, m_boxLast.y0+m_boxLast.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
                 }
             }
 
@@ -505,7 +478,7 @@ class OverlayDDU : public Overlay
                     if( t > 0 )
                     {
                         std::string str = formatLaptime( t );
-                        m_text.render( m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), m_boxP1Last.x0, m_boxP1Last.x1, m_boxP1Last.y0+m_boxP1Last.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                        m_num.render( m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), m_boxP1Last.x0, m_boxP1Last.x1, m_boxP1Last.y0+m_boxP1Last.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
                     }
                 }
             }
@@ -538,63 +511,17 @@ class OverlayDDU : public Overlay
                 }
                 else {
                     swprintf(s, _countof(s), L"TgtFuel-%d", targetLap);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0 + xoff, m_boxFuel.x1, m_boxFuel.y0 + m_boxFuel.h * 10.0f / 12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_LEADING, m_fontSpacing );
+                    m_num.render(m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0 + xoff, m_boxFuel.x1, m_boxFuel.y0 + m_boxFuel.h * 10.0f / 12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_LEADING, m_fontSpacing );
                 }
                 
                 const float estimateFactor = g_cfg.getFloat( m_name, "fuel_estimate_factor", 1.1f );
                 const float fuelReserveMargin = g_cfg.getFloat(m_name, "fuel_reserve_margin", 0.25f);
                 const float remainingFuel  = ir_FuelLevel.getFloat();
+                const float lapStartRemainingFuel = ir_fuel.lapStartFuel();
 
-                // Update average fuel consumption tracking. Ignore laps that weren't entirely under green or where we pitted.
-                float avgPerLap = 0;
-                {
-                    if( lapCountUpdated )
-                    {
-                        const float usedLastLap = std::max( 0.0f, m_lapStartRemainingFuel - remainingFuel );
-                        m_lapStartRemainingFuel = remainingFuel;
-                        
-                        // When resetting, the lap count resets and pushes two 0.0L laps, so we skip them here
-                        if (m_isValidFuelLap && usedLastLap > 0.0f) {
-                            m_fuelUsedLastLaps.push_back( usedLastLap );
-                        }
-
-                        const int numLapsToAvg = g_cfg.getInt( m_name, "fuel_estimate_avg_green_laps", 4 );
-                        while( m_fuelUsedLastLaps.size() > numLapsToAvg )
-                            m_fuelUsedLastLaps.pop_front();
-
-                        m_isValidFuelLap = true;
-                    }
-                    
-                    // For Test Drive or solo practice
-                    const int flagStatus = (ir_SessionFlags.getInt() & ((((int)ir_session.sessionType != 0) ? irsdk_oneLapToGreen : 0) | irsdk_yellow | irsdk_yellowWaving | irsdk_red | irsdk_checkered | irsdk_crossed | irsdk_caution | irsdk_cautionWaving | irsdk_disqualify | irsdk_repair));
-                    if (flagStatus != 0 || ir_CarIdxOnPitRoad.getBool(carIdx)) {
-                        m_isValidFuelLap = false;
-                    }
-                    
-                    
-                    for( float v : m_fuelUsedLastLaps ) {
-                        avgPerLap += v;
-                        dbg("%f",v);
-                    }
-                    if( !m_fuelUsedLastLaps.empty() )
-                        avgPerLap /= (float)m_fuelUsedLastLaps.size();
-
-                    dbg( "valid fuel lap: %d", (int)m_isValidFuelLap );
-                }
-
-                // Persist a fresh average for this car/track combo once we have enough valid laps
-                {
-                    const int numLapsToAvg = g_cfg.getInt(m_name, "fuel_estimate_avg_green_laps", 4);
-                    if (!m_cacheSavedThisSession && (int)m_fuelUsedLastLaps.size() >= numLapsToAvg && avgPerLap > 0.0f)
-                    {
-                        if (m_cacheKey.empty()) m_cacheKey = buildFuelCacheKey();
-                        if (!m_cacheKey.empty())
-                        {
-                            g_cfg.setFloat("FuelCache", m_cacheKey, avgPerLap);
-                            m_cacheSavedThisSession = true;
-                        }
-                    }
-                }
+                // Average over the last green laps, from the shared fuel model
+                const float avgPerLap = ir_fuel.average( g_cfg.getInt( m_name, "fuel_estimate_avg_green_laps", 4 ) );
+                dbg( "fuel laps: %d green, trend %.3f", ir_fuel.numGreenLaps(), ir_fuel.trend(8) );
 
                 // Est Laps
                 const float perLapConsEst = avgPerLap * estimateFactor;  // conservative estimate of per-lap use for further calculations
@@ -602,7 +529,7 @@ class OverlayDDU : public Overlay
                 {
                     const float estLaps = (remainingFuel-fuelReserveMargin) / perLapConsEst;
                     swprintf( s, _countof(s), L"%.*f", g_cfg.getInt( m_name, "fuel_decimal_places", 2), estLaps);
-                    m_text.render( m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*2.3f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*2.3f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
                 }
 
                 // Remaining
@@ -612,7 +539,7 @@ class OverlayDDU : public Overlay
                     if( imperial )
                         val *= 0.264172f;
                     swprintf( s, _countof(s), imperial ? L"%.2f gl" : L"%.2f lt", val );
-                    m_text.render( m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*4.6f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*4.6f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
                 }
 
                 // Per Lap
@@ -622,11 +549,11 @@ class OverlayDDU : public Overlay
                     if( imperial )
                         val *= 0.264172f;
                     swprintf( s, _countof(s), imperial ? L"%.2f gl" : L"%.2f lt", val );
-                    m_text.render( m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*6.4f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*6.4f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
                 }
                 else {
                     swprintf(s, _countof(s), L"%.2f ERR", avgPerLap);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1 - xoff, m_boxFuel.y0 + m_boxFuel.h * 6.4f / 12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1 - xoff, m_boxFuel.y0 + m_boxFuel.h * 6.4f / 12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
                 }
 
                 // To Finish
@@ -638,7 +565,7 @@ class OverlayDDU : public Overlay
                     if (targetLap == 0) {
                         toFinish = std::max(0.0f, remainingLaps * perLapConsEst - (remainingFuel - fuelReserveMargin));
                     } else {
-                        toFinish = (targetLap+1-currentLap) * perLapConsEst - (m_lapStartRemainingFuel - fuelReserveMargin);
+                        toFinish = (targetLap+1-currentLap) * perLapConsEst - (lapStartRemainingFuel - fuelReserveMargin);
                     }
 
                     if( toFinish > ir_PitSvFuel.getFloat() || (toFinish>0 && !ir_dpFuelFill.getFloat())  )
@@ -649,7 +576,7 @@ class OverlayDDU : public Overlay
                     if( imperial )
                         toFinish *= 0.264172f;
                     swprintf( s, _countof(s), imperial ? L"%3.2f gl" : L"%3.2f lt", toFinish );
-                    m_text.render( m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*8.2f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*8.2f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
                     m_brush->SetColor( textCol );
                 }
 
@@ -657,12 +584,12 @@ class OverlayDDU : public Overlay
                 float add = ir_PitSvFuel.getFloat();
                 if (targetLap != 0) {
 
-                    float targetFuel = (m_lapStartRemainingFuel - fuelReserveMargin) / ( targetLap + 1 - currentLap);
+                    float targetFuel = (lapStartRemainingFuel - fuelReserveMargin) / ( targetLap + 1 - currentLap);
 
                     if (imperial)
                         targetFuel *= 0.264172f;
                     swprintf(s, _countof(s), imperial ? L"%3.2f gl" : L"%3.2f lt", targetFuel);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1 - xoff, m_boxFuel.y0 + m_boxFuel.h * 10.0f / 12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
+                    m_num.render(m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1 - xoff, m_boxFuel.y0 + m_boxFuel.h * 10.0f / 12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
                     m_brush->SetColor(textCol);
                 }
                 else if( add >= 0 )
@@ -673,7 +600,7 @@ class OverlayDDU : public Overlay
                     if( imperial )
                         add *= 0.264172f;
                     swprintf( s, _countof(s), imperial ? L"%3.2f gl" : L"%3.2f lt", add );
-                    m_text.render( m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*10.0f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), s, m_textFormatVerySmall.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*10.0f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing );
                     m_brush->SetColor( textCol );
                 }
             }
@@ -714,13 +641,13 @@ class OverlayDDU : public Overlay
                 else
                     m_brush->SetColor( textCol );
                 swprintf( s, _countof(s), L"%d", (int)(lf+0.5f) );
-                m_text.render( m_renderTarget.Get(), s, m_textFormatSmall.Get(), m_boxTires.x0+20, m_boxTires.x0+m_boxTires.w/2, m_boxTires.y0+m_boxTires.h*1.0f/3.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                m_num.render( m_renderTarget.Get(), s, m_textFormatSmall.Get(), m_boxTires.x0+20, m_boxTires.x0+m_boxTires.w/2, m_boxTires.y0+m_boxTires.h*1.0f/3.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
                 if (tireChangeMask & irsdk_LRTireChange)
                     m_brush->SetColor(serviceCol);
                 else
                     m_brush->SetColor(textCol);
                 swprintf( s, _countof(s), L"%d", (int)(lr+0.5f) );
-                m_text.render( m_renderTarget.Get(), s, m_textFormatSmall.Get(), m_boxTires.x0+20, m_boxTires.x0+m_boxTires.w/2, m_boxTires.y0+m_boxTires.h*2.0f/3.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                m_num.render( m_renderTarget.Get(), s, m_textFormatSmall.Get(), m_boxTires.x0+20, m_boxTires.x0+m_boxTires.w/2, m_boxTires.y0+m_boxTires.h*2.0f/3.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
 
                 // Right
                 if(tireChangeMask & irsdk_RFTireChange)
@@ -728,13 +655,13 @@ class OverlayDDU : public Overlay
                 else
                     m_brush->SetColor( textCol );
                 swprintf( s, _countof(s), L"%d", (int)(rf+0.5f) );
-                m_text.render( m_renderTarget.Get(), s, m_textFormatSmall.Get(), m_boxTires.x0+m_boxTires.w/2, m_boxTires.x1-20, m_boxTires.y0+m_boxTires.h*1.0f/3.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER );
+                m_num.render( m_renderTarget.Get(), s, m_textFormatSmall.Get(), m_boxTires.x0+m_boxTires.w/2, m_boxTires.x1-20, m_boxTires.y0+m_boxTires.h*1.0f/3.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER );
                 if (tireChangeMask & irsdk_RRTireChange)
                     m_brush->SetColor(serviceCol);
                 else
                     m_brush->SetColor(textCol);
                 swprintf( s, _countof(s), L"%d", (int)(rr+0.5f) );
-                m_text.render( m_renderTarget.Get(), s, m_textFormatSmall.Get(), m_boxTires.x0+m_boxTires.w/2, m_boxTires.x1-20, m_boxTires.y0+m_boxTires.h*2.0f/3.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER );
+                m_num.render( m_renderTarget.Get(), s, m_textFormatSmall.Get(), m_boxTires.x0+m_boxTires.w/2, m_boxTires.x1-20, m_boxTires.y0+m_boxTires.h*2.0f/3.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER );
                 m_brush->SetColor( textCol );
 
                 m_brush->SetColor( textCol );
@@ -754,7 +681,7 @@ class OverlayDDU : public Overlay
                     
                     // Don't cache this! The memory cost is too high for a number that could skyrocket if you stop on track.
                     // Weird edge case, but the CPU cost is negligible vs the risk of this crashing a computer
-                    m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxDelta.x0, m_boxDelta.x1, m_boxDelta.y0+m_boxDelta.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                    m_num.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxDelta.x0, m_boxDelta.x1, m_boxDelta.y0+m_boxDelta.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
                 }
             }
 
@@ -769,14 +696,14 @@ class OverlayDDU : public Overlay
                     swprintf( s, _countof(s), L"%d:%02d:%02d", hours, mins, secs );
                 else
                     swprintf( s, _countof(s), L"%02d:%02d", mins, secs ); 
-                m_text.render( m_renderTarget.Get(), s, m_textFormatSmall.Get(), m_boxSession.x0, m_boxSession.x1, m_boxSession.y0+m_boxSession.h*0.55f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                m_num.render( m_renderTarget.Get(), s, m_textFormatSmall.Get(), m_boxSession.x0, m_boxSession.x1, m_boxSession.y0+m_boxSession.h*0.55f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
             }
 
             // Incidents
             {
                 const int inc = ir_PlayerCarTeamIncidentCount.getInt();
                 swprintf( s, _countof(s), L"%dx", inc );
-                m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxInc.x0, m_boxInc.x1, m_boxInc.y0+m_boxInc.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                m_num.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxInc.x0, m_boxInc.x1, m_boxInc.y0+m_boxInc.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
             }
 
             // Brake bias
@@ -793,7 +720,7 @@ class OverlayDDU : public Overlay
                 m_brush->SetColor(textCol);
                 m_prevBrakeBias = bias;
                 swprintf( s, _countof(s), L"%+3.1f", bias );
-                m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxBias.x0, m_boxBias.x1, m_boxBias.y0+m_boxBias.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                m_num.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxBias.x0, m_boxBias.x1, m_boxBias.y0+m_boxBias.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
             }
 
             // Oil temp
@@ -806,7 +733,7 @@ class OverlayDDU : public Overlay
                     m_brush->SetColor( warnCol );
 
                 swprintf( s, _countof(s), L"%3.0f\x00B0", temp );
-                m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxOil.x0, m_boxOil.x1, m_boxOil.y0+m_boxOil.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                m_num.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxOil.x0, m_boxOil.x1, m_boxOil.y0+m_boxOil.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
                 m_brush->SetColor( textCol );
             }
 
@@ -820,7 +747,7 @@ class OverlayDDU : public Overlay
                     m_brush->SetColor( warnCol );
 
                 swprintf( s, _countof(s), L"%3.0f\x00B0", temp );
-                m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxWater.x0, m_boxWater.x1, m_boxWater.y0+m_boxWater.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+                m_num.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxWater.x0, m_boxWater.x1, m_boxWater.y0+m_boxWater.h*0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
                 m_brush->SetColor( textCol );
             }
 
@@ -878,28 +805,6 @@ class OverlayDDU : public Overlay
             return r;
         }
 
-        // Build a stable key like: t<trackId>_<sanitizedTrackCfg>_c<carId>
-        std::string buildFuelCacheKey() const
-        {
-            int trackId = ir_session.trackId;
-            std::string cfg = ir_session.trackConfigName;
-            int carId = 0;
-            if (ir_session.driverCarIdx >= 0)
-                carId = ir_session.cars[ir_session.driverCarIdx].carID;
-
-            if (trackId <= 0 || carId <= 0)
-                return std::string();
-
-            for (char& c : cfg)
-            {
-                if (!( (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ))
-                    c = '_';
-            }
-            char buf[256];
-            _snprintf_s(buf, _countof(buf), _TRUNCATE, "t%d_%s_c%d", trackId, cfg.c_str(), carId);
-            return std::string(buf);
-        }
-
     protected:
 
         virtual bool hasCustomBackground()
@@ -934,6 +839,7 @@ class OverlayDDU : public Overlay
         Microsoft::WRL::ComPtr<ID2D1PathGeometry1> m_backgroundPathGeometry;
 
         TextCache m_text;
+        NumericText m_num;
         Microsoft::WRL::ComPtr<ID2D1Bitmap> m_backgroundBitmap;
 
         int m_prevCurrentLap = 0;
@@ -944,12 +850,5 @@ class OverlayDDU : public Overlay
         float m_prevBrakeBias = 0;
         DWORD m_prevBrakeBiasTickCount = 0;
 
-        float m_lapStartRemainingFuel = 0;
-        std::deque<float> m_fuelUsedLastLaps;
-        bool m_isValidFuelLap = false;
         float m_fontSpacing = getGlobalFontSpacing();
-
-        // Simple per-car+track fuel average cache
-        std::string m_cacheKey;
-        bool m_cacheSavedThisSession = false;
 };
\ No newline at end of file
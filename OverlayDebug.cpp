@@ -25,6 +25,7 @@ SOFTWARE.
 #pragma once
 
 #include "OverlayDebug.h"
+#include "Config.h"
 #include <string>
 #include <vector>
 #include <stdarg.h>
@@ -92,13 +93,17 @@ void OverlayDebug::onConfigChanged()
     HRCHECK(m_dwriteFactory->CreateTextFormat( L"Consolas", NULL, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL, 15, L"en-us", &m_textFormat ));
     m_textFormat->SetParagraphAlignment( DWRITE_PARAGRAPH_ALIGNMENT_CENTER );
     m_textFormat->SetWordWrapping( DWRITE_WORD_WRAPPING_NO_WRAP );
+    m_dlRenderer.setFont( 0, m_textFormat.Get() );
 }
 
-void OverlayDebug::onUpdate()
+bool OverlayDebug::usesDisplayList() const
 {
-    const float lineHeight = 20;
+    return true;
+}
 
-    m_renderTarget->BeginDraw();
+void OverlayDebug::onDisplayList( DisplayList& dl )
+{
+    const float lineHeight = 20;
 
     for( int i=0; i<(int)g_dbgLines.size(); ++i )
     {
@@ -106,13 +111,30 @@ void OverlayDebug::onUpdate()
 
         const float y = 10 + lineHeight/2 + i*lineHeight;
         
-        m_brush->SetColor( line.col );
-        D2D1_RECT_F r = { 10, y-lineHeight/2, (float)m_width-10, y+lineHeight/2 };
         auto wstr = toWide( line.s );
-        m_renderTarget->DrawTextA( wstr.c_str(), (int)wstr.size(), m_textFormat.Get(), &r, m_brush.Get(), D2D1_DRAW_TEXT_OPTIONS_CLIP );
+        dl.text( wstr.c_str(), 0, 10, (float)m_width-10, y, toDlColor(line.col), DlAlign::Leading );
     }
 
-    m_renderTarget->EndDraw();
+    // Profiler page: rolling frame-time percentiles per zone
+    if( Profiler::enabled() )
+    {
+        Profiler::instance().snapshot( m_profStats );
+
+        float y = 10 + lineHeight/2 + g_dbgLines.size()*lineHeight;
+        wchar_t s[256];
+        _snwprintf_s( s, _countof(s), _TRUNCATE, L"%-28s %6s %7s %7s %7s %7s", L"zone (ms)", L"n", L"p50", L"p95", L"p99", L"max" );
+        dl.text( s, 0, 10, (float)m_width-10, y, toDlColor(float4(0.6f,0.8f,1,0.9f)), DlAlign::Leading );
+        y += lineHeight;
+
+        for( const Profiler::Stats& st : m_profStats )
+        {
+            // Anything whose tail eats half a 60Hz frame stands out
+            const float4 col = st.p99Ms > 8.0f ? float4(1,0.6f,0.3f,0.95f) : float4(1,1,1,0.9f);
+            _snwprintf_s( s, _countof(s), _TRUNCATE, L"%-28.28S %6u %7.2f %7.2f %7.2f %7.2f", st.name.c_str(), st.count, st.p50Ms, st.p95Ms, st.p99Ms, st.maxMs );
+            dl.text( s, 0, 10, (float)m_width-10, y, toDlColor(col), DlAlign::Leading );
+            y += lineHeight;
+        }
+    }
 
     g_dbgLines.clear();
 }
@@ -126,3 +148,13 @@ bool OverlayDebug::canEnableWhileDisconnected() const
 {
     return true;
 }
+
+bool OverlayDebug::isEnabledInConfig() const
+{
+#ifdef _DEBUG
+    return Overlay::isEnabledInConfig();
+#else
+    // Release builds only show this overlay as the profiler HUD
+    return g_cfg.getBool( "General", "profiler_enabled", false );
+#endif
+}
@@ -38,12 +38,15 @@ public:
     OverlayDebug();
     virtual void onEnable();
     virtual void onConfigChanged();
-    virtual void onUpdate();
+    virtual bool usesDisplayList() const;
+    virtual void onDisplayList( DisplayList& dl );
     virtual bool canEnableWhileNotDriving() const;
     virtual bool canEnableWhileDisconnected() const;
+    virtual bool isEnabledInConfig() const;
 
 protected:
 
     Microsoft::WRL::ComPtr<IDWriteTextFormat>  m_textFormat;
+    std::vector<Profiler::Stats>               m_profStats;
 
 };
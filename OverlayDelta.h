@@ -27,6 +27,7 @@ SOFTWARE.
 #include <deque>
 #include "Overlay.h"
 #include "iracing.h"
+#include "RaceState.h"
 #include "Config.h"
 #include "util.h"
 #include "preview_mode.h"
@@ -53,8 +54,19 @@ protected:
         SESSION_BEST = 1,        // Player's best lap in current session (ir_LapDeltaToSessionBestLap) 
         ALLTIME_OPTIMAL = 2,     // All-time optimal lap from sectors (ir_LapDeltaToOptimalLap)
         SESSION_OPTIMAL = 3,     // Session optimal lap from sectors (ir_LapDeltaToSessionOptimalLap)
-        LAST_LAP = 4            // Last completed lap (custom calculation)
+        LAST_LAP = 4,            // Last clean lap (own delta engine)
+        PINNED_LAP = 5           // Lap pinned with the pin hotkey (own delta engine)
     };
+
+    // Modes served by our own distance-indexed delta instead of iRacing's channels
+    static bool isOwnReference(ReferenceMode mode, DeltaEngine::Ref& ref)
+    {
+        switch (mode) {
+            case ReferenceMode::LAST_LAP:   ref = DeltaEngine::Ref::LAST; return true;
+            case ReferenceMode::PINNED_LAP: ref = DeltaEngine::Ref::PINNED; return true;
+            default: return false;
+        }
+    }
     
     virtual void onEnable()
     {
@@ -66,6 +78,7 @@ protected:
         m_referenceMode = (ReferenceMode)g_cfg.getInt(m_name, "reference_mode", 1); // Default to session best
         m_trendSamples = g_cfg.getInt(m_name, "trend_samples", 10);
         m_text.reset(m_dwriteFactory.Get());
+        m_num.reset(m_dwriteFactory.Get(), &m_text);
         m_fontSpacing = getGlobalFontSpacing();
         m_staticLabelsBitmap.Reset();
         m_lastLabelScale = -1.0f;
@@ -88,11 +101,15 @@ protected:
         // Store previous delta for trend calculation
         float previousDelta = m_currentDelta;
         
-        // Get delta based on selected reference mode using iRacing's native calculations
+        // Get delta based on selected reference mode: our own engine for last/pinned laps, iRacing's native calculations otherwise
         bool deltaValid = false;
         float deltaValue = 0.0f;
+        DeltaEngine::Ref ownRef;
         
-        switch (m_referenceMode) {
+        if (isOwnReference(m_referenceMode, ownRef)) {
+            deltaValid = ir_race.delta.delta(ownRef, deltaValue);
+        }
+        else switch (m_referenceMode) {
             case ReferenceMode::ALLTIME_BEST:
                 deltaValid = ir_LapDeltaToBestLap_OK.getBool();
                 if (deltaValid) deltaValue = ir_LapDeltaToBestLap.getFloat();
@@ -119,10 +136,7 @@ protected:
                 }
                 break;
                 
-            case ReferenceMode::LAST_LAP:
-                // For last lap, we'd need custom calculation - for now fall back to all-time best
-                deltaValid = ir_LapDeltaToBestLap_OK.getBool();
-                if (deltaValid) deltaValue = ir_LapDeltaToBestLap.getFloat();
+            default:
                 break;
         }
         
@@ -186,6 +200,8 @@ protected:
                 return "SESSION OPTIMAL";
             case ReferenceMode::LAST_LAP: 
                 return "LAST LAP";
+            case ReferenceMode::PINNED_LAP:
+                return "PINNED LAP";
             default: 
                 return "SESSION BEST";
         }
@@ -228,6 +244,11 @@ protected:
 
         // Check if delta is valid based on reference mode
         bool deltaValid = false;
+        DeltaEngine::Ref ownRef;
+        float ownDelta;
+        if (isOwnReference(m_referenceMode, ownRef))
+            return ir_race.delta.delta(ownRef, ownDelta);
+
         switch (m_referenceMode) {
             case ReferenceMode::ALLTIME_BEST:
                 deltaValid = ir_LapDeltaToBestLap_OK.getBool();
@@ -241,8 +262,7 @@ protected:
             case ReferenceMode::SESSION_OPTIMAL:
                 deltaValid = ir_LapDeltaToSessionOptimalLap_OK.getBool();
                 break;
-            case ReferenceMode::LAST_LAP:
-                deltaValid = ir_LapDeltaToBestLap_OK.getBool();
+            default:
                 break;
         }
 
@@ -310,7 +330,7 @@ protected:
         
         float deltaWidth = 90.0f * scale;
         m_brush->SetColor(deltaColor);
-        m_text.render( m_renderTarget.Get(), deltaBuffer, m_scaledDeltaFormat.Get(), centerX - deltaWidth/2, centerX + deltaWidth/2, centerY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing * 1.2f );
+        m_num.render( m_renderTarget.Get(), deltaBuffer, m_scaledDeltaFormat.Get(), centerX - deltaWidth/2, centerX + deltaWidth/2, centerY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing * 1.2f );
     }
 
     void drawArcProgress(float centerX, float centerY, float radius, float progress, const float4& color, float scale)
@@ -389,7 +409,7 @@ protected:
             drawCard(leftX, blockTop - cardVPad, columnWidth, totalBlockH + (2.0f * cardVPad), bgColor);
             
             m_brush->SetColor(timeColor);
-            m_text.render( m_renderTarget.Get(), timeBuffer, m_scaledDeltaFormat.Get(), leftX, leftX + columnWidth, timeY + (timeHeight * 0.6f), m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing * 3.0f );
+            m_num.render( m_renderTarget.Get(), timeBuffer, m_scaledDeltaFormat.Get(), leftX, leftX + columnWidth, timeY + (timeHeight * 0.6f), m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing * 3.0f );
             
             // Reference label drawn via static labels bitmap
         }
@@ -420,7 +440,7 @@ protected:
                 drawCard(rightX, blockTop - cardVPad, columnWidth, totalBlockH + (2.0f * cardVPad), bgColor);
                 
                 m_brush->SetColor(predictedColor);
-                m_text.render( m_renderTarget.Get(), timeBuffer, m_scaledDeltaFormat.Get(), rightX, rightX + columnWidth, timeY + (timeHeight * 0.6f), m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing * 3.0f );
+                m_num.render( m_renderTarget.Get(), timeBuffer, m_scaledDeltaFormat.Get(), rightX, rightX + columnWidth, timeY + (timeHeight * 0.6f), m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing * 3.0f );
             }
         }
     }
@@ -431,9 +451,12 @@ protected:
             return StubDataManager::getStubSessionBestLapTime();
         }
 
+        DeltaEngine::Ref ownRef;
+        if (isOwnReference(m_referenceMode, ownRef))
+            return ir_race.delta.refLapTime(ownRef);
+
         switch (m_referenceMode) {
             case ReferenceMode::ALLTIME_BEST:
-            case ReferenceMode::LAST_LAP:
                 return ir_LapBestLapTime.getFloat();
                 
             case ReferenceMode::SESSION_BEST:
@@ -547,6 +570,7 @@ protected:
     Microsoft::WRL::ComPtr<IDWriteTextFormat> m_scaledSmallFormat;
 
     TextCache m_text;
+    NumericText m_num;
 	float m_fontSpacing = getGlobalFontSpacing();
 
     // Cached static labels to reduce per-frame text draws
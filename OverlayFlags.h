@@ -28,6 +28,7 @@ SOFTWARE.
 #include <string>
 #include <vector>
 #include "Overlay.h"
+#include "StyleBrushes.h"
 #include "iracing.h"
 #include "Config.h"
 #include "irsdk/irsdk_defines.h"
@@ -60,6 +61,12 @@ protected:
 	{
 		setTargetFPS(g_cfg.getInt(m_name, "target_fps", 10));
 
+		// Only redraw when the flag state actually changes
+		clearRedrawDependencies();
+		addRedrawDependency(ir_SessionFlags);
+		addRedrawDependency(ir_SessionState);
+		addRedrawConfigKey("opacity");
+
 		m_text.reset(m_dwriteFactory.Get());
 		createGlobalTextFormat(1.05f, (int)DWRITE_FONT_WEIGHT_BOLD, "", m_textFormatTop);
 		createGlobalTextFormat(1.45f, (int)DWRITE_FONT_WEIGHT_BOLD, "", m_textFormatMain);
@@ -225,49 +232,8 @@ private:
 		if (!m_renderTarget) return;
 		if (m_bgBrush && m_panelBrush) return;
 
-		{
-			D2D1_GRADIENT_STOP stops[3] = {};
-			stops[0].position = 0.0f;  stops[0].color = D2D1::ColorF(0.16f, 0.18f, 0.22f, 0.95f);
-			stops[1].position = 0.45f; stops[1].color = D2D1::ColorF(0.06f, 0.07f, 0.09f, 0.95f);
-			stops[2].position = 1.0f;  stops[2].color = D2D1::ColorF(0.02f, 0.02f, 0.03f, 0.95f);
-
-			Microsoft::WRL::ComPtr<ID2D1GradientStopCollection> stopCollection;
-			HRESULT hr = m_renderTarget->CreateGradientStopCollection(
-				stops,
-				ARRAYSIZE(stops),
-				D2D1_GAMMA_2_2,
-				D2D1_EXTEND_MODE_CLAMP,
-				stopCollection.GetAddressOf()
-			);
-			if (SUCCEEDED(hr)) {
-				D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES props = {};
-				props.startPoint = D2D1_POINT_2F{ 0,0 };
-				props.endPoint = D2D1_POINT_2F{ 0,1 };
-				m_renderTarget->CreateLinearGradientBrush(props, stopCollection.Get(), m_bgBrush.GetAddressOf());
-			}
-		}
-
-		{
-			D2D1_GRADIENT_STOP stops[3] = {};
-			stops[0].position = 0.0f;  stops[0].color = D2D1::ColorF(0.08f, 0.09f, 0.11f, 0.92f);
-			stops[1].position = 0.55f; stops[1].color = D2D1::ColorF(0.04f, 0.045f, 0.055f, 0.92f);
-			stops[2].position = 1.0f;  stops[2].color = D2D1::ColorF(0.02f, 0.02f, 0.03f, 0.92f);
-
-			Microsoft::WRL::ComPtr<ID2D1GradientStopCollection> stopCollection;
-			HRESULT hr = m_renderTarget->CreateGradientStopCollection(
-				stops,
-				ARRAYSIZE(stops),
-				D2D1_GAMMA_2_2,
-				D2D1_EXTEND_MODE_CLAMP,
-				stopCollection.GetAddressOf()
-			);
-			if (SUCCEEDED(hr)) {
-				D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES props = {};
-				props.startPoint = D2D1_POINT_2F{ 0,0 };
-				props.endPoint = D2D1_POINT_2F{ 0,1 };
-				m_renderTarget->CreateLinearGradientBrush(props, stopCollection.Get(), m_panelBrush.GetAddressOf());
-			}
-		}
+		StyleBrushes::createLinearGradient(m_renderTarget.Get(), StyleBrushes::card(), m_bgBrush.ReleaseAndGetAddressOf());
+		StyleBrushes::createLinearGradient(m_renderTarget.Get(), StyleBrushes::panel(), m_panelBrush.ReleaseAndGetAddressOf());
 	}
 
 	struct FlagInfo
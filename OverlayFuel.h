@@ -28,12 +28,15 @@ SOFTWARE.
 #include <algorithm>
 #include <cctype>
 #include "Overlay.h"
+#include "StyleBrushes.h"
 #include "iracing.h"
 #include "Units.h"
 #include "Config.h"
 #include "OverlayDebug.h"
 #include "stub_data.h"
 #include "ClassColors.h"
+#include "FuelModel.h"
+#include "FuelStrategy.h"
 
 // Lightweight overlay showing the same fuel calculator values as DDU
 class OverlayFuel : public Overlay
@@ -55,6 +58,7 @@ protected:
 	{
 		onConfigChanged();
 		m_text.reset(m_dwriteFactory.Get());
+		m_num.reset(m_dwriteFactory.Get(), &m_text);
 		m_bgBrush.Reset();
 		m_panelBrush.Reset();
 	}
@@ -62,6 +66,7 @@ protected:
 	virtual void onDisable()
 	{
 		m_text.reset();
+		m_num.reset();
 		m_bgBrush.Reset();
 		m_panelBrush.Reset();
 	}
@@ -72,6 +77,7 @@ protected:
 		int fontWeight = g_cfg.getInt(m_name, "font_weight", g_cfg.getInt("Overlay", "font_weight", 500));
 
 		m_text.reset(m_dwriteFactory.Get());
+		m_num.reset(m_dwriteFactory.Get(), &m_text);
 
 		float unused_fontSpacing = g_cfg.getFloat(m_name, "font_spacing", g_cfg.getFloat("Overlay", "font_spacing", 0.30f));
 
@@ -94,48 +100,6 @@ protected:
 		m_panelBrush.Reset();
 	}
 
-	virtual void onSessionChanged()
-	{
-		m_isValidFuelLap = false;
-		const bool useStub = StubDataManager::shouldUseStubData();
-		m_lapStartRemainingFuel = useStub ? StubDataManager::getStubFuelLevel() : ir_FuelLevel.getFloat();
-		m_prevRemainingFuel = m_lapStartRemainingFuel;
-		m_prevOnPitRoad = false;
-		m_greenLapsSincePit = 0;
-		m_maxFuelUsedLapSession = 0.0f;
-		m_maxFuelUsedLapStint = 0.0f;
-		m_pitHistory.clear();
-
-		std::string newCacheKey = buildFuelCacheKey();
-		m_cacheSavedThisSession = false;
-
-		if (newCacheKey != m_cacheKey && !m_cacheKey.empty())
-		{
-			m_fuelUsedLastLaps.clear();
-		}
-
-		m_cacheKey = newCacheKey;
-
-		if (m_fuelUsedLastLaps.empty() && !m_cacheKey.empty())
-		{
-			const float cachedAvgPerLap = g_cfg.getFloat("FuelCache", m_cacheKey, -1.0f);
-			if (cachedAvgPerLap > 0.0f)
-			{
-				const int numLapsToAvg = g_cfg.getInt(m_name, "fuel_estimate_avg_green_laps", 4);
-				for (int i = 0; i < numLapsToAvg; ++i)
-					m_fuelUsedLastLaps.push_back(cachedAvgPerLap);
-			}
-		}
-
-		if (m_fuelUsedLastLaps.empty() && StubDataManager::shouldUseStubData())
-		{
-			const int numLapsToAvg = g_cfg.getInt(m_name, "fuel_estimate_avg_green_laps", 4);
-			const float stubFuelPerLap = StubDataManager::getStubFuelPerLap();
-			for (int i = 0; i < numLapsToAvg; ++i)
-				m_fuelUsedLastLaps.push_back(stubFuelPerLap);
-		}
-	}
-
 	virtual void onUpdate()
 	{
 		const bool useStub = StubDataManager::shouldUseStubData();
@@ -155,74 +119,44 @@ protected:
 
 		const float remainingFuel = useStub ? StubDataManager::getStubFuelLevel() : ir_FuelLevel.getFloat();
 		const float fuelCapacity = ir_session.fuelMaxLtr;
-		const bool onPitRoadNow = useStub ? false : ir_CarIdxOnPitRoad.getBool(carIdx);
-
-		const int prevLap = m_prevCurrentLap;
-		m_prevCurrentLap = currentLap;
-		if (currentLap != prevLap)
-		{
-			const float usedLastLap = std::max(0.0f, m_lapStartRemainingFuel - remainingFuel);
-			m_lapStartRemainingFuel = remainingFuel;
-			if (m_isValidFuelLap && usedLastLap > 0.0f)
-			{
-				m_fuelUsedLastLaps.push_back(usedLastLap);
-				m_maxFuelUsedLapSession = std::max(m_maxFuelUsedLapSession, usedLastLap);
-				m_maxFuelUsedLapStint = std::max(m_maxFuelUsedLapStint, usedLastLap);
-				m_greenLapsSincePit = std::max(0, m_greenLapsSincePit + 1);
-			}
-
-			const int numLapsToAvg = g_cfg.getInt(m_name, "fuel_estimate_avg_green_laps", 4);
-			while ((int)m_fuelUsedLastLaps.size() > numLapsToAvg)
-				m_fuelUsedLastLaps.pop_front();
+		const float lapStartRemainingFuel = useStub ? StubDataManager::getStubFuelLevel() : ir_fuel.lapStartFuel();
 
-			m_isValidFuelLap = true;
-		}
-
-		// Pit history: record pit-road entry and reset stint counter/max.
-		if (!m_prevOnPitRoad && onPitRoadNow)
+		// Per-lap usage comes from the shared fuel model (green laps, this and earlier sessions)
+		const int numLapsToAvg = g_cfg.getInt(m_name, "fuel_estimate_avg_green_laps", 4);
+		float avgPerLap = ir_fuel.average(numLapsToAvg);
+		// "Max per lap" (and push calcs) should be based on the same data source as Avg per lap.
+		// The recent max covers stored laps before any green lap has been driven this session.
+		float maxPerLap = std::max(ir_fuel.sessionMax(), ir_fuel.recentMax(numLapsToAvg));
+		if (avgPerLap <= 0.0f && useStub)
 		{
-			PitEntry e;
-			e.pitLap = currentLap;
-			e.greenLaps = m_greenLapsSincePit;
-			m_pitHistory.push_back(e);
-			while ((int)m_pitHistory.size() > 6)
-				m_pitHistory.pop_front();
-
-			m_greenLapsSincePit = 0;
-			m_maxFuelUsedLapStint = 0.0f;
+			avgPerLap = StubDataManager::getStubFuelPerLap();
+			maxPerLap = avgPerLap;
 		}
-		m_prevOnPitRoad = onPitRoadNow;
-		m_prevRemainingFuel = remainingFuel;
-
-		// Invalidate lap if on pit road or under flags (same spirit as DDU)
-		const int flagStatus = (ir_SessionFlags.getInt() & ((((int)ir_session.sessionType != 0) ? irsdk_oneLapToGreen : 0) | irsdk_yellow | irsdk_yellowWaving | irsdk_red | irsdk_checkered | irsdk_crossed | irsdk_caution | irsdk_cautionWaving | irsdk_disqualify | irsdk_repair));
-		if (flagStatus != 0 || onPitRoadNow)
-			m_isValidFuelLap = false;
-
-		float avgPerLap = 0.0f;
-		for (float v : m_fuelUsedLastLaps) avgPerLap += v;
-		if (!m_fuelUsedLastLaps.empty()) avgPerLap /= (float)m_fuelUsedLastLaps.size();
 		const float perLapConsEst = avgPerLap * estimateFactor;
-		// "Max per lap" (and push calcs) should be based on the same data source as Avg per lap.
-		// Note: m_fuelUsedLastLaps may be seeded from cache before any valid lap is recorded this session,
-		// so we also take the max of the history deque to avoid maxPerLap being 0.0 early on.
-		float maxPerLapFromHistory = 0.0f;
-		for (float v : m_fuelUsedLastLaps) maxPerLapFromHistory = std::max(maxPerLapFromHistory, v);
-		const float maxPerLap = std::max(m_maxFuelUsedLapSession, maxPerLapFromHistory);
 		const float pushPerLapConsEst = maxPerLap * pushEstimateFactor;
 
-		// Persist a fresh average for this car/track combo once we have enough valid laps
+		// Stop plan for the rest of the race, solved in the background. Off by default: the three
+		// extra rows need a taller window than the default size.
+		const bool showStrategy = g_cfg.getBool(m_name, "show_strategy", false);
+		FuelStrategy::Plan plan;
+		if (showStrategy)
 		{
-			const int numLapsToAvg = g_cfg.getInt(m_name, "fuel_estimate_avg_green_laps", 4);
-			if (!m_cacheSavedThisSession && (int)m_fuelUsedLastLaps.size() >= numLapsToAvg && avgPerLap > 0.0f)
-			{
-				if (m_cacheKey.empty()) m_cacheKey = buildFuelCacheKey();
-				if (!m_cacheKey.empty())
-				{
-					g_cfg.setFloat("FuelCache", m_cacheKey, avgPerLap);
-					m_cacheSavedThisSession = true;
-				}
-			}
+			const float levelPct = useStub ? StubDataManager::getStubFuelLevelPct() : ir_FuelLevelPct.getFloat();
+			const bool timed = !useStub && ir_SessionLapsTotal.getInt() == 32767 && ir_SessionTimeRemain.getDouble() < 48.0 * 3600.0;
+
+			FuelStrategy::Inputs in;
+			in.fuel = remainingFuel;
+			in.perLap = perLapConsEst;
+			in.capacity = fuelCapacity > 0.0f ? fuelCapacity : (levelPct > 0.01f ? remainingFuel / levelPct : 0.0f);
+			in.reserve = reserve;
+			in.lapsRemaining = timed ? -1 : remainingLaps;
+			in.timeRemaining = timed ? (float)ir_SessionTimeRemain.getDouble() : -1.0f;
+			in.lapTime = timed ? ir_estimateLaptime() : 0.0f;
+			in.pitLoss = g_cfg.getFloat(m_name, "pit_loss_seconds", 30.0f);
+			in.fillRate = g_cfg.getFloat(m_name, "fuel_fill_rate", 2.4f);
+			in.saveFraction = g_cfg.getFloat(m_name, "fuel_save_target_pct", 0.0f) / 100.0f;
+			ir_strategy.submit(in);
+			plan = ir_strategy.plan();
 		}
 
 		// Colors - changed goodCol to white, warnCol to orange
@@ -351,7 +285,7 @@ protected:
 					m_textFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER);
 				}
 				m_brush->SetColor(float4(1, 1, 1, 0.92f * globalOpacity));
-				m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), rBar.left, rBar.right, (rBar.top + rBar.bottom) * 0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+				m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), rBar.left, rBar.right, (rBar.top + rBar.bottom) * 0.5f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
 			}
 		}
 
@@ -369,7 +303,7 @@ protected:
 			if (fuelCapacity > 0.0f) {
 				float val = fuelCapacity; if (imperial) val *= 0.264172f;
 				swprintf(s, _countof(s), imperial ? L"%.1f GAL" : L"%.1f L", val);
-				m_text.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), rBar.right - 110.0f, rBar.right, yLbl, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+				m_num.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), rBar.right - 110.0f, rBar.right, yLbl, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
 			}
 		}
 
@@ -428,7 +362,7 @@ protected:
 		auto drawValue = [&](const wchar_t* value, float yCenter, const float4& col)
 		{
 			m_brush->SetColor(float4(col.x, col.y, col.z, col.w * globalOpacity));
-			m_text.render(m_renderTarget.Get(), value, m_textFormatSmall.Get(), (xPad + xRight) * 0.5f, xRight, yCenter, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+			m_num.render(m_renderTarget.Get(), value, m_textFormatSmall.Get(), (xPad + xRight) * 0.5f, xRight, yCenter, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
 		};
 
 		{
@@ -472,7 +406,7 @@ protected:
 				}
 				else
 				{
-					value = (targetLap + 1 - currentLap) * perLapConsEst - (m_lapStartRemainingFuel - reserve);
+					value = (targetLap + 1 - currentLap) * perLapConsEst - (lapStartRemainingFuel - reserve);
 				}
 				const bool warn = (value > (useStub ? StubDataManager::getStubPitServiceFuel() : ir_PitSvFuel.getFloat())) || (value > 0 && !(useStub ? StubDataManager::getStubFuelFillAvailable() : ir_dpFuelFill.getFloat()));
 				const float4 valCol = warn ? warnCol : goodCol;
@@ -497,7 +431,7 @@ protected:
 				}
 				else
 				{
-					value = (targetLap + 1 - currentLap) * pushPerLapConsEst - (m_lapStartRemainingFuel - reserve);
+					value = (targetLap + 1 - currentLap) * pushPerLapConsEst - (lapStartRemainingFuel - reserve);
 				}
 				const bool warn = (value > (useStub ? StubDataManager::getStubPitServiceFuel() : ir_PitSvFuel.getFloat())) || (value > 0 && !(useStub ? StubDataManager::getStubFuelFillAvailable() : ir_dpFuelFill.getFloat()));
 				const float4 valCol = warn ? warnCol : goodCol;
@@ -514,7 +448,7 @@ protected:
 			drawLabel((targetLap == 0 ? L"Add" : L"Target"), y, textCol);
 
 			if (targetLap != 0) {
-				float targetFuel = (m_lapStartRemainingFuel - reserve) / (targetLap + 1 - currentLap);
+				float targetFuel = (lapStartRemainingFuel - reserve) / (targetLap + 1 - currentLap);
 
 				if (imperial)
 					targetFuel *= 0.264172f;
@@ -573,6 +507,52 @@ protected:
 			y += lineHeight;
 		}
 
+		if (showStrategy)
+		{
+			drawRowBg(y, (rowCnt & 1) != 0);
+			drawLabel(L"Stops", y, textCol);
+
+			if (plan.valid)
+			{
+				if (plan.stops == 0)
+				{
+					swprintf(s, _countof(s), L"0");
+				}
+				else
+				{
+					float val = plan.fillPerStop; if (imperial) val *= 0.264172f;
+					swprintf(s, _countof(s), imperial ? L"%d x %.1f G" : L"%d x %.1f L", plan.stops, val);
+				}
+				drawValue(s, y, textCol);
+			}
+			rowCnt++;
+			y += lineHeight;
+
+			drawRowBg(y, (rowCnt & 1) != 0);
+			drawLabel(L"Next stop", y, textCol);
+
+			if (plan.valid && plan.stops > 0)
+			{
+				swprintf(s, _countof(s), L"L%d-%d", currentLap + plan.windowOpen[0], currentLap + plan.windowClose[0]);
+				drawValue(s, y, plan.windowClose[0] <= 1 ? warnCol : textCol);
+			}
+			rowCnt++;
+			y += lineHeight;
+
+			drawRowBg(y, (rowCnt & 1) != 0);
+			drawLabel(L"Save for -1 stop", y, textCol);
+
+			if (plan.valid && plan.perLapForOneLess > 0.0f)
+			{
+				const float savePct = 100.0f * (1.0f - plan.perLapForOneLess / plan.perLap);
+				float val = plan.perLapForOneLess; if (imperial) val *= 0.264172f;
+				swprintf(s, _countof(s), imperial ? L"%.2f G (-%.0f%%)" : L"%.2f L (-%.0f%%)", val, savePct);
+				drawValue(s, y, textCol);
+			}
+			rowCnt++;
+			y += lineHeight;
+		}
+
 		{
 			drawRowBg(y, (rowCnt & 1) != 0);
 			drawLabel(L"Pits", y, textCol);
@@ -580,12 +560,13 @@ protected:
 			// Show a compact pit history like: "L12(9G) L31(8G) ..."
 			std::wstring pitStr;
 			const int maxShow = 3;
-			const int n = (int)m_pitHistory.size();
+			const std::deque<FuelModel::PitEntry>& pitHistory = ir_fuel.pitHistory();
+			const int n = (int)pitHistory.size();
 			const int start = std::max(0, n - maxShow);
 			for (int i = start; i < n; ++i)
 			{
 				wchar_t b[64];
-				swprintf(b, _countof(b), L"L%d(%dG)", m_pitHistory[i].pitLap, m_pitHistory[i].greenLaps);
+				swprintf(b, _countof(b), L"L%d(%dG)", pitHistory[i].pitLap, pitHistory[i].greenLaps);
 				if (!pitStr.empty()) pitStr += L" ";
 				pitStr += b;
 			}
@@ -606,101 +587,18 @@ protected:
 	Microsoft::WRL::ComPtr<IDWriteTextFormat>	m_textFormatSmall;
 	Microsoft::WRL::ComPtr<IDWriteTextFormat>	m_textFormatLarge;
 	TextCache	m_text;
+	NumericText	m_num;
 
-	int			m_prevCurrentLap = 0;
-	float		m_prevRemainingFuel = 0.0f;
-	float		m_lapStartRemainingFuel = 0.0f;
-	std::deque<float>	m_fuelUsedLastLaps;
-	bool		m_isValidFuelLap = false;
 	float		m_fontSpacing = getGlobalFontSpacing();
 
-	// Worst-case tracking (valid green laps only)
-	float		m_maxFuelUsedLapSession = 0.0f;
-	float		m_maxFuelUsedLapStint = 0.0f;
-
-	// Pit history (pit lap + green-flag laps in-between)
-	struct PitEntry { int pitLap = 0; int greenLaps = 0; };
-	std::deque<PitEntry> m_pitHistory;
-	bool		m_prevOnPitRoad = false;
-	int			m_greenLapsSincePit = 0;
-
-		// Simple per-car+track fuel average cache
-		std::string	m_cacheKey;
-		bool		m_cacheSavedThisSession = false;
-
-		// Build a stable key like: t<trackId>_<sanitizedTrackCfg>_c<carId>
-		std::string buildFuelCacheKey() const
-		{
-			int trackId = ir_session.trackId;
-			std::string cfg = ir_session.trackConfigName;
-			int carId = 0;
-			if (ir_session.driverCarIdx >= 0)
-				carId = ir_session.cars[ir_session.driverCarIdx].carID;
-
-			if (trackId <= 0 || carId <= 0)
-				return std::string();
-
-			for (char& c : cfg)
-			{
-				if (!( (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ))
-					c = '_';
-			}
-			char buf[256];
-			_snprintf_s(buf, _countof(buf), _TRUNCATE, "t%d_%s_c%d", trackId, cfg.c_str(), carId);
-			return std::string(buf);
-		}
-
 private:
 	void ensureStyleBrushes()
 	{
 		if (!m_renderTarget) return;
 		if (m_bgBrush && m_panelBrush) return;
 
-		// Card background gradient (same palette as OverlayPit/OverlayFlags)
-		{
-			D2D1_GRADIENT_STOP stops[3] = {};
-			stops[0].position = 0.0f;  stops[0].color = D2D1::ColorF(0.16f, 0.18f, 0.22f, 0.95f);
-			stops[1].position = 0.45f; stops[1].color = D2D1::ColorF(0.06f, 0.07f, 0.09f, 0.95f);
-			stops[2].position = 1.0f;  stops[2].color = D2D1::ColorF(0.02f, 0.02f, 0.03f, 0.95f);
-
-			Microsoft::WRL::ComPtr<ID2D1GradientStopCollection> stopCollection;
-			HRESULT hr = m_renderTarget->CreateGradientStopCollection(
-				stops,
-				ARRAYSIZE(stops),
-				D2D1_GAMMA_2_2,
-				D2D1_EXTEND_MODE_CLAMP,
-				stopCollection.GetAddressOf()
-			);
-			if (SUCCEEDED(hr)) {
-				D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES props = {};
-				props.startPoint = D2D1_POINT_2F{ 0,0 };
-				props.endPoint = D2D1_POINT_2F{ 0,1 };
-				m_renderTarget->CreateLinearGradientBrush(props, stopCollection.Get(), m_bgBrush.GetAddressOf());
-			}
-		}
-
-		// Inner panel gradient (same palette as OverlayPit/OverlayFlags)
-		{
-			D2D1_GRADIENT_STOP stops[3] = {};
-			stops[0].position = 0.0f;  stops[0].color = D2D1::ColorF(0.08f, 0.09f, 0.11f, 0.92f);
-			stops[1].position = 0.55f; stops[1].color = D2D1::ColorF(0.04f, 0.045f, 0.055f, 0.92f);
-			stops[2].position = 1.0f;  stops[2].color = D2D1::ColorF(0.02f, 0.02f, 0.03f, 0.92f);
-
-			Microsoft::WRL::ComPtr<ID2D1GradientStopCollection> stopCollection;
-			HRESULT hr = m_renderTarget->CreateGradientStopCollection(
-				stops,
-				ARRAYSIZE(stops),
-				D2D1_GAMMA_2_2,
-				D2D1_EXTEND_MODE_CLAMP,
-				stopCollection.GetAddressOf()
-			);
-			if (SUCCEEDED(hr)) {
-				D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES props = {};
-				props.startPoint = D2D1_POINT_2F{ 0,0 };
-				props.endPoint = D2D1_POINT_2F{ 0,1 };
-				m_renderTarget->CreateLinearGradientBrush(props, stopCollection.Get(), m_panelBrush.GetAddressOf());
-			}
-		}
+		StyleBrushes::createLinearGradient(m_renderTarget.Get(), StyleBrushes::card(), m_bgBrush.ReleaseAndGetAddressOf());
+		StyleBrushes::createLinearGradient(m_renderTarget.Get(), StyleBrushes::panel(), m_panelBrush.ReleaseAndGetAddressOf());
 	}
 
 	// Styling brushes (cached; recreated on config change / enable)
@@ -25,9 +25,12 @@ SOFTWARE.
 #pragma once
 
 #include "Overlay.h"
+#include "ImageAssets.h"
 #include "Config.h"
 #include "OverlayDebug.h"
 #include "stub_data.h"
+#include "GhostLap.h"
+#include "GhostRecorder.h"
 #include <wincodec.h>
 #include <algorithm>
 #include <math.h>
@@ -62,30 +65,39 @@ class OverlayInputs : public Overlay
         {
             m_showSteeringWheel = g_cfg.getBool( m_name, "show_steering_wheel", true );
             m_showGhost = g_cfg.getBool( m_name, "show_ghost_data", false );
+            m_usePbGhost = g_cfg.getBool( m_name, "use_pb_ghost", true );
             m_selectedGhostFile = g_cfg.getString("General", "ghost_telemetry_file", "");
 
             const float wheelFrac = m_showSteeringWheel ? 0.2f : 0.0f;
             const float barFrac = m_showSteeringWheel ? 0.16f : 0.26f;
             const float graphFrac = std::max(0.1f, 1.0f - wheelFrac - barFrac);
 
-            const int horizontalWidthInt = std::max(1, (int)(m_width * graphFrac));
-            m_throttleVtx.resize( horizontalWidthInt );
-            m_brakeVtx.resize( horizontalWidthInt );
-            m_steeringVtx.resize( horizontalWidthInt );
-			m_brakeAbsFlags.resize( horizontalWidthInt );
-            m_ghostThrottleVtx.resize( horizontalWidthInt );
-            m_ghostBrakeVtx.resize( horizontalWidthInt );
-            m_ghostSteeringVtx.resize( horizontalWidthInt );
-            for( int i=0; i<horizontalWidthInt; ++i )
+            const int horizontalWidthInt = std::max(2, (int)(m_width * graphFrac));
+
+            // By default one sample is taken per rendered frame, one per horizontal pixel. In time-based
+            // mode the trace always spans trace_seconds at up to trace_sample_hz, independent of FPS and
+            // overlay width (the rate drops if there would be more samples than pixels).
+            m_timeBasedTrace = g_cfg.getBool( m_name, "time_based_trace", false );
+            int traceLen = horizontalWidthInt;
+            if( m_timeBasedTrace )
+            {
+                const float traceSeconds = std::max( 0.5f, std::min( 60.0f, g_cfg.getFloat( m_name, "trace_seconds", 5.0f ) ) );
+                const int sampleHz = std::max( 10, std::min( 240, g_cfg.getInt( m_name, "trace_sample_hz", 60 ) ) );
+                traceLen = std::max( 2, std::min( horizontalWidthInt, (int)(traceSeconds * (float)sampleHz) ) );
+                m_sampleInterval = (double)traceSeconds / (double)traceLen;
+            }
+            m_lastSampleTime = -1.0;
+
+            if( m_throttleTrace.size() != traceLen )
             {
-                m_throttleVtx[i].x = float(i);
-                m_brakeVtx[i].x = float(i);
-                m_steeringVtx[i].x = float(i);
-                m_ghostThrottleVtx[i].x = float(i);
-                m_ghostBrakeVtx[i].x = float(i);
-                m_ghostSteeringVtx[i].x = float(i);
+                m_throttleTrace.reset( traceLen, 0.0f );
+                m_brakeTrace.reset( traceLen, 0.0f );
+                m_steeringTrace.reset( traceLen, 0.5f );
+                m_ghostThrottleTrace.reset( traceLen, 0.0f );
+                m_ghostBrakeTrace.reset( traceLen, 0.0f );
+                m_ghostSteeringTrace.reset( traceLen, 0.5f );
+                m_brakeAbsFlags.assign( traceLen, 0 );
             }
-			std::fill(m_brakeAbsFlags.begin(), m_brakeAbsFlags.end(), 0);
             
             // Create text format for labels and values using centralized settings
             createGlobalTextFormat(1.0f, (int)DWRITE_FONT_WEIGHT_BOLD, "", m_textFormatBold);
@@ -141,14 +153,6 @@ class OverlayInputs : public Overlay
             // Calculate effective width for vertex arrays and scaling
             const float effectiveHorizontalWidth = horizontalEndX - horizontalStartX;
 
-            // Make code below safe against indexing into size-1 when sizes are zero
-            if( m_throttleVtx.empty() )
-                m_throttleVtx.resize( 1 );
-            if( m_brakeVtx.empty() )
-                m_brakeVtx.resize( 1 );
-            if( m_steeringVtx.empty() )
-                m_steeringVtx.resize( 1 );
-
             // Get current input values (use stub data in preview mode)
             const bool useStubData = StubDataManager::shouldUseStubData();
             const float currentThrottle = useStubData ? StubDataManager::getStubThrottle() : ir_Throttle.getFloat();
@@ -162,79 +166,104 @@ class OverlayInputs : public Overlay
             float lapPct = useStubData ? fmodf((float)GetTickCount64() * 0.00002f, 1.0f) : ir_LapDistPct.getFloat();
             if (lapPct < 0.0f) lapPct = 0.0f; if (lapPct > 1.0f) lapPct = 1.0f;
             float ghostThr = 0.0f, ghostBrk = 0.0f, ghostSteerNorm = 0.5f;
-            if (m_showGhost && !m_ghostSamples.empty())
+            // Our recorded best lap for this car/track takes precedence over the selected file
+            const GhostLap* ghost = nullptr;
+            if (m_showGhost)
+            {
+                if (m_usePbGhost && !useStubData && ir_ghost.personalBest().isOpen())
+                    ghost = &ir_ghost.personalBest();
+                else if (m_ghostActive)
+                    ghost = &m_ghost;
+            }
+            // A new personal best, or switching between ghosts, starts the ghost traces afresh
+            // rather than scrolling the old lap out
+            const bool pbGhost = ghost == &ir_ghost.personalBest();
+            if (ghost != m_tracedGhost || (pbGhost && ir_ghost.generation() != m_tracedGhostGeneration))
             {
-                // binary search by LapDistPct
-                int lo = 0, hi = (int)m_ghostSamples.size()-1;
-                while (lo < hi)
+                const int n = m_ghostThrottleTrace.size();
+                m_ghostThrottleTrace.reset( n, 0.0f );
+                m_ghostBrakeTrace.reset( n, 0.0f );
+                m_ghostSteeringTrace.reset( n, 0.5f );
+                m_tracedGhost = ghost;
+                m_tracedGhostGeneration = ir_ghost.generation();
+            }
+            if (ghost)
+            {
+                const GhostLap::Sample g = ghost->sample(lapPct);
+                ghostThr = g.throttle;
+                ghostBrk = g.brake;
+                ghostSteerNorm = 0.5f - std::max(-1.0f, std::min(1.0f, g.steerAngle / (3.14159f * 0.5f))) * 0.5f;
+            }
+
+            // How many samples to append this frame: always one in per-frame mode, otherwise however many
+            // sample intervals of sim time have elapsed (zero while paused, several at low FPS).
+            int samplesDue = 1;
+            if( m_timeBasedTrace )
+            {
+                const double now = useStubData ? (double)GetTickCount64() * 0.001 : ir_SessionTime.getDouble();
+                const double traceSpan = m_sampleInterval * (double)m_throttleTrace.size();
+                if( m_lastSampleTime < 0.0 || now < m_lastSampleTime || now - m_lastSampleTime > traceSpan )
+                {
+                    // First frame, session/replay jump, or a gap longer than the whole trace
+                    m_lastSampleTime = now;
+                }
+                else
                 {
-                    int mid = (lo+hi+1)/2;
-                    if (m_ghostSamples[mid].lapPct <= lapPct) lo = mid; else hi = mid-1;
+                    samplesDue = (int)((now - m_lastSampleTime) / m_sampleInterval);
+                    m_lastSampleTime += (double)samplesDue * m_sampleInterval;
                 }
-                const GhostSample& a = m_ghostSamples[lo];
-                const GhostSample& b = (lo+1 < (int)m_ghostSamples.size()) ? m_ghostSamples[lo+1] : a;
-                float t = (b.lapPct > a.lapPct) ? (lapPct - a.lapPct) / (b.lapPct - a.lapPct) : 0.0f;
-                ghostThr = a.throttle * (1.0f - t) + b.throttle * t;
-                ghostBrk = a.brake * (1.0f - t) + b.brake * t;
-                float sA = a.steerAngle, sB = b.steerAngle;
-                float s = sA * (1.0f - t) + sB * t;
-                float sn = 0.5f - std::max(-1.0f, std::min(1.0f, s / (3.14159f * 0.5f))) * 0.5f;
-                ghostSteerNorm = sn;
             }
 
-            // Advance input vertices for horizontal graphs
+            // Append samples to the input traces. Flags share the brake trace's head.
+            if( samplesDue > 0 )
             {
-                for( int i=0; i<(int)m_throttleVtx.size()-1; ++i )
-                    m_throttleVtx[i].y = m_throttleVtx[i+1].y;
-                m_throttleVtx[(int)m_throttleVtx.size()-1].y = currentThrottle;
-
-                for( int i=0; i<(int)m_brakeVtx.size()-1; ++i )
-                    m_brakeVtx[i].y = m_brakeVtx[i+1].y;
-                m_brakeVtx[(int)m_brakeVtx.size()-1].y = currentBrake;
-
-				// Track ABS activation per-sample to persist colored segments
-				if( m_brakeAbsFlags.size() != m_brakeVtx.size() )
-					m_brakeAbsFlags.resize( m_brakeVtx.size(), 0 );
-				for( int i=0; i<(int)m_brakeAbsFlags.size()-1; ++i )
-					m_brakeAbsFlags[i] = m_brakeAbsFlags[i+1];
-				const unsigned char absNow = (absActive && currentBrake > 0.02f) ? 1u : 0u;
-				if( !m_brakeAbsFlags.empty() )
-					m_brakeAbsFlags[(int)m_brakeAbsFlags.size()-1] = absNow;
-
                 float s = currentSteeringAngle / (3.14159f * 0.5f); 
                 if( s < -1.0f ) s = -1.0f;
                 if( s > 1.0f ) s = 1.0f;
                 const float steeringNorm = 0.5f - s * 0.5f;
-                for( int i=0; i<(int)m_steeringVtx.size()-1; ++i )
-                    m_steeringVtx[i].y = m_steeringVtx[i+1].y;
-                m_steeringVtx[(int)m_steeringVtx.size()-1].y = steeringNorm;
-            }
 
-            // Advance ghost vertices similarly so we have a time-series trace aligned to current lap position sample
-            if (m_showGhost && m_ghostActive)
-            {
-                for( int i=0; i<(int)m_ghostThrottleVtx.size()-1; ++i )
-                    m_ghostThrottleVtx[i].y = m_ghostThrottleVtx[i+1].y;
-                if (!m_ghostThrottleVtx.empty())
-                    m_ghostThrottleVtx[(int)m_ghostThrottleVtx.size()-1].y = ghostThr;
-
-                for( int i=0; i<(int)m_ghostBrakeVtx.size()-1; ++i )
-                    m_ghostBrakeVtx[i].y = m_ghostBrakeVtx[i+1].y;
-                if (!m_ghostBrakeVtx.empty())
-                    m_ghostBrakeVtx[(int)m_ghostBrakeVtx.size()-1].y = ghostBrk;
-
-                for( int i=0; i<(int)m_ghostSteeringVtx.size()-1; ++i )
-                    m_ghostSteeringVtx[i].y = m_ghostSteeringVtx[i+1].y;
-                if (!m_ghostSteeringVtx.empty())
-                    m_ghostSteeringVtx[(int)m_ghostSteeringVtx.size()-1].y = ghostSteerNorm;
+				// Track ABS activation per-sample to persist colored segments
+				const unsigned char absNow = (absActive && currentBrake > 0.02f) ? 1u : 0u;
+				for( int i=0; i<samplesDue; ++i )
+					m_brakeAbsFlags[(m_brakeTrace.head + i) % m_brakeTrace.size()] = absNow;
+
+                m_throttleTrace.push( currentThrottle, samplesDue );
+                m_brakeTrace.push( currentBrake, samplesDue );
+                m_steeringTrace.push( steeringNorm, samplesDue );
+
+                // Ghost traces advance in lockstep so they stay aligned to the current lap position sample
+                if (ghost)
+                {
+                    m_ghostThrottleTrace.push( ghostThr, samplesDue );
+                    m_ghostBrakeTrace.push( ghostBrk, samplesDue );
+                    m_ghostSteeringTrace.push( ghostSteerNorm, samplesDue );
+                }
             }
 
             const float thickness = g_cfg.getFloat( m_name, "line_thickness", 2.0f );
             
-            // Transform function for horizontal graphs
-            auto vtx2coord = [&]( const float2& v )->float2 {
-                float scaledX = (v.x / (float)m_throttleVtx.size()) * effectiveHorizontalWidth;
-                return float2( horizontalStartX + scaledX + 0.5f, h - 0.5f*thickness - v.y*(h*0.8f-thickness) - h*0.1f );
+            // Transform function for horizontal graphs (k = sample index, oldest first)
+            const float xStep = effectiveHorizontalWidth / (float)std::max( 1, m_throttleTrace.size() - 1 );
+            auto vtx2coord = [&]( int k, float y )->float2 {
+                return float2( horizontalStartX + (float)k * xStep + 0.5f, h - 0.5f*thickness - y*(h*0.8f-thickness) - h*0.1f );
+            };
+
+            // Visit a trace oldest-first as its two contiguous runs [head..n) and [0..head).
+            // f(k, i) receives the chronological index k and the storage slot i.
+            auto forEachSample = []( const TraceRing& r, auto&& f ) {
+                const int n = r.size();
+                int k = 0;
+                for( int i=r.head; i<n; ++i, ++k ) f( k, i );
+                for( int i=0; i<r.head; ++i, ++k ) f( k, i );
+            };
+            auto addTrace = [&]( ID2D1GeometrySink* sink, const TraceRing& r ) {
+                forEachSample( r, [&]( int k, int i ) {
+                    if( k == 0 )
+                        sink->BeginFigure( vtx2coord(k, r.y[i]), D2D1_FIGURE_BEGIN_HOLLOW );
+                    else
+                        sink->AddLine( vtx2coord(k, r.y[i]) );
+                });
+                sink->EndFigure( D2D1_FIGURE_END_OPEN );
             };
 
             m_renderTarget->BeginDraw();
@@ -372,7 +401,6 @@ class OverlayInputs : public Overlay
             }
 
             // SECTION 1: Horizontal Throttle/Brake Graphs
-            if( !m_throttleVtx.empty() && !m_brakeVtx.empty() )
             {
                 // Telemetry background with subtle grid lines and black border (#1f1f1f bg, #121212 lines)
                 {
@@ -405,8 +433,7 @@ class OverlayInputs : public Overlay
                 m_d2dFactory->CreatePathGeometry( &throttleFillPath );
                 throttleFillPath->Open( &throttleFillSink );
                 throttleFillSink->BeginFigure( float2(horizontalStartX, h*0.9f), D2D1_FIGURE_BEGIN_FILLED );
-                for( int i=0; i<(int)m_throttleVtx.size(); ++i )
-                    throttleFillSink->AddLine( vtx2coord(m_throttleVtx[i]) );
+                forEachSample( m_throttleTrace, [&]( int k, int i ) { throttleFillSink->AddLine( vtx2coord(k, m_throttleTrace.y[i]) ); } );
                 throttleFillSink->AddLine( float2(horizontalEndX, h*0.9f) );
                 throttleFillSink->EndFigure( D2D1_FIGURE_END_CLOSED );
                 throttleFillSink->Close();
@@ -417,8 +444,7 @@ class OverlayInputs : public Overlay
                 m_d2dFactory->CreatePathGeometry( &brakeFillPath );
                 brakeFillPath->Open( &brakeFillSink );
                 brakeFillSink->BeginFigure( float2(horizontalStartX, h*0.9f), D2D1_FIGURE_BEGIN_FILLED );
-                for( int i=0; i<(int)m_brakeVtx.size(); ++i )
-                    brakeFillSink->AddLine( vtx2coord(m_brakeVtx[i]) );
+                forEachSample( m_brakeTrace, [&]( int k, int i ) { brakeFillSink->AddLine( vtx2coord(k, m_brakeTrace.y[i]) ); } );
                 brakeFillSink->AddLine( float2(horizontalEndX, h*0.9f) );
                 brakeFillSink->EndFigure( D2D1_FIGURE_END_CLOSED );
                 brakeFillSink->Close();
@@ -434,10 +460,7 @@ class OverlayInputs : public Overlay
                 Microsoft::WRL::ComPtr<ID2D1GeometrySink>  throttleLineSink;
                 m_d2dFactory->CreatePathGeometry( &throttleLinePath );
                 throttleLinePath->Open( &throttleLineSink );
-                throttleLineSink->BeginFigure( vtx2coord(m_throttleVtx[0]), D2D1_FIGURE_BEGIN_HOLLOW );
-                for( int i=1; i<(int)m_throttleVtx.size(); ++i )
-                    throttleLineSink->AddLine( vtx2coord(m_throttleVtx[i]) );
-                throttleLineSink->EndFigure( D2D1_FIGURE_END_OPEN );
+                addTrace( throttleLineSink.Get(), m_throttleTrace );
                 throttleLineSink->Close();
 
 				// Brake (line) with persistent ABS-colored segments
@@ -449,55 +472,50 @@ class OverlayInputs : public Overlay
 				brakeAbsOnPath->Open( &brakeAbsOnSink );
 				m_d2dFactory->CreatePathGeometry( &brakeAbsOffPath );
 				brakeAbsOffPath->Open( &brakeAbsOffSink );
-				if( !m_brakeVtx.empty() && m_brakeAbsFlags.size() == m_brakeVtx.size() )
 				{
-					auto flushSegment = [&](int s, int e, bool absOn)
-					{
-						if( s < 0 || e < s ) return;
-						Microsoft::WRL::ComPtr<ID2D1GeometrySink>& sink = absOn ? brakeAbsOnSink : brakeAbsOffSink;
-						sink->BeginFigure( vtx2coord(m_brakeVtx[s]), D2D1_FIGURE_BEGIN_HOLLOW );
-						for( int i = s + 1; i <= e; ++i )
-							sink->AddLine( vtx2coord(m_brakeVtx[i]) );
-						sink->EndFigure( D2D1_FIGURE_END_OPEN );
-					};
-					int startIdx = 0;
-					bool currentFlag = m_brakeAbsFlags[0] != 0;
-					for( int i = 1; i < (int)m_brakeVtx.size(); ++i )
-					{
-						bool f = m_brakeAbsFlags[i] != 0;
-						if( f != currentFlag )
+					bool currentFlag = false;
+					ID2D1GeometrySink* sink = nullptr;
+					forEachSample( m_brakeTrace, [&]( int k, int i ) {
+						const float2 p = vtx2coord( k, m_brakeTrace.y[i] );
+						const bool f = m_brakeAbsFlags[i] != 0;
+						if( !sink || f != currentFlag )
 						{
-							// Include the transition point in the previous segment
-							flushSegment( startIdx, i, currentFlag );
-							startIdx = i;
+							if( sink )
+							{
+								// Include the transition point in the previous segment
+								sink->AddLine( p );
+								sink->EndFigure( D2D1_FIGURE_END_OPEN );
+							}
 							currentFlag = f;
+							sink = f ? brakeAbsOnSink.Get() : brakeAbsOffSink.Get();
+							sink->BeginFigure( p, D2D1_FIGURE_BEGIN_HOLLOW );
 						}
-					}
-					flushSegment( startIdx, (int)m_brakeVtx.size() - 1, currentFlag );
+						else
+						{
+							sink->AddLine( p );
+						}
+					});
+					if( sink )
+						sink->EndFigure( D2D1_FIGURE_END_OPEN );
 				}
 				brakeAbsOnSink->Close();
 				brakeAbsOffSink->Close();
 
                 // Ghost overlays (draw after fills but before live lines so they appear beneath live)
-                if (m_showGhost && m_ghostActive && effectiveHorizontalWidth > 1.0f)
+                if (ghost && effectiveHorizontalWidth > 1.0f)
                 {
-                    auto buildLine = [&](const std::vector<float2>& src, Microsoft::WRL::ComPtr<ID2D1PathGeometry1>& outPath){
+                    auto buildLine = [&](const TraceRing& src, Microsoft::WRL::ComPtr<ID2D1PathGeometry1>& outPath){
                         m_d2dFactory->CreatePathGeometry(&outPath);
                         Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
                         outPath->Open(&sink);
-                        if (!src.empty())
-                        {
-                            sink->BeginFigure(vtx2coord(src[0]), D2D1_FIGURE_BEGIN_HOLLOW);
-                            for (int i=1;i<(int)src.size();++i) sink->AddLine(vtx2coord(src[i]));
-                            sink->EndFigure(D2D1_FIGURE_END_OPEN);
-                        }
+                        addTrace(sink.Get(), src);
                         sink->Close();
                     };
 
                     Microsoft::WRL::ComPtr<ID2D1PathGeometry1> gThr, gBrk, gSteer;
-                    buildLine(m_ghostThrottleVtx, gThr);
-                    buildLine(m_ghostBrakeVtx, gBrk);
-                    if (g_cfg.getBool(m_name, "show_steering_line", false)) buildLine(m_ghostSteeringVtx, gSteer);
+                    buildLine(m_ghostThrottleTrace, gThr);
+                    buildLine(m_ghostBrakeTrace, gBrk);
+                    if (g_cfg.getBool(m_name, "show_steering_line", false)) buildLine(m_ghostSteeringTrace, gSteer);
 
                     const float ghostThickness = std::max(1.0f, thickness);
                     // Fixed, bright ghost colors: throttle=light bright blue, brake=light bright orange, steering=white
@@ -522,16 +540,13 @@ class OverlayInputs : public Overlay
 				m_renderTarget->DrawGeometry( brakeAbsOnPath.Get(), m_brush.Get(), thickness );
 
                 // Optional steering angle line (white)
-                if( g_cfg.getBool( m_name, "show_steering_line", false ) && !m_steeringVtx.empty() )
+                if( g_cfg.getBool( m_name, "show_steering_line", false ) )
                 {
                     Microsoft::WRL::ComPtr<ID2D1PathGeometry1> steerLinePath;
                     Microsoft::WRL::ComPtr<ID2D1GeometrySink>  steerLineSink;
                     m_d2dFactory->CreatePathGeometry( &steerLinePath );
                     steerLinePath->Open( &steerLineSink );
-                    steerLineSink->BeginFigure( vtx2coord(m_steeringVtx[0]), D2D1_FIGURE_BEGIN_HOLLOW );
-                    for( int i=1; i<(int)m_steeringVtx.size(); ++i )
-                        steerLineSink->AddLine( vtx2coord(m_steeringVtx[i]) );
-                    steerLineSink->EndFigure( D2D1_FIGURE_END_OPEN );
+                    addTrace( steerLineSink.Get(), m_steeringTrace );
                     steerLineSink->Close();
 
                     m_brush->SetColor( g_cfg.getFloat4( m_name, "steering_line_col", float4(1.0f,1.0f,1.0f,0.9f) ) );
@@ -636,8 +651,9 @@ class OverlayInputs : public Overlay
                 D2D1_MATRIX_3X2_F previousTransform;
                 m_renderTarget->GetTransform(&previousTransform);
                 m_renderTarget->SetTransform(rotation);
-                if (useImageWheel && m_wheelBitmap) {
-                    D2D1_SIZE_F bmpSize = m_wheelBitmap->GetSize();
+                ID2D1Bitmap* wheelBitmap = useImageWheel ? m_wheelBitmap.Get(m_renderTarget.Get()) : nullptr;
+                if (wheelBitmap) {
+                    D2D1_SIZE_F bmpSize = wheelBitmap->GetSize();
                     float scale = 1.0f;
                     if (bmpSize.width > 0 && bmpSize.height > 0) {
                         const float maxDim = wheelRadius * 2.0f;
@@ -650,7 +666,7 @@ class OverlayInputs : public Overlay
                     const float left = wheelCenterX - drawW * 0.5f;
                     const float top  = wheelCenterY - drawH * 0.5f;
                     D2D1_RECT_F dest = { left, top, left + drawW, top + drawH };
-                    m_renderTarget->DrawBitmap(m_wheelBitmap.Get(), dest);
+                    m_renderTarget->DrawBitmap(wheelBitmap, dest);
                 } else {
                     m_brush->SetColor( columnColor );
                     m_renderTarget->FillRectangle( columnRect, m_brush.Get() );
@@ -707,23 +723,49 @@ class OverlayInputs : public Overlay
 
     protected:
 
-        std::vector<float2> m_throttleVtx;
-        std::vector<float2> m_brakeVtx;
-        std::vector<float2> m_steeringVtx;
-		std::vector<unsigned char> m_brakeAbsFlags;
-        std::vector<float2> m_ghostThrottleVtx;
-        std::vector<float2> m_ghostBrakeVtx;
-        std::vector<float2> m_ghostSteeringVtx;
+        // Fixed-size circular trace. 'head' is both the oldest sample and the next slot to write,
+        // so appending is O(1) and chronological order is [head..n) followed by [0..head).
+        struct TraceRing
+        {
+            std::vector<float> y;
+            int head = 0;
+
+            int  size() const { return (int)y.size(); }
+            void reset( int n, float v ) { y.assign( std::max(1, n), v ); head = 0; }
+            void push( float v ) { y[head] = v; if( ++head == (int)y.size() ) head = 0; }
+
+            // Append 'count' samples ramping linearly from the newest stored value to v
+            void push( float v, int count )
+            {
+                const float from = y[head ? head-1 : (int)y.size()-1];
+                for( int j=1; j<=count; ++j )
+                    push( from + (v - from) * (float)j / (float)count );
+            }
+        };
+
+        TraceRing m_throttleTrace;
+        TraceRing m_brakeTrace;
+        TraceRing m_steeringTrace;
+		std::vector<unsigned char> m_brakeAbsFlags;    // indexed like m_brakeTrace.y
+        TraceRing m_ghostThrottleTrace;
+        TraceRing m_ghostBrakeTrace;
+        TraceRing m_ghostSteeringTrace;
+        bool   m_timeBasedTrace = false;
+        double m_sampleInterval = 1.0 / 60.0;
+        double m_lastSampleTime = -1.0;
         Microsoft::WRL::ComPtr<IDWriteTextFormat> m_textFormatBold;
         Microsoft::WRL::ComPtr<IDWriteTextFormat> m_textFormatPercent;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_wheelBitmap;
+        ImageAssets::Ref m_wheelBitmap;
         bool m_showSteeringWheel = true;
         bool m_showGhost = false;
+        bool m_usePbGhost = true;
 
-        struct GhostSample { float lapPct; float throttle; float brake; float steerAngle; };
-        std::vector<GhostSample> m_ghostSamples;
+        GhostLap m_ghost;
         std::string m_selectedGhostFile;
+        std::string m_loadedGhostFile;
         bool m_ghostActive = false;
+        const GhostLap* m_tracedGhost = nullptr;    // ghost the ghost traces were filled from
+        unsigned m_tracedGhostGeneration = 0;
 
         void loadSteeringWheelBitmap()
         {
@@ -731,125 +773,30 @@ class OverlayInputs : public Overlay
             const std::string mode = g_cfg.getString(m_name, "steering_wheel", "builtin");
             if (mode == "builtin") return;
             std::string fileName;
-            if (mode == "moza_ks") fileName = "assets/wheels/moza_ks.png";
-            if (mode == "moza_rs_v2") fileName = "assets/wheels/moza_rs_v2.png";
+            if (mode == "moza_ks") fileName = "assets\\wheels\\moza_ks.png";
+            if (mode == "moza_rs_v2") fileName = "assets\\wheels\\moza_rs_v2.png";
             if (fileName.empty()) return;
 
-            auto fileExistsW = [](const std::wstring& path) -> bool {
-                DWORD a = GetFileAttributesW(path.c_str());
-                return a != INVALID_FILE_ATTRIBUTES && (a & FILE_ATTRIBUTE_DIRECTORY) == 0;
-            };
-            auto getExecutableDirW = []() -> std::wstring {
-                wchar_t path[MAX_PATH] = {0};
-                GetModuleFileNameW(NULL, path, MAX_PATH);
-                wchar_t* last = wcsrchr(path, L'\\');
-                if (last) *last = 0;
-                return std::wstring(path);
-            };
-            auto resolveAssetPath = [&](const std::wstring& relative) -> std::wstring {
-                const std::wstring exeDir = getExecutableDirW();
-                std::wstring repo = exeDir + L"\\..\\..\\" + relative;
-                if (fileExistsW(repo)) return repo;
-                std::wstring local = exeDir + L"\\" + relative;
-                if (fileExistsW(local)) return local;
-                return relative;
-            };
-
-            if (!m_renderTarget.Get()) return;
-
-            std::wstring pathW = resolveAssetPath(toWide(fileName));
-            Microsoft::WRL::ComPtr<IWICImagingFactory> wic;
-            if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wic)))) return;
-            Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
-            if (FAILED(wic->CreateDecoderFromFilename(pathW.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder))) return;
-            Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
-            if (FAILED(decoder->GetFrame(0, &frame))) return;
-            Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
-            if (FAILED(wic->CreateFormatConverter(&converter))) return;
-            if (FAILED(converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut))) return;
-            m_renderTarget->CreateBitmapFromWicBitmap(converter.Get(), nullptr, &m_wheelBitmap);
+            m_wheelBitmap = ImageAssets::instance().acquire(toWide(fileName));
         }
 
         void loadGhostIfNeeded()
         {
-            // Check config flag
-            if (!m_showGhost) { m_ghostSamples.clear(); m_ghostActive = false; return; }
-            // Resolve selected file
-            if (m_selectedGhostFile.empty()) { m_ghostSamples.clear(); m_ghostActive = false; return; }
-
-            // Try to load CSV from repo or local
-            std::wstring path = resolveAssetPathW(L"assets\\tracks\\telemetry\\" + toWide(m_selectedGhostFile));
-            std::string csv;
-            if (!loadFileW(path, csv)) { m_ghostSamples.clear(); m_ghostActive = false; return; }
-
-            // Parse header
-            m_ghostSamples.clear();
-            m_ghostSamples.reserve(4096);
-            int idxLapPct = -1, idxThr = -1, idxBrk = -1, idxSteer = -1;
-            size_t pos = 0, lineEnd = csv.find('\n', pos);
-            if (lineEnd == std::string::npos) { m_ghostActive = false; return; }
-            std::string header = csv.substr(0, lineEnd);
-            {
-                // split by comma
-                std::vector<std::string> cols; cols.reserve(32);
-                size_t s = 0;
-                while (s <= header.size()) {
-                    size_t c = header.find(',', s);
-                    if (c == std::string::npos) c = header.size();
-                    cols.push_back(header.substr(s, c - s));
-                    s = c + 1;
-                }
-                for (int i=0;i<(int)cols.size();++i) {
-                    const std::string& k = cols[i];
-                    if (k == "LapDistPct") idxLapPct = i;
-                    else if (k == "Throttle") idxThr = i;
-                    else if (k == "Brake") idxBrk = i;
-                    else if (k == "SteeringWheelAngle") idxSteer = i;
-                }
-            }
-            if (idxLapPct < 0 || idxThr < 0 || idxBrk < 0 || idxSteer < 0) { m_ghostActive = false; return; }
-
-            // Parse rows (simple, robust)
-            pos = lineEnd + 1;
-            while (pos < csv.size())
-            {
-                lineEnd = csv.find('\n', pos);
-                size_t len = (lineEnd == std::string::npos) ? csv.size() - pos : (lineEnd - pos);
-                if (len == 0) { if (lineEnd == std::string::npos) break; pos = lineEnd + 1; continue; }
-                std::string row = csv.substr(pos, len);
-                pos = (lineEnd == std::string::npos) ? csv.size() : (lineEnd + 1);
-
-                // Split
-                std::vector<std::string> fields; fields.reserve(32);
-                size_t s = 0;
-                while (s <= row.size()) {
-                    size_t c = row.find(',', s);
-                    if (c == std::string::npos) c = row.size();
-                    fields.push_back(row.substr(s, c - s));
-                    s = c + 1;
-                }
-                auto parseF = [](const std::string& v)->float { return v.empty() ? 0.0f : (float)atof(v.c_str()); };
-                if ((int)fields.size() > std::max(std::max(idxLapPct, idxThr), std::max(idxBrk, idxSteer)))
-                {
-                    GhostSample gs;
-                    gs.lapPct = parseF(fields[idxLapPct]);
-                    gs.throttle = parseF(fields[idxThr]);
-                    gs.brake = parseF(fields[idxBrk]);
-                    gs.steerAngle = parseF(fields[idxSteer]); // radians per CSV header semantics
-                    if (gs.lapPct >= 0.0f && gs.lapPct <= 1.0f)
-                        m_ghostSamples.push_back(gs);
-                }
-                if ((int)m_ghostSamples.size() > 200000) break; // safety cap
-            }
-
-            // Ensure sorted by lapPct
-            std::sort(m_ghostSamples.begin(), m_ghostSamples.end(), [](const GhostSample& a, const GhostSample& b){ return a.lapPct < b.lapPct; });
-            // Deduplicate equal lapPct by keeping last
-            std::vector<GhostSample> compact;
-            compact.reserve(m_ghostSamples.size());
-            float lastPct = -1.0f;
-            for (const auto& s : m_ghostSamples) { if (compact.empty() || s.lapPct > lastPct) { compact.push_back(s); lastPct = s.lapPct; } else { compact.back() = s; } }
-            m_ghostSamples.swap(compact);
-            m_ghostActive = !m_ghostSamples.empty();
+            const std::string want = m_showGhost ? m_selectedGhostFile : std::string();
+            if (want == m_loadedGhostFile)
+                return;
+            m_loadedGhostFile = want;
+
+            m_ghost.close();
+            m_ghostActive = false;
+            m_tracedGhost = nullptr;
+            if (want.empty())
+                return;
+
+            // .ifg files are mapped directly; CSV exports go through their converted binary cache
+            const std::wstring path = resolveAssetPathW(L"assets\\tracks\\telemetry\\" + toWide(want));
+            m_ghostActive = m_ghost.open(path);
+            if (!m_ghostActive)
+                m_loadedGhostFile.clear();  // retry on the next config change
         }
 };
\ No newline at end of file
@@ -26,6 +26,7 @@ SOFTWARE.
 
 #include "Overlay.h"
 #include "iracing.h"
+#include "RaceState.h"
 #include "Config.h"
 #include "util.h"
 #include "stub_data.h"
@@ -115,38 +116,42 @@ class OverlayRadar : public Overlay
             }
             else if (selfIdx >= 0)
             {
+                const RaceState& rs = ir_race;
                 const float trackLenM = ir_session.trackLengthMeters;
-                const float selfPct = ir_CarIdxLapDistPct.getFloat(selfIdx);
-                const float selfEst = ir_CarIdxEstTime.getFloat(selfIdx);
-                for (int i=0; i<IR_MAX_CARS; ++i)
+                const float selfEst = rs.estTime[selfIdx];
+
+                // Only the nearest eligible car on either side matters. The shared track-order index
+                // hands them to us nearest first, so this stops after a car or two instead of
+                // scanning the field.
+                auto eligible = [&](int i)
                 {
-                    if (i == selfIdx) continue;
                     const Car& car = ir_session.cars[i];
-                    if (car.isSpectator || car.carNumber < 0) continue;
                     // Ignore cars that are on pit road between the cones
-                    if (ir_CarIdxOnPitRoad.getBool(i)) continue;
+                    return !car.isSpectator && car.carNumber >= 0 && !rs.onPitRoad[i];
+                };
+                int nearest[2] = { -1, -1 };
+                rs.order.walkAhead(selfIdx, 0.5f, [&](int i, float) { if (eligible(i)) nearest[0] = i; return nearest[0] < 0; });
+                rs.order.walkBehind(selfIdx, 0.5f, [&](int i, float) { if (eligible(i)) nearest[1] = i; return nearest[1] < 0; });
+
+                for (int i : nearest)
+                {
+                    if (i < 0) continue;
 
                     float delta = 0.0f;
-                    int lapDelta = ir_CarIdxLap.getInt(i) - ir_CarIdxLap.getInt(selfIdx);
 
                     // Prefer lap percent * track length when available, otherwise fallback to EstTime * speed
                     float alongM = 0.0f; // forward(+)/back(-) in meters
-                    const float otherPct = ir_CarIdxLapDistPct.getFloat(i);
                     if (trackLenM > 0.1f)
                     {
-                        float dPct = otherPct - selfPct;
-                        if (fabsf(dPct) > 0.5f) dPct += (dPct > 0 ? -1.0f : 1.0f);
-                        alongM = dPct * trackLenM;
+                        alongM = rs.relPct[i] * trackLenM;
                     }
                     else
                     {
-                        const float otherEst = ir_CarIdxEstTime.getFloat(i);
-                        const bool wrap = fabsf(otherPct - selfPct) > 0.5f;
-                        if (wrap)
+                        const float otherEst = rs.estTime[i];
+                        if (rs.relWrap[i] != 0)
                         {
                             const float L = ir_estimateLaptime();
                             delta     = selfEst > otherEst ? (otherEst-selfEst)+L : (otherEst-selfEst)-L;
-                            lapDelta += selfEst > otherEst ? -1 : 1;
                         }
                         else
                         {
@@ -28,10 +28,11 @@ SOFTWARE.
 #include <algorithm>
 #include <string>
 #include <format>
-#include <unordered_map>
 #include <cmath>
 #include "Overlay.h"
+#include "ImageAssets.h"
 #include "iracing.h"
+#include "RaceState.h"
 #include "ClassColors.h"
 #include "Config.h"
 #include "Units.h"
@@ -51,7 +52,7 @@ class OverlayRelative : public Overlay
 
     protected:
 
-        enum class Columns { POSITION, CAR_NUMBER, NAME, POSITIONS_GAINED, DELTA, LICENSE, SAFETY_RATING, IRATING, IR_PRED, PIT, LAST, TIRE_COMPOUND };
+        enum class Columns { POSITION, CAR_NUMBER, NAME, POSITIONS_GAINED, DELTA, LICENSE, SAFETY_RATING, IRATING, IR_PRED, PIT, LAST, SECTORS, TIRE_COMPOUND };
 
         std::string tireCompoundToString(int compound) const
         {
@@ -128,6 +129,9 @@ class OverlayRelative : public Overlay
             const float lastColScale = g_cfg.getFloat( m_name, "last_col_scale", 2.0f );
             if( g_cfg.getBool(m_name, "show_last", true) )
                 m_columns.add( (int)Columns::LAST,       computeTextExtent( L"99.99", m_dwriteFactory.Get(), m_textFormat.Get() ).x * lastColScale, fontSize/2 );
+
+            if( g_cfg.getBool(m_name, "show_sectors", false) )
+                m_columns.add( (int)Columns::SECTORS,    computeTextExtent( L"99.99", m_dwriteFactory.Get(), m_textFormat.Get() ).x, fontSize/2 );
             
             // Replay sessions often have unreliable/empty delta timing (shows up as 0.0). Allow user to hide it in replay.
             const bool includeDelta = !ir_session.isReplay || g_cfg.getBool(m_name, "show_delta_in_replay", false);
@@ -155,10 +159,7 @@ class OverlayRelative : public Overlay
             };
             std::vector<CarInfo> relatives;
             relatives.reserve( IR_MAX_CARS );
-            const float ownClassEstLaptime = ir_session.cars[ir_session.driverCarIdx].carClassEstLapTime;
-            const int lapcountSelf = ir_Lap.getInt();
-            const float selfLapDistPct = ir_LapDistPct.getFloat();
-            const float SelfEstLapTime = ir_CarIdxEstTime.getFloat(ir_session.driverCarIdx);
+            const RaceState& rs = ir_race;
             // Use stub data in preview mode
             const bool useStubData = StubDataManager::shouldUseStubData();
             if (useStubData) {
@@ -168,6 +169,7 @@ class OverlayRelative : public Overlay
             // Apply global opacity
             const float globalOpacity = getGlobalOpacity();
             
+            bool inTrackOrder = false;
             if (useStubData) {
                 // Generate stub data for preview mode using centralized data
                 auto relativeData = StubDataManager::getRelativeData();
@@ -187,75 +189,52 @@ class OverlayRelative : public Overlay
                     relatives.push_back(ci);
                 }
             } else {
-                // Populate cars with the ones for which a relative/delta comparison is valid
-                for( int i=0; i<IR_MAX_CARS; ++i )
+                // Populate cars with the ones for which a relative/delta comparison is valid, already
+                // in track order around us
+                int around[IR_MAX_CARS];
+                int selfPos = -1;
+                int numAround = rs.order.around( ir_session.driverCarIdx, around, selfPos );
+                inTrackOrder = selfPos >= 0;
+                if( !inTrackOrder )
                 {
+                    // We're not in the world (garage, spectating): list everyone, sorted below
+                    numAround = IR_MAX_CARS;
+                    for( int i=0; i<IR_MAX_CARS; ++i )
+                        around[i] = i;
+                }
+                for( int k=0; k<numAround; ++k )
+                {
+                    const int  i   = around[k];
                     const Car& car = ir_session.cars[i];
 
-                    const int lapcountCar = ir_CarIdxLap.getInt(i);
-
-                    if( lapcountCar >= 0 && !car.isSpectator && car.carNumber>=0 )
+                    if( rs.lap[i] >= 0 && !car.isSpectator && car.carNumber>=0 )
                     {
                         // Add the pace car only under yellow or initial pace lap
-                        if( car.isPaceCar && !(ir_SessionFlags.getInt() & (irsdk_caution|irsdk_cautionWaving)) && !ir_isPreStart() )
+                        if( car.isPaceCar && !(ir_SessionFlags.getInt() & (irsdk_caution|irsdk_cautionWaving)) && !rs.isPreStart )
                             continue;
 
-                        // If the other car is up to half a lap in front, we consider the delta 'ahead', otherwise 'behind'.
-
-                        float delta = 0;
-                        int   lapDelta = lapcountCar - lapcountSelf;
-
-                        const float LClassRatio = car.carClassEstLapTime / ownClassEstLaptime;
-                        const float CarEstLapTime = ir_CarIdxEstTime.getFloat(i) / LClassRatio;
-                        const float carLapDistPct = ir_CarIdxLapDistPct.getFloat(i);
-
-                        // Does the delta between us and the other car span across the start/finish line?
-                        const bool wrap = fabsf(carLapDistPct - selfLapDistPct) > 0.5f;
-                        int wrappedSum = 0;
-
-                        if( wrap )
-                        {
-                            if (selfLapDistPct > carLapDistPct) {
-                                delta = (CarEstLapTime - SelfEstLapTime) + ownClassEstLaptime;
-                                lapDelta += -1;
-                                wrappedSum = 1;
-                            }
-                            else {
-                                delta = (CarEstLapTime - SelfEstLapTime) - ownClassEstLaptime;
-                                lapDelta += 1;
-                                wrappedSum = -1;
-                            }
-
-                        }
-                        else
-                        {
-                            delta = CarEstLapTime - SelfEstLapTime;
-                        }
-                        if( ir_session.sessionType!=SessionType::RACE || ir_isPreStart() || car.isPaceCar )
-                        {
-                            lapDelta = 0;
-                        }
-
+                        // Wrap-safe, class-normalized deltas come precomputed from the shared race state
                         CarInfo ci;
                         ci.carIdx = i;
-                        ci.delta = delta;
-                        ci.lapDelta = lapDelta;
-                        ci.lapDistPct = ir_CarIdxLapDistPct.getFloat(i);
-                        ci.wrappedSum = wrappedSum;
-                        ci.pitAge = ir_CarIdxLap.getInt(i) - car.lastLapInPits;
-                        ci.last = ir_CarIdxLastLapTime.getFloat(i);
+                        ci.delta = rs.relTime[i];
+                        ci.lapDelta = rs.relLapDelta[i];
+                        ci.lapDistPct = rs.lapDistPct[i];
+                        ci.wrappedSum = rs.relWrap[i];
+                        ci.pitAge = rs.pitAge[i];
+                        ci.last = rs.lastLapTime[i];
                         ci.tireCompound = ir_CarIdxTireCompound.isValid() ? ir_CarIdxTireCompound.getInt(i) : -1;
                         if (ci.tireCompound < 0 && car.tireCompound >= 0)
                             ci.tireCompound = car.tireCompound;
-                        ci.positionsChanged = ir_getPositionsChanged(i);
+                        ci.positionsChanged = rs.positionsChanged[i];
                         relatives.push_back( ci );
                     }
                 }
             }
 
-            // Sort by lap % completed, in case deltas are a bit desynced
-            std::sort( relatives.begin(), relatives.end(), 
-                []( const CarInfo& a, const CarInfo&b ) {return a.lapDistPct + a.wrappedSum > b.lapDistPct + b.wrappedSum ;} );
+            // Live cars come in track order from the shared index unless we aren't on track ourselves
+            if( !inTrackOrder )
+                std::sort( relatives.begin(), relatives.end(),
+                    []( const CarInfo& a, const CarInfo&b ) {return a.lapDistPct + a.wrappedSum > b.lapDistPct + b.wrappedSum ;} );
 
             // Locate our driver's index in the new array
             int selfCarInfoIdx = -1;
@@ -307,177 +286,33 @@ class OverlayRelative : public Overlay
             const float xoff = 10.0f;
             m_columns.layout( (float)m_width - 20 );
 
-            std::unordered_map<int, int> irPredDeltaByCarIdx;
+            // iRating prediction. Live deltas are maintained once per tick by the shared race state; the
+            // preview feeds stub positions through a predictor of our own.
             const bool showIrPred = g_cfg.getBool(m_name, "show_ir_pred", false) && ir_session.sessionType == SessionType::RACE;
-            if( showIrPred )
+            if( showIrPred && useStubData )
             {
-                // Prepare participants for iRating prediction.
-                //
-                // IMPORTANT: In multiclass racing, iRating is gained/lost only against drivers in the same car class.
-                // Therefore, we compute predictions per class (using class positions).
-                struct Participant { int carIdx; int classId; int position; int irating; bool started; };
-                std::unordered_map<int, std::vector<Participant>> participantsByClass;
-                participantsByClass.reserve(16);
-
-                size_t totalParticipants = 0;
+                int classId[IR_MAX_CARS] = {};
+                int irating[IR_MAX_CARS] = {};
+                int position[IR_MAX_CARS] = {};
                 for( int i=0; i<IR_MAX_CARS; ++i )
                 {
                     const Car& car = ir_session.cars[i];
+                    classId[i] = car.classId;
+                    irating[i] = car.irating;
                     if( car.isSpectator || car.carNumber < 0 || car.isPaceCar )
                         continue;
-
-                    int pos = 0;
-                    if( useStubData )
-                    {
-                        if (const StubDataManager::StubCar* sc = StubDataManager::getStubCar(i))
-                            pos = sc->position;
-                    }
-                    else
-                    {
-                        pos = ir_getPosition(i); // class position when available
-                    }
-
-                    if( pos <= 0 )
-                        continue;
-
-                    // For live prediction we treat listed competitors as starters.
-                    // (Non-starters/forfeits are uncommon mid-session and would require results data to model correctly.)
-                    participantsByClass[car.classId].push_back( Participant{ i, car.classId, pos, car.irating, true } );
-                    ++totalParticipants;
+                    if (const StubDataManager::StubCar* sc = StubDataManager::getStubCar(i))
+                        position[i] = sc->position;
                 }
-
-                // Spreadsheet-derived iRating change estimate (matches common community calculators closely).
-                //
-                // Based on the "iRacing SOF iRating Calculator v1_1.xlsx" logic (popularized via SIMRacingApps),
-                // using the same "chance" function (not the classic Elo base-10 / 400 logistic).
-                const float ln2 = std::log(2.0f);
-                const float br1 = (ln2 > 0.0f) ? (1600.0f / ln2) : 2307.0f; // fallback shouldn't ever be hit
-
-                auto chance = [&](float a, float b)->float
-                {
-                    // Port of https://github.com/Turbo87/irating-rs (chance function)
-                    const float ea = std::exp(-a / br1);
-                    const float eb = std::exp(-b / br1);
-                    const float numerator = (1.0f - ea) * eb;
-                    const float denominator = (1.0f - eb) * ea + (1.0f - ea) * eb;
-                    if( denominator <= 0.0f )
-                        return 0.5f;
-                    return numerator / denominator;
-                };
-
-                irPredDeltaByCarIdx.reserve(totalParticipants);
-
-                auto computeClassDeltas = [&](std::vector<Participant>& cls)->void
-                {
-                    const int n = (int)cls.size();
-                    if( n <= 1 )
-                    {
-                        for( const auto& p : cls )
-                            irPredDeltaByCarIdx[p.carIdx] = 0;
-                        return;
-                    }
-
-                    // Ensure positions are in rank order (1..n within class)
-                    std::sort(cls.begin(), cls.end(), [](const Participant& a, const Participant& b) { return a.position < b.position; });
-
-                    const int numRegistrations = n;
-                    int numStarters = 0;
-                    for( const auto& p : cls )
-                        if( p.started ) ++numStarters;
-
-                    const int numNonStarters = numRegistrations - numStarters;
-                    if( numStarters <= 0 )
-                    {
-                        for( const auto& p : cls )
-                            irPredDeltaByCarIdx[p.carIdx] = 0;
-                        return;
-                    }
-
-                    // Expected scores
-                    std::vector<float> expectedScore(n, 0.0f);
-                    for( int i=0; i<n; ++i )
-                    {
-                        float sum = 0.0f;
-                        const float a = (float)cls[i].irating;
-                        for( int j=0; j<n; ++j )
-                        {
-                            const float b = (float)cls[j].irating;
-                            sum += chance(a, b);
-                        }
-                        expectedScore[i] = sum - 0.5f;
-                    }
-
-                    // Fudge factors (per spreadsheet implementation)
-                    const float x = (float)numRegistrations - (float)numNonStarters / 2.0f;
-                    std::vector<float> fudge(n, 0.0f);
-                    for( int i=0; i<n; ++i )
-                    {
-                        if( !cls[i].started )
-                            continue;
-                        fudge[i] = (x / 2.0f - (float)cls[i].position) / 100.0f;
-                    }
-
-                    // Changes for starters
-                    std::vector<float> changes(n, 0.0f);
-                    float sumChangesStarters = 0.0f;
-                    for( int i=0; i<n; ++i )
-                    {
-                        if( !cls[i].started )
-                            continue;
-                        changes[i] =
-                            ((float)numRegistrations
-                             - (float)cls[i].position
-                             - expectedScore[i]
-                             - fudge[i])
-                            * 200.0f
-                            / (float)numStarters;
-                        sumChangesStarters += changes[i];
-                    }
-
-                    // Distribute changes to non-starters (rare for our live view, but keep behavior defined)
-                    if( numNonStarters > 0 )
-                    {
-                        float sumExpectedNonStarters = 0.0f;
-                        for( int i=0; i<n; ++i )
-                            if( !cls[i].started )
-                                sumExpectedNonStarters += expectedScore[i];
-
-                        const float avgExpectedNonStarters = sumExpectedNonStarters / (float)numNonStarters;
-                        for( int i=0; i<n; ++i )
-                        {
-                            if( cls[i].started )
-                                continue;
-
-                            if( std::fabs(avgExpectedNonStarters) < 1e-6f )
-                            {
-                                changes[i] = -sumChangesStarters / (float)numNonStarters;
-                            }
-                            else
-                            {
-                                changes[i] =
-                                    (-sumChangesStarters / (float)numNonStarters)
-                                    * expectedScore[i]
-                                    / avgExpectedNonStarters;
-                            }
-                        }
-                    }
-
-                    for( int i=0; i<n; ++i )
-                    {
-                        irPredDeltaByCarIdx[cls[i].carIdx] = (int)std::lround(changes[i]);
-                    }
-                };
-
-                for( auto& kv : participantsByClass )
-                    computeClassDeltas(kv.second);
+                m_irPredStub.update( classId, irating, position );
             }
+            const IRatingPredictor& irPred = useStubData ? m_irPredStub : rs.irPred;
 
             auto predictIrDeltaFor = [&](int targetCarIdx)->int
             {
                 if( !showIrPred )
                     return 0;
-                auto it = irPredDeltaByCarIdx.find(targetCarIdx);
-                return (it != irPredDeltaByCarIdx.end()) ? it->second : 0;
+                return irPred.deltaFor(targetCarIdx);
             };
 
             m_renderTarget->BeginDraw();
@@ -509,7 +344,7 @@ class OverlayRelative : public Overlay
 
                 if( car.isSelf )
                     col = selfCol;
-                else if( !useStubData && ir_CarIdxOnPitRoad.getBool(ci.carIdx) )
+                else if( !useStubData && rs.onPitRoad[ci.carIdx] )
                     col.a *= 0.5f;
                 
                 // Apply global opacity
@@ -531,7 +366,7 @@ class OverlayRelative : public Overlay
                         position = displayIndex + 1; // P1, P2, P3, etc.
                     }
                 } else {
-                    position = ir_getPosition(ci.carIdx);
+                    position = rs.position[ci.carIdx];
                 }
                 if( position > 0 )
                 {
@@ -579,7 +414,8 @@ class OverlayRelative : public Overlay
                 {
                     clm = m_columns.get( (int)Columns::CAR_NUMBER );
                     // While driver is transmitting on voice, replace the car-number badge with the push-to-talk icon.
-                    if (isTalking && m_pushToTalkIcon)
+                    ID2D1Bitmap* pttIcon = isTalking ? m_pushToTalkIcon.Get(m_renderTarget.Get()) : nullptr;
+                    if (pttIcon)
                     {
                         const float cellL = xoff + clm->textL;
                         const float cellR = xoff + clm->textR;
@@ -587,7 +423,7 @@ class OverlayRelative : public Overlay
                         const float iconSize = std::max(0.0f, std::min(lineHeight - 6.0f, cellW));
                         const float cx = (cellL + cellR) * 0.5f;
                         D2D1_RECT_F ir = { cx - iconSize * 0.5f, y - iconSize * 0.5f, cx + iconSize * 0.5f, y + iconSize * 0.5f };
-                        m_renderTarget->DrawBitmap(m_pushToTalkIcon.Get(), &ir);
+                        m_renderTarget->DrawBitmap(pttIcon, &ir);
                     }
                     else
                     {
@@ -636,12 +472,12 @@ class OverlayRelative : public Overlay
                 }
 
                 // Pit age
-                if( (clm = m_columns.get((int)Columns::PIT)) && !ir_isPreStart() && (ci.pitAge>=0||ir_CarIdxOnPitRoad.getBool(ci.carIdx)) )
+                if( (clm = m_columns.get((int)Columns::PIT)) && !rs.isPreStart && (ci.pitAge>=0||rs.onPitRoad[ci.carIdx]) )
                 {
                     r = { xoff+clm->textL, y-lineHeight/2+2, xoff+clm->textR, y+lineHeight/2-2 };
                     m_brush->SetColor( pitCol );
                     m_renderTarget->DrawRectangle( &r, m_brush.Get() );
-                    if( ir_CarIdxOnPitRoad.getBool(ci.carIdx) ) {
+                    if( rs.onPitRoad[ci.carIdx] ) {
                         swprintf( s, _countof(s), L"PIT" );
                         m_renderTarget->FillRectangle( &r, m_brush.Get() );
                         m_brush->SetColor( float4(0,0,0,1) );
@@ -711,9 +547,9 @@ class OverlayRelative : public Overlay
 
                     const int deltaPos = ci.positionsChanged;
                     ID2D1Bitmap* icon = nullptr;
-                    if (deltaPos > 0)      icon = m_posUpIcon.Get();
-                    else if (deltaPos < 0) icon = m_posDownIcon.Get();
-                    else                   icon = m_posEqualIcon.Get();
+                    if (deltaPos > 0)      icon = m_posUpIcon.Get(m_renderTarget.Get());
+                    else if (deltaPos < 0) icon = m_posDownIcon.Get(m_renderTarget.Get());
+                    else                   icon = m_posEqualIcon.Get(m_renderTarget.Get());
 
                     const float iconPad  = 4.0f;
                     const float iconSize = std::max(0.0f, lineHeight - 6.0f);
@@ -769,6 +605,10 @@ class OverlayRelative : public Overlay
                     m_text.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
                 }
 
+                // Sectors
+                if( (clm = m_columns.get((int)Columns::SECTORS)) )
+                    drawSectorStrip( xoff + clm->textL, xoff + clm->textR, y, lineHeight * 0.3f, ci.carIdx, useStubData );
+
                 // Delta
                 if( (clm = m_columns.get((int)Columns::DELTA)) )
                 {
@@ -808,15 +648,15 @@ class OverlayRelative : public Overlay
                 };
 
                 if (g_cfg.getBool(m_name, "show_session_end", true)) {
-                    leftItems.push_back({ m_iconSessionTime.Get(), toWide(std::vformat("{}:{:0>2}:{:0>2}", std::make_format_args(hours, mins, secs))), 0.0f });
+                    leftItems.push_back({ m_iconSessionTime.Get(m_renderTarget.Get()), toWide(std::vformat("{}:{:0>2}:{:0>2}", std::make_format_args(hours, mins, secs))), 0.0f });
                 }
                 if (g_cfg.getBool(m_name, "show_track_temp", true)) {
                     wchar_t buf[64];
                     swprintf(buf, _countof(buf), L"%.1f\x00B0%c", trackTemp, tempUnit);
-                    rightItems.push_back({ m_iconTrackTemp.Get(), std::wstring(buf), 0.0f });
+                    rightItems.push_back({ m_iconTrackTemp.Get(m_renderTarget.Get()), std::wstring(buf), 0.0f });
                 }
                 if (g_cfg.getBool(m_name, "show_laps", true)) {
-                    rightItems.push_back({ m_iconLaps.Get(), toWide(std::format("{}/{}{}", laps, (irTotalLaps == 32767 ? "~" : ""), totalLaps)), 0.0f });
+                    rightItems.push_back({ m_iconLaps.Get(m_renderTarget.Get()), toWide(std::format("{}/{}{}", laps, (irTotalLaps == 32767 ? "~" : ""), totalLaps)), 0.0f });
                 }
 
                 const float fontSize = g_cfg.getFloat("Overlay", "font_size", 16.0f);
@@ -832,7 +672,7 @@ class OverlayRelative : public Overlay
                         it.width = (it.icon ? iconSize + iconPad : 0.0f) + measure(it.text);
                         // Enforce a minimum width for session time equal to width of "999:99:99"
                         float minItemW = 0.0f;
-                        if (it.icon == m_iconSessionTime.Get()) {
+                        if (it.icon == m_iconSessionTime.Get(m_renderTarget.Get())) {
                             const float minTextW = computeTextExtent(L"999:99:99", m_dwriteFactory.Get(), m_textFormatSmall.Get(), m_fontSpacing).x;
                             minItemW = (it.icon ? iconSize + iconPad : 0.0f) + minTextW + 6.0f;
                         }
@@ -901,15 +741,16 @@ class OverlayRelative : public Overlay
                     const float textW = computeTextExtent(sofText.c_str(), m_dwriteFactory.Get(), m_textFormatSmall.Get(), m_fontSpacing).x;
                     const float minTextW = computeTextExtent(L"99999", m_dwriteFactory.Get(), m_textFormatSmall.Get(), m_fontSpacing).x;
                     const float itemH = iconSizeH + 2.0f;
-                    const float itemW = (m_iconSoF ? iconSizeH + iconPadH : 0.0f) + std::max(textW, minTextW) + 6.0f;
+                    ID2D1Bitmap* sofIcon = m_iconSoF.Get(m_renderTarget.Get());
+                    const float itemW = (sofIcon ? iconSizeH + iconPadH : 0.0f) + std::max(textW, minTextW) + 6.0f;
                     float xL = baseX;
                     D2D1_RECT_F bg = { xL - 4.0f, yCenter - itemH * 0.5f, xL + itemW - 4.0f, yCenter + itemH * 0.5f };
                     D2D1_ROUNDED_RECT rrh = { bg, itemH * 0.5f, itemH * 0.5f };
                     m_brush->SetColor(float4(1,1,1,1));
                     m_renderTarget->FillRoundedRectangle(&rrh, m_brush.Get());
-                    if (m_iconSoF) {
+                    if (sofIcon) {
                         D2D1_RECT_F ir = { xL, yCenter - iconSizeH * 0.5f, xL + iconSizeH, yCenter + iconSizeH * 0.5f };
-                        m_renderTarget->DrawBitmap(m_iconSoF.Get(), &ir);
+                        m_renderTarget->DrawBitmap(sofIcon, &ir);
                         xL += iconSizeH + iconPadH;
                     }
                     m_brush->SetColor(float4(0,0,0,1));
@@ -923,15 +764,16 @@ class OverlayRelative : public Overlay
                     std::wstring incText = toWide(lim > 0 ? std::format("{}/{}", inc, lim) : std::format("{}/--", inc));
                     const float textW = computeTextExtent(incText.c_str(), m_dwriteFactory.Get(), m_textFormatSmall.Get(), m_fontSpacing).x;
                     const float itemH = iconSizeH + 2.0f;
-                    const float itemW = (m_iconIncidents ? iconSizeH + iconPadH : 0.0f) + textW + 6.0f;
+                    ID2D1Bitmap* incIcon = m_iconIncidents.Get(m_renderTarget.Get());
+                    const float itemW = (incIcon ? iconSizeH + iconPadH : 0.0f) + textW + 6.0f;
                     float xR = (float)m_width - baseX - itemW;
                     D2D1_RECT_F bg = { xR - 4.0f, yCenter - itemH * 0.5f, xR + itemW - 4.0f, yCenter + itemH * 0.5f };
                     D2D1_ROUNDED_RECT rrh = { bg, itemH * 0.5f, itemH * 0.5f };
                     m_brush->SetColor(float4(1,1,1,1));
                     m_renderTarget->FillRoundedRectangle(&rrh, m_brush.Get());
-                    if (m_iconIncidents) {
+                    if (incIcon) {
                         D2D1_RECT_F ir = { xR, yCenter - iconSizeH * 0.5f, xR + iconSizeH, yCenter + iconSizeH * 0.5f };
-                        m_renderTarget->DrawBitmap(m_iconIncidents.Get(), &ir);
+                        m_renderTarget->DrawBitmap(incIcon, &ir);
                         xR += iconSizeH + iconPadH;
                     }
                     m_brush->SetColor(float4(0,0,0,1));
@@ -1019,7 +861,7 @@ class OverlayRelative : public Overlay
                         }
 
                         float4 col = baseCol;
-                        if( !car.isSelf && ir_CarIdxOnPitRoad.getBool(ci.carIdx) )
+                        if( !car.isSelf && rs.onPitRoad[ci.carIdx] )
                             col.a *= 0.5f;
 
                         const float dx = 2;
@@ -1041,47 +883,28 @@ class OverlayRelative : public Overlay
         ColumnLayout m_columns;
         TextCache    m_text;
         float m_fontSpacing = getGlobalFontSpacing();
-        // Position change icons and factory
-        Microsoft::WRL::ComPtr<IWICImagingFactory> m_wicFactory;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_posUpIcon;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_posDownIcon;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_posEqualIcon;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_pushToTalkIcon;
+        IRatingPredictor m_irPredStub;  // preview mode only; live data uses ir_race.irPred
+        // Position change icons
+        ImageAssets::Ref m_posUpIcon;
+        ImageAssets::Ref m_posDownIcon;
+        ImageAssets::Ref m_posEqualIcon;
+        ImageAssets::Ref m_pushToTalkIcon;
 
         // Footer icons
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_iconIncidents;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_iconSoF;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_iconTrackTemp;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_iconSessionTime;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_iconLaps;
+        ImageAssets::Ref m_iconIncidents;
+        ImageAssets::Ref m_iconSoF;
+        ImageAssets::Ref m_iconTrackTemp;
+        ImageAssets::Ref m_iconSessionTime;
+        ImageAssets::Ref m_iconLaps;
 
+        // Position change icons, shared through ImageAssets
         void loadPositionIcons()
         {
-            if (!m_renderTarget.Get()) return;
-            if (m_posUpIcon || m_posDownIcon || m_posEqualIcon || m_pushToTalkIcon) return;
-            (void)CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-            if (!m_wicFactory.Get()) {
-                (void)CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&m_wicFactory));
-            }
-            if (!m_wicFactory.Get()) return;
-            auto loadPng = [&](const std::wstring& rel) -> Microsoft::WRL::ComPtr<ID2D1Bitmap>
-            {
-                Microsoft::WRL::ComPtr<ID2D1Bitmap> bmp;
-                Microsoft::WRL::ComPtr<IWICBitmapDecoder> dec;
-                Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
-                Microsoft::WRL::ComPtr<IWICFormatConverter> conv;
-                const std::wstring path = resolveAssetPathW(rel);
-                if (FAILED(m_wicFactory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &dec))) return bmp;
-                if (FAILED(dec->GetFrame(0, &frame))) return bmp;
-                if (FAILED(m_wicFactory->CreateFormatConverter(&conv))) return bmp;
-                if (FAILED(conv->Initialize(frame.Get(), GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut))) return bmp;
-                (void)m_renderTarget->CreateBitmapFromWicBitmap(conv.Get(), nullptr, &bmp);
-                return bmp;
-            };
-            m_posUpIcon    = loadPng(L"assets\\icons\\up.png");
-            m_posDownIcon  = loadPng(L"assets\\icons\\down.png");
-            m_posEqualIcon = loadPng(L"assets\\icons\\equal.png");
-            m_pushToTalkIcon = loadPng(L"assets\\icons\\pushtotalk.png");
+            ImageAssets& assets = ImageAssets::instance();
+            m_posUpIcon      = assets.acquire(L"assets\\icons\\up.png");
+            m_posDownIcon    = assets.acquire(L"assets\\icons\\down.png");
+            m_posEqualIcon   = assets.acquire(L"assets\\icons\\equal.png");
+            m_pushToTalkIcon = assets.acquire(L"assets\\icons\\pushtotalk.png");
         }
 
         void releasePositionIcons()
@@ -1090,36 +913,16 @@ class OverlayRelative : public Overlay
             m_posDownIcon.Reset();
             m_posEqualIcon.Reset();
             m_pushToTalkIcon.Reset();
-            m_wicFactory.Reset();
         }
 
         void loadFooterIcons()
         {
-            if (!m_renderTarget.Get()) return;
-            (void)CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-            if (!m_wicFactory.Get()) {
-                (void)CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&m_wicFactory));
-            }
-            if (!m_wicFactory.Get()) return;
-            auto loadPng = [&](const std::wstring& rel) -> Microsoft::WRL::ComPtr<ID2D1Bitmap>
-            {
-                Microsoft::WRL::ComPtr<ID2D1Bitmap> bmp;
-                Microsoft::WRL::ComPtr<IWICBitmapDecoder> dec;
-                Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
-                Microsoft::WRL::ComPtr<IWICFormatConverter> conv;
-                const std::wstring path = resolveAssetPathW(rel);
-                if (FAILED(m_wicFactory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &dec))) return bmp;
-                if (FAILED(dec->GetFrame(0, &frame))) return bmp;
-                if (FAILED(m_wicFactory->CreateFormatConverter(&conv))) return bmp;
-                if (FAILED(conv->Initialize(frame.Get(), GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut))) return bmp;
-                (void)m_renderTarget->CreateBitmapFromWicBitmap(conv.Get(), nullptr, &bmp);
-                return bmp;
-            };
-            m_iconIncidents   = loadPng(L"assets\\icons\\incidents.png");
-            m_iconSoF         = loadPng(L"assets\\icons\\SoF.png");
-            m_iconTrackTemp   = loadPng(L"assets\\icons\\temp_dark.png");
-            m_iconSessionTime = loadPng(L"assets\\icons\\session_time.png");
-            m_iconLaps        = loadPng(L"assets\\icons\\laps.png");
+            ImageAssets& assets = ImageAssets::instance();
+            m_iconIncidents   = assets.acquire(L"assets\\icons\\incidents.png");
+            m_iconSoF         = assets.acquire(L"assets\\icons\\SoF.png");
+            m_iconTrackTemp   = assets.acquire(L"assets\\icons\\temp_dark.png");
+            m_iconSessionTime = assets.acquire(L"assets\\icons\\session_time.png");
+            m_iconLaps        = assets.acquire(L"assets\\icons\\laps.png");
         }
 
         void releaseFooterIcons()
@@ -33,11 +33,14 @@ SOFTWARE.
 #include <array>
 #include <wincodec.h>
 #include "Overlay.h"
+#include "ImageAssets.h"
 #include "Config.h"
 #include "Units.h"
 #include "OverlayDebug.h"
 #include "stub_data.h"
 #include "ClassColors.h"
+#include "CarBrandIcons.h"
+#include "RaceState.h"
 
 class OverlayStandings : public Overlay
 {
@@ -49,32 +52,15 @@ public:
     const int defaultNumAheadDrivers = 5;
     const int defaultNumBehindDrivers = 5;
 
-    enum class Columns { POSITION, CAR_NUMBER, NAME, GAP, BEST, LAST, LICENSE, IRATING, CAR_BRAND, PIT, DELTA, L5, POSITIONS_GAINED, TIRE_COMPOUND };
+    enum class Columns { POSITION, CAR_NUMBER, NAME, GAP, BEST, LAST, SECTORS, LICENSE, IRATING, IR_PRED, CAR_BRAND, PIT, DELTA, L5, POSITIONS_GAINED, TIRE_COMPOUND };
 
     OverlayStandings()
         : Overlay("OverlayStandings")
     {
-        m_avgL5Times.reserve(IR_MAX_CARS);
-
-        for (int i = 0; i < IR_MAX_CARS; ++i) {
-            m_avgL5Times.emplace_back();
-            m_avgL5Times[i].reserve(5);
-
-            for (int j = 0; j < 5; ++j) {
-                m_avgL5Times[i].emplace_back(0.0f);
-            }
-        }
-
-        this->m_carBrandIconsLoaded = false;
-    }
-
-    void setCarBrandIcons(const std::map<std::string, IWICFormatConverter*>& carBrandIconsMap, bool loaded)
-    {
-        // Drop any cached bitmaps (they are tied to this overlay's render target)
-        m_carIdToIconMap.clear();
-        m_brandConvToBitmap.clear();
-        m_carBrandIconsMap = carBrandIconsMap;
-        m_carBrandIconsLoaded = loaded;
+        m_carInfo.reserve(IR_MAX_CARS);
+        m_carInfoSorted.reserve(IR_MAX_CARS);
+        m_order.reserve(IR_MAX_CARS);
+        m_rows.reserve(IR_MAX_CARS * 3);
     }
 
     std::string tireCompoundToString(int compound) const
@@ -108,19 +94,34 @@ protected:
     virtual void onDisable()
     {
         m_text.reset();
+        m_num.reset();
 
-        // Clear car brand bitmap caches on disable
-        m_carIdToIconMap.clear();
-        m_brandConvToBitmap.clear();
+        m_carIdToBrand.clear();
 
         // Release positions gained icons/factory
         releasePositionIcons();
         releaseFooterIcons();
     }
 
+    virtual void onSessionChanged()
+    {
+        // Queue brand icons for the new field up front rather than on first draw
+        m_carIdToBrand.clear();
+        if (!isEnabled() || !CarBrandIcons::instance().available())
+            return;
+        for (int i = 0; i < IR_MAX_CARS; ++i)
+        {
+            const Car& car = ir_session.cars[i];
+            if (car.carName.empty() || car.isSpectator || car.isPaceCar)
+                continue;
+            m_carIdToBrand.emplace(car.carID, CarBrandIcons::instance().brandForCar(car.carName));
+        }
+    }
+
     virtual void onConfigChanged()
     {
         m_text.reset( m_dwriteFactory.Get() );
+        m_num.reset( m_dwriteFactory.Get(), &m_text );
 
         // Centralized fonts
         createGlobalTextFormat(1.0f, m_textFormat);
@@ -142,6 +143,9 @@ protected:
         if (g_cfg.getBool(m_name, "show_irating", true))
             m_columns.add( (int)Columns::IRATING,    computeTextExtent( L" 9.9k ", m_dwriteFactory.Get(), m_textFormatSmall.Get(), m_fontSpacing ).x, baseFontSize/6 );
 
+        if (g_cfg.getBool(m_name, "show_ir_pred", false))
+            m_columns.add( (int)Columns::IR_PRED,    computeTextExtent( L"+999", m_dwriteFactory.Get(), m_textFormatSmall.Get(), m_fontSpacing ).x, baseFontSize/6 );
+
         if (g_cfg.getBool(m_name, "show_car_brand", true))
             m_columns.add( (int)Columns::CAR_BRAND,  30, baseFontSize / 2);
 
@@ -164,6 +168,9 @@ protected:
         if (g_cfg.getBool(m_name, "show_lap_time", true))
             m_columns.add( (int)Columns::LAST,   computeTextExtent( L"99:99.999", m_dwriteFactory.Get(), m_textFormat.Get(), m_fontSpacing ).x, baseFontSize/2 );
 
+        if (g_cfg.getBool(m_name, "show_sectors", false))
+            m_columns.add( (int)Columns::SECTORS, computeTextExtent( L"Sectors", m_dwriteFactory.Get(), m_textFormat.Get(), m_fontSpacing ).x, baseFontSize/2 );
+
         if (g_cfg.getBool(m_name, "show_delta", true))
             m_columns.add( (int)Columns::DELTA,  computeTextExtent( L"99.99", m_dwriteFactory.Get(), m_textFormat.Get(), m_fontSpacing ).x, baseFontSize/2 );
 
@@ -176,31 +183,9 @@ protected:
         if (!StubDataManager::shouldUseStubData() && !ir_hasValidDriver()) {
             return;
         }
-        struct CarInfo {
-            int     carIdx = 0;
-            int     classIdx = 0;
-            int     lapCount = 0;
-            float   pctAroundLap = 0;
-            int     lapGap = 0;
-            float   gap = 0;
-            float   delta = 0;
-            int     position = 0;
-            float   best = 0;
-            float   last = 0;
-            float   l5 = 0;
-            bool    hasFastestLap = false;
-            int     pitAge = 0;
-            int     positionsChanged = 0;
-            int     tireCompound = -1;
-        };
-
-        struct classBestLap {
-            int     carIdx = -1;
-            float   best = FLT_MAX;
-        };
-
-        std::vector<CarInfo> carInfo;
-        carInfo.reserve( IR_MAX_CARS );
+        // Rows live in members so that steady-state frames don't allocate
+        std::vector<CarInfo>& carInfo = m_carInfo;
+        carInfo.clear();
         std::array<int, IR_MAX_CARS> carInfoIndexByCarIdx;
         carInfoIndexByCarIdx.fill(-1);
         
@@ -215,9 +200,25 @@ protected:
         const float globalOpacity = getGlobalOpacity();
 
         // Init array
-        std::map<int, classBestLap> bestLapClass;
-        std::set<int> activeClasses;
-        int selfPosition = ir_getPosition(ir_session.driverCarIdx);
+        // Per-class fastest lap, one slot per distinct class id (at most one class per car)
+        struct ClassBestLap {
+            int     classId = 0;
+            int     carIdx = -1;
+            float   best = FLT_MAX;
+        };
+        std::array<ClassBestLap, IR_MAX_CARS> bestLapClass;
+        int numActiveClasses = 0;
+        auto classBestFor = [&]( int classId ) -> ClassBestLap& {
+            for( int c=0; c<numActiveClasses; ++c )
+                if( bestLapClass[c].classId == classId )
+                    return bestLapClass[c];
+            ClassBestLap& b = bestLapClass[numActiveClasses++];
+            b = ClassBestLap();
+            b.classId = classId;
+            return b;
+        };
+        const RaceState& rs = ir_race;
+        int selfPosition = useStubData ? ir_getPosition(ir_session.driverCarIdx) : rs.position[ir_session.driverCarIdx];
         // NOTE: `carInfo` is filtered, so we must not index it by `carIdx`.
         
         if (useStubData) {
@@ -242,7 +243,7 @@ protected:
                 ci.positionsChanged = (int)((i % 3) - 1);
                 ci.tireCompound = stubCar.tireCompound;
 
-                activeClasses.insert(ci.classIdx);
+                classBestFor(ci.classIdx);
                 carInfo.push_back(ci);
                 if (ci.carIdx >= 0 && ci.carIdx < IR_MAX_CARS)
                     carInfoIndexByCarIdx[ci.carIdx] = (int)carInfo.size() - 1;
@@ -258,14 +259,14 @@ protected:
 
             CarInfo ci;
             ci.carIdx       = i;
-            ci.lapCount     = std::max( ir_CarIdxLap.getInt(i), ir_CarIdxLapCompleted.getInt(i) );
-            ci.position     = ir_getPosition(i);
-            ci.pctAroundLap = ir_CarIdxLapDistPct.getFloat(i);
-            ci.gap          = ir_session.sessionType!=SessionType::RACE ? 0 : -ir_CarIdxF2Time.getFloat(i);
-            ci.last         = ir_CarIdxLastLapTime.getFloat(i);
-            ci.pitAge       = ir_CarIdxLap.getInt(i) - car.lastLapInPits;
-            ci.positionsChanged = ir_getPositionsChanged(i);
-            ci.classIdx     = ir_getClassId(ci.carIdx);
+            ci.lapCount     = rs.lapCount[i];
+            ci.position     = rs.position[i];
+            ci.pctAroundLap = rs.lapDistPct[i];
+            ci.gap          = rs.isRace ? -rs.gapToLeader[i] : 0;  // already relative to the class leader
+            ci.last         = rs.lastLapTime[i];
+            ci.pitAge       = rs.pitAge[i];
+            ci.positionsChanged = rs.positionsChanged[i];
+            ci.classIdx     = rs.classId[i];
             ci.tireCompound = ir_CarIdxTireCompound.isValid() ? ir_CarIdxTireCompound.getInt(i) : -1;
             if (ci.tireCompound < 0 && car.tireCompound >= 0)
                 ci.tireCompound = car.tireCompound;
@@ -273,9 +274,6 @@ protected:
             ci.best         = ir_CarIdxBestLapTime.getFloat(i);
             if (ir_session.sessionType == SessionType::RACE && ir_SessionState.getInt() <= irsdk_StateWarmup || ir_session.sessionType == SessionType::QUALIFY && ci.best <= 0) {
                 ci.best = car.qualy.fastestTime;
-                for (int j = 0; j < 5; ++j) {
-                    m_avgL5Times[ci.carIdx][j] = 0.0;
-                }
             }
                 
             if (ir_CarIdxTrackSurface.getInt(ci.carIdx) == irsdk_NotInWorld) {
@@ -297,42 +295,27 @@ protected:
                 }               
             }
 
-            if (!bestLapClass.contains(ci.classIdx)) {
-                classBestLap classBest;
-                bestLapClass.insert_or_assign(ci.classIdx, classBest);
-            }
-
-            if( ci.best > 0 && ci.best < bestLapClass[ci.classIdx].best) {
-                bestLapClass[ci.classIdx].best = ci.best;
-                bestLapClass[ci.classIdx].carIdx = ci.carIdx;
+            ClassBestLap& classBest = classBestFor(ci.classIdx);
+            if( ci.best > 0 && ci.best < classBest.best) {
+                classBest.best = ci.best;
+                classBest.carIdx = ci.carIdx;
             }
             
-            if(ci.lapCount > 0)
-                m_avgL5Times[ci.carIdx][ci.lapCount % 5] = ci.last;
-
-            float total = 0;
-            int conteo = 0;
-            for (float time : m_avgL5Times[ci.carIdx]) {
-                if (time > 0.0) {
-                    total += time;
-                    conteo++;
-                }
-            }
-
-            ci.l5 = conteo ? total / conteo : 0.0F;
+            // Average of the clean laps among the last five (pit, caution and pre-green laps don't count)
+            ci.l5 = rs.laps.average(ci.carIdx, 5);
 
-            activeClasses.insert(ci.classIdx);
             carInfo.push_back(ci);
             if (ci.carIdx >= 0 && ci.carIdx < IR_MAX_CARS)
                 carInfoIndexByCarIdx[ci.carIdx] = (int)carInfo.size() - 1;
         }
         }
 
-        for (const auto& pair : bestLapClass)
+        for (int c = 0; c < numActiveClasses; ++c)
         {
-            if (pair.second.best <= 0 || pair.second.carIdx < 0 || pair.second.carIdx >= IR_MAX_CARS)
+            const ClassBestLap& classBest = bestLapClass[c];
+            if (classBest.best <= 0 || classBest.carIdx < 0 || classBest.carIdx >= IR_MAX_CARS)
                 continue;
-            const int idx = carInfoIndexByCarIdx[pair.second.carIdx];
+            const int idx = carInfoIndexByCarIdx[classBest.carIdx];
             if (idx >= 0 && idx < (int)carInfo.size())
                 carInfo[idx].hasFastestLap = true;
         }
@@ -346,15 +329,25 @@ protected:
         const CarInfo ciSelf = carInfo[selfVecIdx];
         
         // Sort by position
-        std::sort( carInfo.begin(), carInfo.end(),
-            []( const CarInfo& a, const CarInfo& b ) {
-                const int ap = a.position<=0 ? INT_MAX : a.position;
-                const int bp = b.position<=0 ? INT_MAX : b.position;
-                return ap < bp;
-            } );
+        orderByPosition( carInfoIndexByCarIdx );
 
         // Compute lap gap to leader and compute delta
-        const bool isMultiClassSession = activeClasses.size() > 1;
+        // iRating prediction. Live deltas are maintained once per tick by the shared race state; the
+        // preview feeds stub positions through a predictor of our own.
+        if (useStubData && m_columns.get((int)Columns::IR_PRED)) {
+            int classId[IR_MAX_CARS] = {};
+            int irating[IR_MAX_CARS] = {};
+            int position[IR_MAX_CARS] = {};
+            for (const CarInfo& ci : carInfo) {
+                classId[ci.carIdx] = ci.classIdx;
+                irating[ci.carIdx] = ir_session.cars[ci.carIdx].irating;
+                position[ci.carIdx] = ci.position;
+            }
+            m_irPredStub.update( classId, irating, position );
+        }
+        const IRatingPredictor& irPred = useStubData ? m_irPredStub : rs.irPred;
+
+        const bool isMultiClassSession = numActiveClasses > 1;
         const bool showSingleClassHeader = g_cfg.getBool(m_name, "show_class_header_single", false);
         const bool useMultiClassLayout = isMultiClassSession || showSingleClassHeader;
 
@@ -376,7 +369,7 @@ protected:
                     classLeaderGapToOverall = ci.gap;
                 }
 
-                ci.lapGap = ir_getLapDeltaToLeader( ci.carIdx, classLeader);
+                ci.lapGap = classLeader >= 0 ? rs.lapsToLeader[ci.carIdx] : 0;
                 ci.delta = ir_getDeltaTime( ci.carIdx, ir_session.driverCarIdx );
 
                 if (ir_session.sessionType != SessionType::RACE) {
@@ -467,15 +460,16 @@ protected:
                 std::wstring sofText = toWide(std::format("{}", sof));
                 const float textW = computeTextExtent(sofText.c_str(), m_dwriteFactory.Get(), m_textFormatSmall.Get(), m_fontSpacing).x;
                 const float minTextW = computeTextExtent(L"99999", m_dwriteFactory.Get(), m_textFormatSmall.Get(), m_fontSpacing).x;
-                const float itemW = (m_iconSoF ? iconSizeH + iconPadH : 0.0f) + std::max(textW, minTextW) + 6.0f;
+                ID2D1Bitmap* sofIcon = m_iconSoF.Get(m_renderTarget.Get());
+                const float itemW = (sofIcon ? iconSizeH + iconPadH : 0.0f) + std::max(textW, minTextW) + 6.0f;
                 float x = xMargin;
                 D2D1_RECT_F bg = { x - 4.0f, yCenter - itemH * 0.5f, x + itemW - 4.0f, yCenter + itemH * 0.5f };
                 D2D1_ROUNDED_RECT rrh = { bg, itemH * 0.5f, itemH * 0.5f };
                 m_brush->SetColor(float4(1,1,1,1));
                 m_renderTarget->FillRoundedRectangle(&rrh, m_brush.Get());
-                if (m_iconSoF) {
+                if (sofIcon) {
                     D2D1_RECT_F ir = { x, yCenter - iconSizeH * 0.5f, x + iconSizeH, yCenter + iconSizeH * 0.5f };
-                    m_renderTarget->DrawBitmap(m_iconSoF.Get(), &ir);
+                    m_renderTarget->DrawBitmap(sofIcon, &ir);
                     x += iconSizeH + iconPadH;
                 }
                 m_brush->SetColor(float4(0,0,0,1));
@@ -488,15 +482,16 @@ protected:
                 const int lim = ir_session.incidentLimit;
                 std::wstring incText = toWide(lim > 0 ? std::format("{}/{}", inc, lim) : std::format("{}/--", inc));
                 const float textW = computeTextExtent(incText.c_str(), m_dwriteFactory.Get(), m_textFormatSmall.Get(), m_fontSpacing).x;
-                const float itemW = (m_iconIncidents ? iconSizeH + iconPadH : 0.0f) + textW + 6.0f;
+                ID2D1Bitmap* incIcon = m_iconIncidents.Get(m_renderTarget.Get());
+                const float itemW = (incIcon ? iconSizeH + iconPadH : 0.0f) + textW + 6.0f;
                 float x = (float)m_width - xMargin - itemW;
                 D2D1_RECT_F bg = { x - 4.0f, yCenter - itemH * 0.5f, x + itemW - 4.0f, yCenter + itemH * 0.5f };
                 D2D1_ROUNDED_RECT rrh = { bg, itemH * 0.5f, itemH * 0.5f };
                 m_brush->SetColor(float4(1,1,1,1));
                 m_renderTarget->FillRoundedRectangle(&rrh, m_brush.Get());
-                if (m_iconIncidents) {
+                if (incIcon) {
                     D2D1_RECT_F ir = { x, yCenter - iconSizeH * 0.5f, x + iconSizeH, yCenter + iconSizeH * 0.5f };
-                    m_renderTarget->DrawBitmap(m_iconIncidents.Get(), &ir);
+                    m_renderTarget->DrawBitmap(incIcon, &ir);
                     x += iconSizeH + iconPadH;
                 }
                 m_brush->SetColor(float4(0,0,0,1));
@@ -537,6 +532,11 @@ protected:
             m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), xoff+clm->textL, xoff+clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
         }
 
+        if (clm = m_columns.get( (int)Columns::IR_PRED )) {
+            swprintf( s, _countof(s), L"IR+/-" );
+            m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), xoff+clm->textL, xoff+clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing );
+        }
+
         if (clm = m_columns.get((int)Columns::CAR_BRAND)) {
             swprintf(s, _countof(s), L"  ");
             m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
@@ -562,6 +562,11 @@ protected:
             m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
         }
 
+        if (clm = m_columns.get((int)Columns::SECTORS)) {
+            swprintf(s, _countof(s), L"Sectors");
+            m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+        }
+
         if (clm = m_columns.get((int)Columns::DELTA)) {
             swprintf(s, _countof(s), L"Delta");
             m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
@@ -583,49 +588,49 @@ protected:
         if (useMultiClassLayout)
         {
             // Multi-class layout: stack one list per class, each with its own header row.
-            struct ClassSummary
+            // Summaries persist across frames (so names and index lists keep their storage); classes
+            // that left the session just end up with zero participants.
+            std::vector<ClassSummary>& classSummaries = m_classSummaries;
+            for (ClassSummary& summary : classSummaries)
             {
-                int                 classId = 0;
-                std::wstring        name;
-                int                 participants = 0;
-                double              sofExpSum = 0.0; // accumulate exp(-iR/br1) for glommed SoF
-                int                 sofCount = 0;
-                float               leaderBest = 0.0f;
-                std::vector<int>    carIndices;     // indices into carInfo
-            };
-
-            std::vector<ClassSummary> classSummaries;
-            std::map<int, int> classIdToIndex;
+                summary.participants = 0;
+                summary.sofExpSum = 0.0;
+                summary.sofCount = 0;
+                summary.leaderBest = 0.0f;
+                summary.carIndices.clear();
+            }
 
-            // Build per-class aggregates
+            // Build per-class aggregates. carInfo is already in position order, so each class'
+            // index list comes out sorted too.
             for (int i = 0; i < (int)carInfo.size(); ++i)
             {
                 const CarInfo& ci = carInfo[i];
                 const Car&     car = ir_session.cars[ci.carIdx];
                 const int      classId = ci.classIdx;
 
-                int summaryIdx;
-                auto it = classIdToIndex.find(classId);
-                if (it == classIdToIndex.end())
+                int summaryIdx = -1;
+                for (int c = 0; c < (int)classSummaries.size(); ++c)
                 {
-                    ClassSummary summary;
-                    summary.classId = classId;
-
-                    std::string classNameStr = car.carClassShortName;
-                    if (classNameStr.empty())
-                        classNameStr = std::format("Class {}", classId);
-
-                    summary.name = toWide(classNameStr);
-                    classSummaries.push_back(summary);
-                    summaryIdx = (int)classSummaries.size() - 1;
-                    classIdToIndex.emplace(classId, summaryIdx);
+                    if (classSummaries[c].classId == classId)
+                    {
+                        summaryIdx = c;
+                        break;
+                    }
                 }
-                else
+                if (summaryIdx < 0)
                 {
-                    summaryIdx = it->second;
+                    classSummaries.emplace_back();
+                    summaryIdx = (int)classSummaries.size() - 1;
+                    classSummaries[summaryIdx].classId = classId;
+                    classSummaries[summaryIdx].carIndices.reserve(IR_MAX_CARS);
                 }
 
                 ClassSummary& summary = classSummaries[summaryIdx];
+                if (summary.participants == 0 && (summary.name.empty() || summary.nameSrc != car.carClassShortName))
+                {
+                    summary.nameSrc = car.carClassShortName;
+                    summary.name = toWide(summary.nameSrc.empty() ? std::format("Class {}", classId) : summary.nameSrc);
+                }
                 summary.participants++;
                 if (car.irating > 0)
                 {
@@ -638,49 +643,42 @@ protected:
                 summary.carIndices.push_back(i);
             }
 
-            // Finalize per-class data: average SoF and sort cars by class position
+            // Finalize per-class data: average SoF
             for (auto& summary : classSummaries)
             {
                 const int sof = sofFromAccumulator(summary.sofExpSum, summary.sofCount);
                 // Reuse sofExpSum to store the final SoF (as a numeric value) to avoid larger refactors.
                 summary.sofExpSum = (double)sof;
-
-                std::sort(summary.carIndices.begin(), summary.carIndices.end(),
-                    [&](int aIndex, int bIndex)
-                    {
-                        const CarInfo& a = carInfo[aIndex];
-                        const CarInfo& b = carInfo[bIndex];
-                        const int ap = a.position <= 0 ? INT_MAX : a.position;
-                        const int bp = b.position <= 0 ? INT_MAX : b.position;
-                        return ap < bp;
-                    });
             }
 
-            // Sort classes: self class first, then by leader lap time (fastest first)
+            // Order classes: self class first, then by leader lap time (fastest first).
+            // Insertion sort over a handful of indices, starting from last frame's order.
             const int selfClassId = ciSelf.classIdx;
-            std::sort(classSummaries.begin(), classSummaries.end(),
-                [&](const ClassSummary& a, const ClassSummary& b)
-                {
-                    if (a.classId == selfClassId && b.classId != selfClassId) return true;
-                    if (b.classId == selfClassId && a.classId != selfClassId) return false;
-                    const float aBest = (a.leaderBest > 0.0f) ? a.leaderBest : FLT_MAX;
-                    const float bBest = (b.leaderBest > 0.0f) ? b.leaderBest : FLT_MAX;
-                    return aBest < bBest;
-                });
-
-            struct RenderRow
+            auto classBefore = [&](const ClassSummary& a, const ClassSummary& b)
             {
-                bool    isHeader = false;
-                int     classSummaryIndex = -1;
-                int     carInfoIndex = -1;    // -1 for header or spacer
-                int     rowIndexInClass = 0;  // 1-based for driver rows, 0 for headers, -1 for spacer rows
+                if (a.classId == selfClassId && b.classId != selfClassId) return true;
+                if (b.classId == selfClassId && a.classId != selfClassId) return false;
+                const float aBest = (a.leaderBest > 0.0f) ? a.leaderBest : FLT_MAX;
+                const float bBest = (b.leaderBest > 0.0f) ? b.leaderBest : FLT_MAX;
+                return aBest < bBest;
             };
+            std::vector<int>& classOrder = m_classOrder;
+            while (classOrder.size() < classSummaries.size())
+                classOrder.push_back((int)classOrder.size());
+            for (int i = 1; i < (int)classOrder.size(); ++i)
+            {
+                const int v = classOrder[i];
+                int j = i - 1;
+                for (; j >= 0 && classBefore(classSummaries[v], classSummaries[classOrder[j]]); --j)
+                    classOrder[j + 1] = classOrder[j];
+                classOrder[j + 1] = v;
+            }
 
-            std::vector<RenderRow> rows;
-            rows.reserve(carInfo.size() + (int)classSummaries.size() * 2);
+            std::vector<RenderRow>& rows = m_rows;
+            rows.clear();
 
             // Build a flattened row list: [Header, drivers..., spacer] per class
-            for (int c = 0; c < (int)classSummaries.size(); ++c)
+            for (int c : classOrder)
             {
                 const ClassSummary& summary = classSummaries[c];
                 if (summary.participants <= 0)
@@ -891,14 +889,15 @@ protected:
                     }
                     m_brush->SetColor(float4(0, 0, 0, 1));
                     swprintf(s, _countof(s), L"P%d", ci.position);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
                 }
 
                 // Car number
                 {
                     clm = m_columns.get((int)Columns::CAR_NUMBER);
                     // While driver is transmitting on voice, replace the car-number badge with the push-to-talk icon.
-                    if (isTalking && m_pushToTalkIcon)
+                    ID2D1Bitmap* pttIcon = isTalking ? m_pushToTalkIcon.Get(m_renderTarget.Get()) : nullptr;
+                    if (pttIcon)
                     {
                         const float cellL = xoff + clm->textL;
                         const float cellR = xoff + clm->textR;
@@ -906,7 +905,7 @@ protected:
                         const float iconSize = std::max(0.0f, std::min(lineHeight - 6.0f, cellW));
                         const float cx = (cellL + cellR) * 0.5f;
                         D2D1_RECT_F ir = { cx - iconSize * 0.5f, rowY - iconSize * 0.5f, cx + iconSize * 0.5f, rowY + iconSize * 0.5f };
-                        m_renderTarget->DrawBitmap(m_pushToTalkIcon.Get(), &ir);
+                        m_renderTarget->DrawBitmap(pttIcon, &ir);
                     }
                     else
                     {
@@ -931,7 +930,7 @@ protected:
                             m_renderTarget->FillRectangle(&strip, m_brush.Get());
                         }
                         m_brush->SetColor(float4(1, 1, 1, 1));
-                        m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                        m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
                     }
                 }
 
@@ -952,13 +951,13 @@ protected:
                 }
 
                 // Pit age
-                if (!ir_isPreStart() && (ci.pitAge >= 0 || ir_CarIdxOnPitRoad.getBool(ci.carIdx)))
+                if (!rs.isPreStart && (ci.pitAge >= 0 || rs.onPitRoad[ci.carIdx]))
                 {
                     if (clm = m_columns.get((int)Columns::PIT)) {
                         m_brush->SetColor(pitCol);
                         swprintf(s, _countof(s), L"%d", ci.pitAge);
                         r = { xoff + clm->textL, rowY - lineHeight / 2 + 2, xoff + clm->textR, rowY + lineHeight / 2 - 2 };
-                        if (ir_CarIdxOnPitRoad.getBool(ci.carIdx)) {
+                        if (rs.onPitRoad[ci.carIdx]) {
                             swprintf(s, _countof(s), L"PIT");
                             m_renderTarget->FillRectangle(&r, m_brush.Get());
                             m_brush->SetColor(float4(0, 0, 0, 1));
@@ -967,7 +966,7 @@ protected:
                             swprintf(s, _countof(s), L"%d", ci.pitAge);
                             m_renderTarget->DrawRectangle(&r, m_brush.Get());
                         }
-                        m_text.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                        m_num.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
                     }
                 }
 
@@ -983,7 +982,7 @@ protected:
                     m_brush->SetColor(c);
                     m_renderTarget->FillRoundedRectangle(&rr, m_brush.Get());
                     m_brush->SetColor(licenseTextCol);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
                 }
 
                 // Irating
@@ -996,36 +995,36 @@ protected:
                     m_brush->SetColor(iratingBgCol);
                     m_renderTarget->FillRoundedRectangle(&rr, m_brush.Get());
                     m_brush->SetColor(iratingTextCol);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                }
+
+                // iRating prediction - only meaningful in race sessions
+                if ((clm = m_columns.get((int)Columns::IR_PRED)) && ir_session.sessionType == SessionType::RACE) {
+                    const int irDelta = irPred.deltaFor(ci.carIdx);
+                    swprintf(s, _countof(s), L"%+d", irDelta);
+                    r = { xoff + clm->textL, rowY - lineHeight / 2, xoff + clm->textR, rowY + lineHeight / 2 };
+                    rr.rect = { r.left + 1, r.top + 1, r.right - 1, r.bottom - 1 };
+                    rr.radiusX = 3;
+                    rr.radiusY = 3;
+                    float4 bg = irDelta > 0 ? float4(0.2f, 0.75f, 0.2f, 0.85f) : (irDelta < 0 ? float4(0.9f, 0.2f, 0.2f, 0.85f) : float4(1, 1, 1, 0.85f));
+                    bg.w *= globalOpacity;
+                    m_brush->SetColor(bg);
+                    m_renderTarget->FillRoundedRectangle(&rr, m_brush.Get());
+                    float4 tcol = (irDelta == 0) ? float4(0, 0, 0, 0.9f) : float4(1, 1, 1, 0.95f);
+                    tcol.w *= globalOpacity;
+                    m_brush->SetColor(tcol);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
                 }
 
                 // Car brand
-                if ((clm = m_columns.get((int)Columns::CAR_BRAND)) && m_carBrandIconsLoaded)
+                if ((clm = m_columns.get((int)Columns::CAR_BRAND)) && CarBrandIcons::instance().available())
                 {
-                    if (m_carIdToIconMap.find(car.carID) == m_carIdToIconMap.end())
-                    {
-                        // Cache by *brand converter* first (dedupe across different carIDs using same manufacturer icon),
-                        // then map carID -> bitmap for fast lookup during rendering.
-                        IWICFormatConverter* conv = findCarBrandIcon(car.carName, m_carBrandIconsMap);
-                        if (conv)
-                        {
-                            auto& brandBmp = m_brandConvToBitmap[conv];
-                            if (!brandBmp)
-                            {
-                                (void)m_renderTarget->CreateBitmapFromWicBitmap(conv, nullptr, &brandBmp);
-                            }
-                            if (brandBmp)
-                            {
-                                m_carIdToIconMap[car.carID] = brandBmp;
-                            }
-                        }
-                    }
+                    auto itBrand = m_carIdToBrand.find(car.carID);
+                    if (itBrand == m_carIdToBrand.end())
+                        itBrand = m_carIdToBrand.emplace(car.carID, CarBrandIcons::instance().brandForCar(car.carName)).first;
 
-                    const auto itBmp = m_carIdToIconMap.find(car.carID);
-                    if (itBmp != m_carIdToIconMap.end() && itBmp->second) {
-                        D2D1_RECT_F br = { xoff + clm->textL, rowY - lineHeight / 2, xoff + clm->textL + lineHeight, rowY + lineHeight / 2 };
-                        m_renderTarget->DrawBitmap(itBmp->second.Get(), br);
-                    }
+                    const D2D1_RECT_F br = { xoff + clm->textL, rowY - lineHeight / 2, xoff + clm->textL + lineHeight, rowY + lineHeight / 2 };
+                    CarBrandIcons::instance().draw(m_renderTarget.Get(), itBrand->second, br);
                 }
 
                 // Positions gained
@@ -1039,9 +1038,9 @@ protected:
 
                     const int delta = ci.positionsChanged;
                     ID2D1Bitmap* icon = nullptr;
-                    if (delta > 0)      icon = m_posUpIcon.Get();
-                    else if (delta < 0) icon = m_posDownIcon.Get();
-                    else                icon = m_posEqualIcon.Get();
+                    if (delta > 0)      icon = m_posUpIcon.Get(m_renderTarget.Get());
+                    else if (delta < 0) icon = m_posDownIcon.Get(m_renderTarget.Get());
+                    else                icon = m_posEqualIcon.Get(m_renderTarget.Get());
 
                     const float iconPad = 4.0f;
                     const float iconSize = std::max(0.0f, lineHeight - 6.0f);
@@ -1053,7 +1052,7 @@ protected:
                     m_brush->SetColor(float4(0, 0, 0, 1));
                     swprintf(s, _countof(s), L"%d", abs(delta));
                     const float textL = r.left + iconPad + (icon ? iconSize + 2.0f : 0.0f);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), textL, r.right - 15.0f, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), textL, r.right - 15.0f, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING);
                 }
 
                 // Tire compound
@@ -1078,7 +1077,7 @@ protected:
                         else
                             swprintf(s, _countof(s), L"%.01f", ci.gap);
                         m_brush->SetColor(textCol);
-                        m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING);
+                        m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING);
                     }
                 }
 
@@ -1088,7 +1087,7 @@ protected:
                     if (ci.best > 0)
                         str = formatLaptime(ci.best);
                     m_brush->SetColor(ci.hasFastestLap ? fastestLapCol : textCol);
-                    m_text.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
                 }
 
                 // Last
@@ -1098,9 +1097,13 @@ protected:
                     if (ci.last > 0)
                         str = formatLaptime(ci.last);
                     m_brush->SetColor(textCol);
-                    m_text.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
                 }
 
+                // Sectors
+                if (clm = m_columns.get((int)Columns::SECTORS))
+                    drawSectorStrip(xoff + clm->textL, xoff + clm->textR, rowY, lineHeight * 0.3f, ci.carIdx, useStubData);
+
                 // Delta
                 if (clm = m_columns.get((int)Columns::DELTA))
                 {
@@ -1111,7 +1114,7 @@ protected:
                             m_brush->SetColor(deltaPosCol);
                         else
                             m_brush->SetColor(deltaNegCol);
-                        m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+                        m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
                     }
                 }
 
@@ -1129,7 +1132,7 @@ protected:
                     else
                         m_brush->SetColor(textCol);
 
-                    m_text.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, rowY, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
                 }
             }
 
@@ -1290,14 +1293,15 @@ protected:
                     }
                     m_brush->SetColor(float4(0, 0, 0, 1));
                     swprintf(s, _countof(s), L"P%d", ci.position);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
                 }
 
                 // Car number
                 {
                     clm = m_columns.get((int)Columns::CAR_NUMBER);
                     // While driver is transmitting on voice, replace the car-number badge with the push-to-talk icon.
-                    if (isTalking && m_pushToTalkIcon)
+                    ID2D1Bitmap* pttIcon = isTalking ? m_pushToTalkIcon.Get(m_renderTarget.Get()) : nullptr;
+                    if (pttIcon)
                     {
                         const float cellL = xoff + clm->textL;
                         const float cellR = xoff + clm->textR;
@@ -1305,7 +1309,7 @@ protected:
                         const float iconSize = std::max(0.0f, std::min(lineHeight - 6.0f, cellW));
                         const float cx = (cellL + cellR) * 0.5f;
                         D2D1_RECT_F ir = { cx - iconSize * 0.5f, y - iconSize * 0.5f, cx + iconSize * 0.5f, y + iconSize * 0.5f };
-                        m_renderTarget->DrawBitmap(m_pushToTalkIcon.Get(), &ir);
+                        m_renderTarget->DrawBitmap(pttIcon, &ir);
                     }
                     else
                     {
@@ -1330,7 +1334,7 @@ protected:
                             m_renderTarget->FillRectangle(&strip, m_brush.Get());
                         }
                         m_brush->SetColor(float4(1, 1, 1, 1));
-                        m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                        m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
                     }
                 }
 
@@ -1351,13 +1355,13 @@ protected:
                 }
 
                 // Pit age
-                if (!ir_isPreStart() && (ci.pitAge >= 0 || ir_CarIdxOnPitRoad.getBool(ci.carIdx)))
+                if (!rs.isPreStart && (ci.pitAge >= 0 || rs.onPitRoad[ci.carIdx]))
                 {
                     if (clm = m_columns.get((int)Columns::PIT)) {
                         m_brush->SetColor(pitCol);
                         swprintf(s, _countof(s), L"%d", ci.pitAge);
                         r = { xoff + clm->textL, y - lineHeight / 2 + 2, xoff + clm->textR, y + lineHeight / 2 - 2 };
-                        if (ir_CarIdxOnPitRoad.getBool(ci.carIdx)) {
+                        if (rs.onPitRoad[ci.carIdx]) {
                             swprintf(s, _countof(s), L"PIT");
                             m_renderTarget->FillRectangle(&r, m_brush.Get());
                             m_brush->SetColor(float4(0, 0, 0, 1));
@@ -1366,7 +1370,7 @@ protected:
                             swprintf(s, _countof(s), L"%d", ci.pitAge);
                             m_renderTarget->DrawRectangle(&r, m_brush.Get());
                         }
-                        m_text.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                        m_num.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
                     }
                 }
 
@@ -1382,7 +1386,7 @@ protected:
                     m_brush->SetColor(c);
                     m_renderTarget->FillRoundedRectangle(&rr, m_brush.Get());
                     m_brush->SetColor(licenseTextCol);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
                 }
 
                 // Irating
@@ -1395,34 +1399,36 @@ protected:
                     m_brush->SetColor(iratingBgCol);
                     m_renderTarget->FillRoundedRectangle(&rr, m_brush.Get());
                     m_brush->SetColor(iratingTextCol);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
+                }
+
+                // iRating prediction - only meaningful in race sessions
+                if ((clm = m_columns.get((int)Columns::IR_PRED)) && ir_session.sessionType == SessionType::RACE) {
+                    const int irDelta = irPred.deltaFor(ci.carIdx);
+                    swprintf(s, _countof(s), L"%+d", irDelta);
+                    r = { xoff + clm->textL, y - lineHeight / 2, xoff + clm->textR, y + lineHeight / 2 };
+                    rr.rect = { r.left + 1, r.top + 1, r.right - 1, r.bottom - 1 };
+                    rr.radiusX = 3;
+                    rr.radiusY = 3;
+                    float4 bg = irDelta > 0 ? float4(0.2f, 0.75f, 0.2f, 0.85f) : (irDelta < 0 ? float4(0.9f, 0.2f, 0.2f, 0.85f) : float4(1, 1, 1, 0.85f));
+                    bg.w *= globalOpacity;
+                    m_brush->SetColor(bg);
+                    m_renderTarget->FillRoundedRectangle(&rr, m_brush.Get());
+                    float4 tcol = (irDelta == 0) ? float4(0, 0, 0, 0.9f) : float4(1, 1, 1, 0.95f);
+                    tcol.w *= globalOpacity;
+                    m_brush->SetColor(tcol);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormatSmall.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER, m_fontSpacing);
                 }
 
                 // Car brand
-                if ((clm = m_columns.get((int)Columns::CAR_BRAND)) && m_carBrandIconsLoaded)
+                if ((clm = m_columns.get((int)Columns::CAR_BRAND)) && CarBrandIcons::instance().available())
                 {
-                    if (m_carIdToIconMap.find(car.carID) == m_carIdToIconMap.end())
-                    {
-                        IWICFormatConverter* conv = findCarBrandIcon(car.carName, m_carBrandIconsMap);
-                        if (conv)
-                        {
-                            auto& brandBmp = m_brandConvToBitmap[conv];
-                            if (!brandBmp)
-                            {
-                                (void)m_renderTarget->CreateBitmapFromWicBitmap(conv, nullptr, &brandBmp);
-                            }
-                            if (brandBmp)
-                            {
-                                m_carIdToIconMap[car.carID] = brandBmp;
-                            }
-                        }
-                    }
+                    auto itBrand = m_carIdToBrand.find(car.carID);
+                    if (itBrand == m_carIdToBrand.end())
+                        itBrand = m_carIdToBrand.emplace(car.carID, CarBrandIcons::instance().brandForCar(car.carName)).first;
 
-                    const auto itBmp = m_carIdToIconMap.find(car.carID);
-                    if (itBmp != m_carIdToIconMap.end() && itBmp->second) {
-                        D2D1_RECT_F br = { xoff + clm->textL, y - lineHeight / 2, xoff + clm->textL + lineHeight, y + lineHeight / 2 };
-                        m_renderTarget->DrawBitmap(itBmp->second.Get(), br);
-                    }
+                    const D2D1_RECT_F br = { xoff + clm->textL, y - lineHeight / 2, xoff + clm->textL + lineHeight, y + lineHeight / 2 };
+                    CarBrandIcons::instance().draw(m_renderTarget.Get(), itBrand->second, br);
                 }
 
                 // Positions gained
@@ -1436,9 +1442,9 @@ protected:
 
                     const int delta = ci.positionsChanged;
                     ID2D1Bitmap* icon = nullptr;
-                    if (delta > 0)      icon = m_posUpIcon.Get();
-                    else if (delta < 0) icon = m_posDownIcon.Get();
-                    else                icon = m_posEqualIcon.Get();
+                    if (delta > 0)      icon = m_posUpIcon.Get(m_renderTarget.Get());
+                    else if (delta < 0) icon = m_posDownIcon.Get(m_renderTarget.Get());
+                    else                icon = m_posEqualIcon.Get(m_renderTarget.Get());
 
                     const float iconPad = 4.0f;
                     const float iconSize = std::max(0.0f, lineHeight - 6.0f);
@@ -1450,7 +1456,7 @@ protected:
                     m_brush->SetColor(float4(0, 0, 0, 1));
                     swprintf(s, _countof(s), L"%d", abs(delta));
                     const float textL = r.left + iconPad + (icon ? iconSize + 2.0f : 0.0f);
-                    m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), textL, r.right - 15.0f, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING);
+                    m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), textL, r.right - 15.0f, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING);
                 }
 
                 // Tire compound
@@ -1475,7 +1481,7 @@ protected:
                         else
                             swprintf(s, _countof(s), L"%.01f", ci.gap);
                         m_brush->SetColor(textCol);
-                        m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING);
+                        m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING);
                     }
                 }
 
@@ -1485,7 +1491,7 @@ protected:
                     if (ci.best > 0)
                         str = formatLaptime(ci.best);
                     m_brush->SetColor(ci.hasFastestLap ? fastestLapCol : textCol);
-                    m_text.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
                 }
 
                 // Last
@@ -1495,9 +1501,13 @@ protected:
                     if (ci.last > 0)
                         str = formatLaptime(ci.last);
                     m_brush->SetColor(textCol);
-                    m_text.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
                 }
 
+                // Sectors
+                if (clm = m_columns.get((int)Columns::SECTORS))
+                    drawSectorStrip(xoff + clm->textL, xoff + clm->textR, y, lineHeight * 0.3f, ci.carIdx, useStubData);
+
                 // Delta
                 if (clm = m_columns.get((int)Columns::DELTA))
                 {
@@ -1508,7 +1518,7 @@ protected:
                             m_brush->SetColor(deltaPosCol);
                         else
                             m_brush->SetColor(deltaNegCol);
-                        m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+                        m_num.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
                     }
                 }
 
@@ -1526,7 +1536,7 @@ protected:
                     else
                         m_brush->SetColor(textCol);
 
-                    m_text.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
+                    m_num.render(m_renderTarget.Get(), toWide(str).c_str(), m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING, m_fontSpacing);
                 }
             }
 
@@ -1590,15 +1600,15 @@ protected:
             };
 
             if (g_cfg.getBool(m_name, "show_session_end", true)) {
-                leftItems.push_back({ m_iconSessionTime.Get(), toWide(std::vformat("{}:{:0>2}:{:0>2}", std::make_format_args(hours, mins, secs))), 0.0f });
+                leftItems.push_back({ m_iconSessionTime.Get(m_renderTarget.Get()), toWide(std::vformat("{}:{:0>2}:{:0>2}", std::make_format_args(hours, mins, secs))), 0.0f });
             }
             if (g_cfg.getBool(m_name, "show_track_temp", true)) {
                 wchar_t buf[64];
                 swprintf(buf, _countof(buf), L"%.1f\x00B0%c", trackTemp, tempUnit);
-                rightItems.push_back({ m_iconTrackTemp.Get(), std::wstring(buf), 0.0f });
+                rightItems.push_back({ m_iconTrackTemp.Get(m_renderTarget.Get()), std::wstring(buf), 0.0f });
             }
             if (g_cfg.getBool(m_name, "show_laps", true)) {
-                rightItems.push_back({ m_iconLaps.Get(), toWide(std::format("{}/{}{}", laps, (irTotalLaps == 32767 ? "~" : ""), totalLaps)), 0.0f });
+                rightItems.push_back({ m_iconLaps.Get(m_renderTarget.Get()), toWide(std::format("{}/{}{}", laps, (irTotalLaps == 32767 ? "~" : ""), totalLaps)), 0.0f });
             }
 
             const float fontSize = g_cfg.getFloat("Overlay", "font_size", 16.0f);
@@ -1614,7 +1624,7 @@ protected:
                     it.width = (it.icon ? iconSize + iconPad : 0.0f) + measure(it.text);
                     // Enforce a minimum width for session time equal to width of "999:99:99"
                     float minItemW = 0.0f;
-                    if (it.icon == m_iconSessionTime.Get()) {
+                    if (it.icon == m_iconSessionTime.Get(m_renderTarget.Get())) {
                         const float minTextW = computeTextExtent(L"999:99:99", m_dwriteFactory.Get(), m_textFormatSmall.Get(), m_fontSpacing).x;
                         minItemW = (it.icon ? iconSize + iconPad : 0.0f) + minTextW + 6.0f;
                     }
@@ -1685,34 +1695,11 @@ protected:
     // Loads position change icons (up/down/equal) once
     void loadPositionIcons()
     {
-        if (!m_renderTarget.Get()) return;
-        if (m_posUpIcon || m_posDownIcon || m_posEqualIcon || m_pushToTalkIcon) return;
-
-        (void)CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-        if (!m_wicFactory.Get()) {
-            (void)CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&m_wicFactory));
-        }
-        if (!m_wicFactory.Get()) return;
-
-        auto loadPng = [&](const std::wstring& rel) -> Microsoft::WRL::ComPtr<ID2D1Bitmap>
-        {
-            Microsoft::WRL::ComPtr<ID2D1Bitmap> bmp;
-            Microsoft::WRL::ComPtr<IWICBitmapDecoder> dec;
-            Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
-            Microsoft::WRL::ComPtr<IWICFormatConverter> conv;
-            const std::wstring path = resolveAssetPathW(rel);
-            if (FAILED(m_wicFactory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &dec))) return bmp;
-            if (FAILED(dec->GetFrame(0, &frame))) return bmp;
-            if (FAILED(m_wicFactory->CreateFormatConverter(&conv))) return bmp;
-            if (FAILED(conv->Initialize(frame.Get(), GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut))) return bmp;
-            (void)m_renderTarget->CreateBitmapFromWicBitmap(conv.Get(), nullptr, &bmp);
-            return bmp;
-        };
-
-        m_posUpIcon    = loadPng(L"assets\\icons\\up.png");
-        m_posDownIcon  = loadPng(L"assets\\icons\\down.png");
-        m_posEqualIcon = loadPng(L"assets\\icons\\equal.png");
-        m_pushToTalkIcon = loadPng(L"assets\\icons\\pushtotalk.png");
+        ImageAssets& assets = ImageAssets::instance();
+        m_posUpIcon      = assets.acquire(L"assets\\icons\\up.png");
+        m_posDownIcon    = assets.acquire(L"assets\\icons\\down.png");
+        m_posEqualIcon   = assets.acquire(L"assets\\icons\\equal.png");
+        m_pushToTalkIcon = assets.acquire(L"assets\\icons\\pushtotalk.png");
     }
 
     void releasePositionIcons()
@@ -1721,38 +1708,17 @@ protected:
         m_posDownIcon.Reset();
         m_posEqualIcon.Reset();
         m_pushToTalkIcon.Reset();
-        m_wicFactory.Reset();
     }
 
     // Footer icons
     void loadFooterIcons()
     {
-        if (!m_renderTarget.Get()) return;
-        if (m_iconIncidents || m_iconSoF || m_iconTrackTemp || m_iconSessionTime || m_iconLaps) return;
-        (void)CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-        if (!m_wicFactory.Get()) {
-            (void)CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&m_wicFactory));
-        }
-        if (!m_wicFactory.Get()) return;
-        auto loadPng = [&](const std::wstring& rel) -> Microsoft::WRL::ComPtr<ID2D1Bitmap>
-        {
-            Microsoft::WRL::ComPtr<ID2D1Bitmap> bmp;
-            Microsoft::WRL::ComPtr<IWICBitmapDecoder> dec;
-            Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
-            Microsoft::WRL::ComPtr<IWICFormatConverter> conv;
-            const std::wstring path = resolveAssetPathW(rel);
-            if (FAILED(m_wicFactory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &dec))) return bmp;
-            if (FAILED(dec->GetFrame(0, &frame))) return bmp;
-            if (FAILED(m_wicFactory->CreateFormatConverter(&conv))) return bmp;
-            if (FAILED(conv->Initialize(frame.Get(), GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut))) return bmp;
-            (void)m_renderTarget->CreateBitmapFromWicBitmap(conv.Get(), nullptr, &bmp);
-            return bmp;
-        };
-        m_iconIncidents   = loadPng(L"assets\\icons\\incidents.png");
-        m_iconSoF         = loadPng(L"assets\\icons\\SoF.png");
-        m_iconTrackTemp   = loadPng(L"assets\\icons\\temp_dark.png");
-        m_iconSessionTime = loadPng(L"assets\\icons\\session_time.png");
-        m_iconLaps        = loadPng(L"assets\\icons\\laps.png");
+        ImageAssets& assets = ImageAssets::instance();
+        m_iconIncidents   = assets.acquire(L"assets\\icons\\incidents.png");
+        m_iconSoF         = assets.acquire(L"assets\\icons\\SoF.png");
+        m_iconTrackTemp   = assets.acquire(L"assets\\icons\\temp_dark.png");
+        m_iconSessionTime = assets.acquire(L"assets\\icons\\session_time.png");
+        m_iconLaps        = assets.acquire(L"assets\\icons\\laps.png");
     }
 
     void releaseFooterIcons()
@@ -1766,29 +1732,113 @@ protected:
 
     Microsoft::WRL::ComPtr<IDWriteTextFormat>  m_textFormat;
     Microsoft::WRL::ComPtr<IDWriteTextFormat>  m_textFormatSmall;
-    std::vector<std::vector<float>> m_avgL5Times;
-    bool m_carBrandIconsLoaded;
-    std::map<std::string, IWICFormatConverter*> m_carBrandIconsMap;
-    std::map<IWICFormatConverter*, Microsoft::WRL::ComPtr<ID2D1Bitmap>> m_brandConvToBitmap;
-    std::map<int, Microsoft::WRL::ComPtr<ID2D1Bitmap>> m_carIdToIconMap;
+    std::map<int, int> m_carIdToBrand;         // carID -> CarBrandIcons brand index (-1: none)
     std::set<std::string> notFoundBrands;
 
     // Position change icons
-    Microsoft::WRL::ComPtr<IWICImagingFactory> m_wicFactory;
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_posUpIcon;
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_posDownIcon;
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_posEqualIcon;
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_pushToTalkIcon;
+    ImageAssets::Ref m_posUpIcon;
+    ImageAssets::Ref m_posDownIcon;
+    ImageAssets::Ref m_posEqualIcon;
+    ImageAssets::Ref m_pushToTalkIcon;
 
     // Footer icons bitmaps
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_iconIncidents;
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_iconSoF;
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_iconTrackTemp;
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_iconSessionTime;
-    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_iconLaps;
+    ImageAssets::Ref m_iconIncidents;
+    ImageAssets::Ref m_iconSoF;
+    ImageAssets::Ref m_iconTrackTemp;
+    ImageAssets::Ref m_iconSessionTime;
+    ImageAssets::Ref m_iconLaps;
+
+    struct CarInfo {
+        int     carIdx = 0;
+        int     classIdx = 0;
+        int     lapCount = 0;
+        float   pctAroundLap = 0;
+        int     lapGap = 0;
+        float   gap = 0;
+        float   delta = 0;
+        int     position = 0;
+        float   best = 0;
+        float   last = 0;
+        float   l5 = 0;
+        bool    hasFastestLap = false;
+        int     pitAge = 0;
+        int     positionsChanged = 0;
+        int     tireCompound = -1;
+    };
+
+    struct ClassSummary
+    {
+        int                 classId = 0;
+        std::string         nameSrc;
+        std::wstring        name;
+        int                 participants = 0;
+        double              sofExpSum = 0.0; // accumulate exp(-iR/br1) for glommed SoF
+        int                 sofCount = 0;
+        float               leaderBest = 0.0f;
+        std::vector<int>    carIndices;     // indices into m_carInfo
+    };
+
+    struct RenderRow
+    {
+        bool    isHeader = false;
+        int     classSummaryIndex = -1;
+        int     carInfoIndex = -1;    // -1 for header or spacer
+        int     rowIndexInClass = 0;  // 1-based for driver rows, 0 for headers, -1 for spacer rows
+    };
+
+    // Puts m_carInfo into position order. Starts from last frame's order, so the insertion sort
+    // only has to move the few cars that changed places: O(n) on a quiet frame.
+    void orderByPosition( const std::array<int, IR_MAX_CARS>& carInfoIndexByCarIdx )
+    {
+        auto posKey = []( const CarInfo& ci ) { return ci.position <= 0 ? INT_MAX : ci.position; };
+
+        bool placed[IR_MAX_CARS] = {};
+        m_carInfoSorted.clear();
+        for( int carIdx : m_order )
+        {
+            const int k = carInfoIndexByCarIdx[carIdx];
+            if( k < 0 )
+                continue;
+            m_carInfoSorted.push_back( m_carInfo[k] );
+            placed[carIdx] = true;
+        }
+        for( const CarInfo& ci : m_carInfo )
+        {
+            if( ci.carIdx < 0 || ci.carIdx >= IR_MAX_CARS || !placed[ci.carIdx] )
+                m_carInfoSorted.push_back( ci );
+        }
+
+        for( int i=1; i<(int)m_carInfoSorted.size(); ++i )
+        {
+            const CarInfo v = m_carInfoSorted[i];
+            const int key = posKey( v );
+            int j = i - 1;
+            for( ; j >= 0 && posKey(m_carInfoSorted[j]) > key; --j )
+                m_carInfoSorted[j+1] = m_carInfoSorted[j];
+            m_carInfoSorted[j+1] = v;
+        }
+
+        m_order.clear();
+        for( const CarInfo& ci : m_carInfoSorted )
+        {
+            if( ci.carIdx >= 0 && ci.carIdx < IR_MAX_CARS )
+                m_order.push_back( ci.carIdx );
+        }
+        m_carInfo.swap( m_carInfoSorted );
+    }
+
+    // Standings rows and their ordering, kept across frames
+    std::vector<CarInfo>        m_carInfo;
+    std::vector<CarInfo>        m_carInfoSorted;
+    std::vector<int>            m_order;            // carIdx in last frame's display order
+    std::vector<ClassSummary>   m_classSummaries;
+    std::vector<int>            m_classOrder;       // indices into m_classSummaries, display order
+    IRatingPredictor            m_irPredStub;       // preview mode only; live data uses ir_race.irPred
+    std::vector<RenderRow>      m_rows;
 
     ColumnLayout m_columns;
     TextCache m_text;
+    NumericText m_num;
     int m_scrollRow = 0;
     int m_maxScrollRow = 0;
     float m_fontSpacing = getGlobalFontSpacing();
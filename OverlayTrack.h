@@ -29,9 +29,11 @@ SOFTWARE.
 #include <algorithm>
 #include <limits>
 #include <d2d1.h>
-#include "picojson.h"
+#include <d2d1_3.h>
+#include "TrackPathDb.h"
 #include "Overlay.h"
 #include "iracing.h"
+#include "RaceState.h"
 #include "Config.h"
 #include "util.h"
 #include "ClassColors.h"
@@ -52,7 +54,7 @@ protected:
 
     virtual void onEnable()
     {   
-        loadPathFromJson();
+        loadPath();
         onConfigChanged();
         m_autoOffset = 0.0f;
         m_hasAutoOffset = false;
@@ -63,6 +65,8 @@ protected:
     virtual void onDisable()
     {
         m_trackPath.clear();
+        m_pathCumLength.clear();
+        releasePathLayout();
         m_autoOffset = 0.0f;
         m_hasAutoOffset = false;
         m_prevPctSample = -1.0f;
@@ -72,7 +76,7 @@ protected:
 
     virtual void onSessionChanged()
     {
-        loadPathFromJson();
+        loadPath();
         m_autoOffset = 0.0f;
         m_hasAutoOffset = false;
         m_prevPctSample = -1.0f;
@@ -84,8 +88,8 @@ protected:
         m_text.reset( m_dwriteFactory.Get() );
         createGlobalTextFormat(1.0f, m_textFormat);
         createGlobalTextFormat(0.7f, m_textFormatSmall);
-        // Rebuild cached geometry on size changes
-        m_cachedPathGeometry.Reset();
+        // Track width or colors may have changed
+        releasePathLayout();
         // Per-overlay FPS (configurable; default 10)
         setTargetFPS(g_cfg.getInt(m_name, "target_fps", 15));
     }
@@ -102,6 +106,10 @@ protected:
 
     virtual void onUpdate()
     {
+        // The track database may still have been rebuilding when we first asked for this track
+        if (m_lastTrackId < 0 && m_trackDbGeneration != TrackPathDb::instance().generation())
+            loadPath();
+
         // Cache global opacity to avoid multiple function calls
         const float globalOpacity = getGlobalOpacity();
 
@@ -134,7 +142,7 @@ protected:
             pct = s_p;
         } else {
             int self = ir_session.driverCarIdx;
-            if (self >= 0) pct = ir_CarIdxLapDistPct.getFloat(self);
+            if (self >= 0) pct = ir_race.lapDistPct[self];
         }
 
         // Auto-align S/F crossing (detect wrap high->low once) and allow manual offset and reverse
@@ -183,91 +191,29 @@ protected:
         // Scale and draw track path to fill the overlay area
         if (m_trackPath.size() >= 2)
         {
-            float minX = 1.0f, maxX = 0.0f, minY = 1.0f, maxY = 0.0f;
-            for (const auto& pt : m_trackPath) {
-                minX = std::min(minX, pt.x);
-                maxX = std::max(maxX, pt.x);
-                minY = std::min(minY, pt.y);
-                maxY = std::max(maxY, pt.y);
-            }
-
-            // Add padding
-            const float padding = 0.1f;
-            const float padW = (maxX - minX) * padding;
-            const float padH = (maxY - minY) * padding;
-            minX -= padW; maxX += padW;
-            minY -= padH; maxY += padH;
-
-            const float pathW = maxX - minX;
-            const float pathH = maxY - minY;
-
-            // Scale to fit overlay while preserving aspect ratio
-            const float scale = std::min(overlayW / pathW, overlayH / pathH);
-            const float scaledW = pathW * scale;
-            const float scaledH = pathH * scale;
-            const float offsetX = (overlayW - scaledW) * 0.5f;
-            const float offsetY = (overlayH - scaledH) * 0.5f;
-
-            if (!m_cachedPathGeometry) {
-                if (m_trackPath.size() >= 3) {
-                    Microsoft::WRL::ComPtr<ID2D1PathGeometry> pathGeometry;
-                    Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
-                    if (SUCCEEDED(m_d2dFactory->CreatePathGeometry(&pathGeometry)) && SUCCEEDED(pathGeometry->Open(&sink))) {
-                        const float2 start = m_trackPath[0];
-                        const float startX = dest.left + offsetX + (start.x - minX) * scale;
-                        const float startY = dest.top + offsetY + (start.y - minY) * scale;
-                        sink->BeginFigure(D2D1::Point2F(startX, startY), D2D1_FIGURE_BEGIN_HOLLOW);
-                        for (size_t i = 1; i < m_trackPath.size(); ++i) {
-                            const float2 pt = m_trackPath[i];
-                            const float ptX = dest.left + offsetX + (pt.x - minX) * scale;
-                            const float ptY = dest.top + offsetY + (pt.y - minY) * scale;
-                            sink->AddLine(D2D1::Point2F(ptX, ptY));
-                        }
-                        sink->EndFigure(D2D1_FIGURE_END_CLOSED);
-                        sink->Close();
-                        m_cachedPathGeometry = pathGeometry;
-                        m_cachedTrackWidth = g_cfg.getFloat(m_name, "track_width", 6.0f);
-                        // Cache total path length in normalized space
-                        m_totalPathLength = 0.0f;
-                        for (size_t i = 1; i < m_trackPath.size(); ++i)
-                            m_totalPathLength += distance(m_trackPath[i-1], m_trackPath[i]);
-                    }
-                }
-            }
+            ensurePathLayout();
 
             if (m_cachedPathGeometry) {
                 const float trackWidth = m_cachedTrackWidth;
                 const float outlineWidth = trackWidth * 2.0f;
-                m_brush->SetColor(trackBorderCol);
-                m_renderTarget->DrawGeometry(m_cachedPathGeometry.Get(), m_brush.Get(), outlineWidth);
-                m_brush->SetColor(trackCol);
-                m_renderTarget->DrawGeometry(m_cachedPathGeometry.Get(), m_brush.Get(), trackWidth);
+                drawPathStroke(m_outlineRealization.Get(), trackBorderCol, outlineWidth);
+                drawPathStroke(m_trackRealization.Get(), trackCol, trackWidth);
 
                 // Colored sector overlays on top of base path
                 if (g_cfg.getBool(m_name, "color_sectors", false) && m_sectorColors.size() >= 1)
                 {
                     buildAdjustedSectorStarts();
                     ensureSectorArraysSized();
-                    for (int s = 0; s + 1 < (int)m_sectorStartsAdjusted.size(); ++s)
+                    ensureSectorGeometries();
+                    for (int s = 0; s + 1 < (int)m_sectorStartsAdjusted.size() && s < (int)m_sectorGeometries.size(); ++s)
                     {
                         const float4 col = m_sectorColors[s];
-                        if (col.a <= 0.0f) continue;
-                        drawTrackSubPath(
-                            m_sectorStartsAdjusted[s],
-                            m_sectorStartsAdjusted[s+1],
-                            col,
-                            trackWidth,
-                            minX, minY, scale, offsetX, offsetY,
-                            dest.left, dest.top
-                        );
+                        if (col.a <= 0.0f || !m_sectorGeometries[s]) continue;
+                        m_brush->SetColor(col);
+                        m_renderTarget->DrawGeometry(m_sectorGeometries[s].Get(), m_brush.Get(), trackWidth);
                     }
                 }
             }
-
-            // Store scaling info for marker positioning
-            m_pathBounds = float4(minX, minY, maxX, maxY);
-            m_pathScale = scale;
-            m_pathOffset = float2(offsetX, offsetY);
         }
 
         // Draw sector and extended lines
@@ -279,28 +225,17 @@ protected:
                 const float centerX = dest.left + m_pathOffset.x + (pos.x - m_pathBounds.x) * m_pathScale;
                 const float centerY = dest.top + m_pathOffset.y + (pos.y - m_pathBounds.y) * m_pathScale;
                 float2 dir = float2(0, 1);
-                if (m_trackPath.size() >= 2) {
-                    float total = 0.0f;
-                    for (size_t i = 1; i < m_trackPath.size(); ++i)
-                        total += distance(m_trackPath[i-1], m_trackPath[i]);
-                    float target = linePos * total;
-                    float acc = 0.0f;
-                    for (size_t i = 1; i < m_trackPath.size(); ++i) {
-                        float seg = distance(m_trackPath[i-1], m_trackPath[i]);
-                        if (acc + seg >= target) {
-                            float2 tangent = float2(
-                                m_trackPath[i].x - m_trackPath[i-1].x,
-                                m_trackPath[i].y - m_trackPath[i-1].y
-                            );
-                            float len = sqrtf(tangent.x * tangent.x + tangent.y * tangent.y);
-                            if (len > 0.0001f) {
-                                tangent.x /= len;
-                                tangent.y /= len;
-                                dir = float2(-tangent.y, tangent.x);
-                            }
-                            break;
-                        }
-                        acc += seg;
+                const size_t seg = pathSegmentAt(linePos * m_totalPathLength);
+                if (seg > 0) {
+                    float2 tangent = float2(
+                        m_trackPath[seg].x - m_trackPath[seg-1].x,
+                        m_trackPath[seg].y - m_trackPath[seg-1].y
+                    );
+                    float len = sqrtf(tangent.x * tangent.x + tangent.y * tangent.y);
+                    if (len > 0.0001f) {
+                        tangent.x /= len;
+                        tangent.y /= len;
+                        dir = float2(-tangent.y, tangent.x);
                     }
                 }
                 const float lineLength = std::min(overlayW, overlayH) * 0.06f;
@@ -367,7 +302,7 @@ protected:
                         carPct = s_baseOffset[i];
                     }
                 } else {
-                    carPct = ir_CarIdxLapDistPct.getFloat(i);
+                    carPct = ir_race.lapDistPct[i];
                 }
                 
                 if (carPct < 0.0f) continue;
@@ -394,7 +329,7 @@ protected:
                         bool isFirstLap = currentLap <= 1;
                         int sessionFlags = ir_SessionFlags.getInt();
                         bool underCaution = (sessionFlags & (irsdk_caution | irsdk_cautionWaving)) != 0;
-                        bool preStart = ir_isPreStart();
+                        bool preStart = ir_race.isPreStart;
 
                         isPaceCar = (isRaceSession && isFirstLap) || underCaution || preStart;
                     }
@@ -538,6 +473,7 @@ protected:
 
 private:
     int m_lastTrackId = -1;
+    unsigned m_trackDbGeneration = 0;
     std::vector<float2> m_trackPath;
     std::vector<float> m_extendedLines;
     std::vector<float> m_sectorLines; 
@@ -555,57 +491,52 @@ private:
     Microsoft::WRL::ComPtr<IDWriteTextFormat> m_textFormat;
     Microsoft::WRL::ComPtr<IDWriteTextFormat> m_textFormatSmall;
     TextCache    m_text;
-    // Cached drawing data to avoid rebuilding each frame
+    // Cached drawing data to avoid rebuilding each frame. All of it is in pixel space and
+    // only rebuilt when the layout key changes (resize, new render target, track, width).
+    struct PathLayoutKey
+    {
+        int                 width = 0;
+        int                 height = 0;
+        unsigned            pathGeneration = 0;
+        float               trackWidth = 0.0f;
+        ID2D1RenderTarget*  renderTarget = nullptr;
+
+        bool operator==( const PathLayoutKey& o ) const {
+            return width == o.width && height == o.height && pathGeneration == o.pathGeneration
+                && trackWidth == o.trackWidth && renderTarget == o.renderTarget;
+        }
+    };
+    PathLayoutKey m_pathLayoutKey;
+    bool          m_pathLayoutValid = false;
     Microsoft::WRL::ComPtr<ID2D1PathGeometry> m_cachedPathGeometry;
+    Microsoft::WRL::ComPtr<ID2D1DeviceContext1> m_dc1;   // m_renderTarget as a Direct2D 1.2 context, if it is one
+    Microsoft::WRL::ComPtr<ID2D1GeometryRealization> m_outlineRealization;
+    Microsoft::WRL::ComPtr<ID2D1GeometryRealization> m_trackRealization;
+    std::vector<Microsoft::WRL::ComPtr<ID2D1PathGeometry>> m_sectorGeometries;
+    std::vector<float> m_sectorGeometryStarts;
     float m_cachedTrackWidth = 6.0f;
 
+    // Cumulative path length at each point (normalized space), rebuilt when the path loads
+    std::vector<float> m_pathCumLength;
+    float4   m_pathRawBounds = float4(0, 0, 1, 1);
+    unsigned m_pathGeneration = 0;
+
     // Sector timing coloring
-    std::vector<float> m_sectorBestPersonal;
-    std::vector<float> m_sectorBestSession;
     std::vector<float4> m_sectorColors;
     float m_totalPathLength = 0.0f;
 
-    // Per-car sector tracking state
-    float  m_prevPctPerCar[IR_MAX_CARS] = { -1.0f };
-    double m_lastBoundaryTimePerCar[IR_MAX_CARS] = { -1.0 };
-    bool   m_perCarInitialized = false;
-    bool   m_hasCrossedSFPerCar[IR_MAX_CARS] = { false };
-    int    m_lastIncidentCountPerCar[IR_MAX_CARS] = { 0 };
-    bool   m_wasInPitStallSelf = false;
-    double m_lastTimingNow = -1.0;
-
 
-    void loadPathFromJson()
+    void loadPath()
     {
         // Reset current path and extended lines
         m_trackPath.clear();
         m_extendedLines.clear();
         m_sectorLines.clear();
+        m_pathCumLength.clear();
+        m_totalPathLength = 0.0f;
         m_lastTrackId = -1;
-
-        // Load JSON
-        std::wstring jsonPath = resolveAssetPathW(L"assets\\tracks\\track-paths.json");
-        std::string jsonText;
-        if (!loadFileW(jsonPath, jsonText)) return;
-
-        picojson::value root;
-        std::string err = picojson::parse(root, jsonText);
-        if (!err.empty() || !root.is<picojson::object>()) return;
-        const auto& obj = root.get<picojson::object>();
-
-        auto getArray = [&](const picojson::object& o, const std::string& key)->const picojson::array*{
-            auto it = o.find(key);
-            if (it == o.end() || !it->second.is<picojson::array>()) return nullptr;
-            return &it->second.get<picojson::array>();
-        };
-        auto getObject = [&](const picojson::object& o, const std::string& key)->const picojson::object*{
-            auto it = o.find(key);
-            if (it == o.end() || !it->second.is<picojson::object>()) return nullptr;
-            return &it->second.get<picojson::object>();
-        };
-
-        const picojson::object* byId = getObject(obj, "tracksById");
-        if (!byId) return;
+        ++m_pathGeneration;
+        m_trackDbGeneration = TrackPathDb::instance().generation();
 
         int id = ir_session.trackId;
         // In preview mode, default to Snetterton 300
@@ -613,43 +544,28 @@ private:
             id = 489; // Snetterton 300
         }
         if (id <= 0) return;
-        
-        const std::string idStr = std::to_string(id);
-        auto itId = byId->find(idStr);
-        if (itId == byId->end() || !itId->second.is<picojson::object>()) {
-            OutputDebugStringA("OverlayTrack: no entry in track-paths.json for current trackId\n");
+
+        TrackPathDb::Track trk;
+        if (!TrackPathDb::instance().find(id, trk)) {
+            OutputDebugStringA("OverlayTrack: no entry in track-paths.db for current trackId\n");
             return;
         }
-        const picojson::object& trk = itId->second.get<picojson::object>();
-        const picojson::array* pts = getArray(trk, "points");
-        if (!pts) return;
-
-        for (const auto& v : *pts) {
-            if (!v.is<picojson::array>()) continue;
-            const auto& pair = v.get<picojson::array>();
-            if (pair.size() < 2) continue;
-            if (!pair[0].is<double>() || !pair[1].is<double>()) continue;
-            float nx = (float)pair[0].get<double>();
-            float ny = (float)pair[1].get<double>();
-            nx = std::clamp(nx, 0.0f, 1.0f);
-            ny = std::clamp(ny, 0.0f, 1.0f);
+
+        m_trackPath.reserve(trk.pointCount + 1);
+        for (uint32_t i = 0; i < trk.pointCount; ++i) {
+            const float nx = std::clamp(trk.points[i].x, 0.0f, 1.0f);
+            const float ny = std::clamp(trk.points[i].y, 0.0f, 1.0f);
             m_trackPath.emplace_back(nx, ny);
         }
 
         if (!m_trackPath.empty() && (m_trackPath.front().x != m_trackPath.back().x || m_trackPath.front().y != m_trackPath.back().y))
             m_trackPath.push_back(m_trackPath.front());
 
+        buildPathMetrics();
+
         // Load extendedLine data if present
-        const picojson::array* extLines = getArray(trk, "extendedLine");
-        if (extLines) {
-            for (const auto& v : *extLines) {
-                if (v.is<double>()) {
-                    float pos = (float)v.get<double>();
-                    pos = std::clamp(pos, 0.0f, 1.0f);
-                    m_extendedLines.push_back(pos);
-                }
-            }
-        }
+        for (uint32_t i = 0; i < trk.extendedLineCount; ++i)
+            m_extendedLines.push_back(std::clamp(trk.extendedLine[i], 0.0f, 1.0f));
 
         // Build sector lines and boundaries from SDK-provided SplitTimeInfo
         m_sectorLines.clear();
@@ -669,31 +585,148 @@ private:
         OutputDebugStringA(buf);
     }
 
+    // Per-path data that doesn't depend on the overlay size: padded bounds and cumulative lengths.
+    void buildPathMetrics()
+    {
+        m_pathCumLength.clear();
+        m_totalPathLength = 0.0f;
+        if (m_trackPath.empty()) return;
+
+        float minX = 1.0f, maxX = 0.0f, minY = 1.0f, maxY = 0.0f;
+        m_pathCumLength.reserve(m_trackPath.size());
+        for (size_t i = 0; i < m_trackPath.size(); ++i) {
+            const float2& pt = m_trackPath[i];
+            minX = std::min(minX, pt.x);
+            maxX = std::max(maxX, pt.x);
+            minY = std::min(minY, pt.y);
+            maxY = std::max(maxY, pt.y);
+            if (i > 0)
+                m_totalPathLength += distance(m_trackPath[i-1], pt);
+            m_pathCumLength.push_back(m_totalPathLength);
+        }
+
+        // Add padding
+        const float padding = 0.1f;
+        const float padW = (maxX - minX) * padding;
+        const float padH = (maxY - minY) * padding;
+        m_pathRawBounds = float4(minX - padW, minY - padH, maxX + padW, maxY + padH);
+    }
+
+    // Index i of the segment [i-1, i] containing the given distance along the path (0 if no path).
+    size_t pathSegmentAt(float dist) const
+    {
+        if (m_pathCumLength.size() < 2) return 0;
+        auto it = std::lower_bound(m_pathCumLength.begin() + 1, m_pathCumLength.end(), dist);
+        if (it == m_pathCumLength.end()) --it;
+        return (size_t)(it - m_pathCumLength.begin());
+    }
+
     float2 computeMarkerPosition(float pct)
     {
         if (m_trackPath.size() >= 2) {
-            // Compute total length
-            float total = 0.0f;
-            for (size_t i = 1; i < m_trackPath.size(); ++i)
-                total += distance(m_trackPath[i-1], m_trackPath[i]);
-            if (total <= 0.0f) return float2(0.5f, 0.5f);
-            float target = pct * total;
-            float acc = 0.0f;
-            for (size_t i = 1; i < m_trackPath.size(); ++i) {
-                float seg = distance(m_trackPath[i-1], m_trackPath[i]);
-                if (acc + seg >= target) {
-                    float t = (target - acc) / std::max(0.0001f, seg);
-                    return lerp(m_trackPath[i-1], m_trackPath[i], t);
-                }
-                acc += seg;
-            }
-            return m_trackPath.back();
+            if (m_totalPathLength <= 0.0f) return float2(0.5f, 0.5f);
+            const float target = pct * m_totalPathLength;
+            const size_t i = pathSegmentAt(target);
+            const float acc = m_pathCumLength[i-1];
+            const float seg = m_pathCumLength[i] - acc;
+            const float t = std::clamp((target - acc) / std::max(0.0001f, seg), 0.0f, 1.0f);
+            return lerp(m_trackPath[i-1], m_trackPath[i], t);
         }
         const float ang = pct * 6.2831853f - 1.5707963f;
         const float rx = 0.40f, ry = 0.40f;
         return float2(0.5f + cosf(ang) * rx, 0.5f + sinf(ang) * ry);
     }
 
+    D2D1_POINT_2F pathToScreen(const float2& p) const
+    {
+        return D2D1::Point2F(m_pathOffset.x + (p.x - m_pathBounds.x) * m_pathScale,
+                             m_pathOffset.y + (p.y - m_pathBounds.y) * m_pathScale);
+    }
+
+    void releasePathLayout()
+    {
+        m_pathLayoutValid = false;
+        m_cachedPathGeometry.Reset();
+        m_dc1.Reset();
+        m_outlineRealization.Reset();
+        m_trackRealization.Reset();
+        m_sectorGeometries.clear();
+        m_sectorGeometryStarts.clear();
+    }
+
+    // Fit the path into the overlay and (re)build the pixel-space geometry if the layout changed.
+    void ensurePathLayout()
+    {
+        PathLayoutKey key;
+        key.width = m_width;
+        key.height = m_height;
+        key.pathGeneration = m_pathGeneration;
+        key.trackWidth = g_cfg.getFloat(m_name, "track_width", 6.0f);
+        key.renderTarget = m_renderTarget.Get();
+        if (m_pathLayoutValid && key == m_pathLayoutKey)
+            return;
+
+        releasePathLayout();
+        m_pathLayoutKey = key;
+        m_pathLayoutValid = true;
+        m_cachedTrackWidth = key.trackWidth;
+
+        // Scale to fit overlay while preserving aspect ratio
+        const float overlayW = (float)m_width;
+        const float overlayH = (float)m_height;
+        const float pathW = std::max(0.0001f, m_pathRawBounds.z - m_pathRawBounds.x);
+        const float pathH = std::max(0.0001f, m_pathRawBounds.w - m_pathRawBounds.y);
+        const float scale = std::min(overlayW / pathW, overlayH / pathH);
+        m_pathBounds = m_pathRawBounds;
+        m_pathScale = scale;
+        m_pathOffset = float2((overlayW - pathW * scale) * 0.5f, (overlayH - pathH * scale) * 0.5f);
+
+        if (m_trackPath.size() < 3)
+            return;
+
+        Microsoft::WRL::ComPtr<ID2D1PathGeometry> pathGeometry;
+        Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
+        if (FAILED(m_d2dFactory->CreatePathGeometry(&pathGeometry)) || FAILED(pathGeometry->Open(&sink)))
+            return;
+        sink->BeginFigure(pathToScreen(m_trackPath[0]), D2D1_FIGURE_BEGIN_HOLLOW);
+        for (size_t i = 1; i < m_trackPath.size(); ++i)
+            sink->AddLine(pathToScreen(m_trackPath[i]));
+        sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+        if (FAILED(sink->Close()))
+            return;
+        m_cachedPathGeometry = pathGeometry;
+
+        // Pre-tessellate both strokes so steady-state frames skip geometry processing entirely.
+        // Realizations need a Direct2D 1.2 device context; plain DrawGeometry is the fallback.
+        // The render target is part of the layout key, so this queries each new target once.
+        if (SUCCEEDED(m_renderTarget.As(&m_dc1)))
+        {
+            const float tolerance = D2D1::ComputeFlatteningTolerance(D2D1::Matrix3x2F::Identity());
+            m_dc1->CreateStrokedGeometryRealization(m_cachedPathGeometry.Get(), tolerance, m_cachedTrackWidth * 2.0f, nullptr, &m_outlineRealization);
+            m_dc1->CreateStrokedGeometryRealization(m_cachedPathGeometry.Get(), tolerance, m_cachedTrackWidth, nullptr, &m_trackRealization);
+        }
+    }
+
+    void drawPathStroke(ID2D1GeometryRealization* realization, const float4& col, float width)
+    {
+        m_brush->SetColor(col);
+        if (realization && m_dc1)
+            m_dc1->DrawGeometryRealization(realization, m_brush.Get());
+        else
+            m_renderTarget->DrawGeometry(m_cachedPathGeometry.Get(), m_brush.Get(), width);
+    }
+
+    // Sector sub-paths only change with the layout or the (offset/direction adjusted) sector starts.
+    void ensureSectorGeometries()
+    {
+        if (!m_sectorGeometries.empty() && m_sectorGeometryStarts == m_sectorStartsAdjusted)
+            return;
+        m_sectorGeometryStarts = m_sectorStartsAdjusted;
+        m_sectorGeometries.clear();
+        for (int s = 0; s + 1 < (int)m_sectorStartsAdjusted.size(); ++s)
+            m_sectorGeometries.push_back(buildTrackSubPath(m_sectorStartsAdjusted[s], m_sectorStartsAdjusted[s+1]));
+    }
+
     static inline float distance(const float2& a, const float2& b)
     {
         const float dx = a.x - b.x;
@@ -715,18 +748,7 @@ private:
         m_sectorStartsAdjusted.clear();
         m_sectorsInitialized = false;
 
-        m_sectorBestPersonal.clear();
-        m_sectorBestSession.clear();
         m_sectorColors.clear();
-
-        for (int i = 0; i < IR_MAX_CARS; ++i) {
-            m_prevPctPerCar[i] = -1.0f;
-            m_lastBoundaryTimePerCar[i] = -1.0;
-            m_hasCrossedSFPerCar[i] = false;
-            m_lastIncidentCountPerCar[i] = 0;
-        }
-        m_perCarInitialized = false;
-        m_lastTimingNow = -1.0;
     }
 
     void buildAdjustedSectorStarts()
@@ -779,242 +801,94 @@ private:
         return std::clamp(pct, 0.0f, 0.9999f);
     }
 
-    int boundaryIndexAt(float pct) const
-    {
-        if (m_sectorStartsAdjusted.size() < 2) return 0;
-        int idx = 0;
-        for (int i = 0; i < (int)m_sectorStartsAdjusted.size(); ++i)
-            if (m_sectorStartsAdjusted[i] <= pct) idx = i;
-        return idx;
-    }
-
-    bool crossedBoundary(float prevPct, float curPct, float boundary) const
-    {
-        if (prevPct < 0.0f) return false;
-        if (prevPct <= curPct) {
-            return prevPct < boundary && boundary <= curPct;
-        } else {
-            // wrap around
-            return boundary > prevPct || boundary <= curPct;
-        }
-    }
-
     void ensureSectorArraysSized()
     {
         const int nBounds = (int)m_sectorStartsAdjusted.size();
         const int nSectors = nBounds > 0 ? nBounds - 1 : 0;
-        if ((int)m_sectorBestPersonal.size() != nSectors) {
-            m_sectorBestPersonal.assign(nSectors, std::numeric_limits<float>::infinity());
-        }
-        if ((int)m_sectorBestSession.size() != nSectors) {
-            m_sectorBestSession.assign(nSectors, std::numeric_limits<float>::infinity());
-        }
         if ((int)m_sectorColors.size() != nSectors) {
             m_sectorColors.assign(nSectors, float4(0,0,0,0));
         }
     }
 
-    // Draw a sub-path covering [startPct, endPct)
-    void drawTrackSubPath(float startPct, float endPct, const float4& col, float width,
-                          float minX, float minY, float scale, float offsetX, float offsetY,
-                          float left, float top)
+    // Build a pixel-space sub-path covering [startPct, endPct)
+    Microsoft::WRL::ComPtr<ID2D1PathGeometry> buildTrackSubPath(float startPct, float endPct)
     {
-        if (m_trackPath.size() < 2 || m_totalPathLength <= 0.0f) return;
+        Microsoft::WRL::ComPtr<ID2D1PathGeometry> segGeom;
+        if (m_trackPath.size() < 2 || m_totalPathLength <= 0.0f) return segGeom;
 
         const float startDist = startPct * m_totalPathLength;
         const float endDist   = endPct   * m_totalPathLength;
 
-        Microsoft::WRL::ComPtr<ID2D1PathGeometry> segGeom;
         Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
         if (FAILED(m_d2dFactory->CreatePathGeometry(&segGeom)) || FAILED(segGeom->Open(&sink)))
-            return;
+            return nullptr;
 
-        float acc = 0.0f;
         bool started = false;
-
-        auto toScreen = [&](const float2& p)->D2D1_POINT_2F {
-            const float sx = left + offsetX + (p.x - minX) * scale;
-            const float sy = top  + offsetY + (p.y - minY) * scale;
-            return D2D1::Point2F(sx, sy);
-        };
-
-        for (size_t i = 1; i < m_trackPath.size(); ++i) {
+        for (size_t i = pathSegmentAt(startDist); i > 0 && i < m_trackPath.size(); ++i) {
             const float2 A = m_trackPath[i-1];
             const float2 B = m_trackPath[i];
-            const float seg = distance(A, B);
+            const float segStart = m_pathCumLength[i-1];
+            const float seg = m_pathCumLength[i] - segStart;
             if (seg <= 0.0f) continue;
+            if (segStart >= endDist) break;
 
-            const float segStart = acc;
-            const float segEnd   = acc + seg;
-
-            if (segEnd > startDist && segStart < endDist) {
+            if (segStart + seg > startDist) {
                 // Clamp to [startDist, endDist]
                 const float t1 = std::max(0.0f, (startDist - segStart) / seg);
                 const float t2 = std::min(1.0f, (endDist   - segStart) / seg);
-                const float2 P1 = lerp(A, B, std::max(0.0f, t1));
-                const float2 P2 = lerp(A, B, std::min(1.0f, t2));
 
                 if (!started) {
-                    sink->BeginFigure(toScreen(P1), D2D1_FIGURE_BEGIN_HOLLOW);
+                    sink->BeginFigure(pathToScreen(lerp(A, B, t1)), D2D1_FIGURE_BEGIN_HOLLOW);
                     started = true;
                 }
                 if (t2 > t1) {
-                    sink->AddLine(toScreen(P2));
+                    sink->AddLine(pathToScreen(lerp(A, B, t2)));
                 }
             }
-
-            acc += seg;
-            if (acc >= endDist) break;
         }
 
-        if (started) {
-            sink->EndFigure(D2D1_FIGURE_END_OPEN);
-            sink->Close();
-            m_brush->SetColor(col);
-            m_renderTarget->DrawGeometry(segGeom.Get(), m_brush.Get(), width);
-        }
+        if (!started)
+            return nullptr;
+        sink->EndFigure(D2D1_FIGURE_END_OPEN);
+        if (FAILED(sink->Close()))
+            return nullptr;
+        return segGeom;
     }
 
+    // Sector colors for our own car, from the field-wide sector timing in the shared race state.
+    // Adjusted sectors are the raw ones rotated/mirrored for the map, so map each back by its midpoint.
     void updateSectorTiming()
     {
-        if (m_sectorStartsAdjusted.size() < 2) return;
+        const int nSectors = (int)m_sectorStartsAdjusted.size() - 1;
+        if (nSectors < 1) return;
 
-        const double now = ir_now();
+        const SectorTiming& st = ir_race.sectors;
         const int selfIdx = ir_session.driverCarIdx;
-
-        // Replay scrubbing/seek can make time jump backwards. Reset timing state so we
-        // don't produce negative sector times or get stuck.
-        if (m_lastTimingNow >= 0.0 && now + 0.001 < m_lastTimingNow)
+        for (int s = 0; s < nSectors && s < (int)m_sectorColors.size(); ++s)
         {
-            resetSectorTiming();
-            return;
+            const int raw = rawSectorAt(0.5f * (m_sectorStartsAdjusted[s] + m_sectorStartsAdjusted[s+1]));
+            float4 col = float4(0,0,0,0);
+            if (raw >= 0 && raw < st.numSectors() && selfIdx >= 0)
+                col = SectorTiming::stateColor(st.state(selfIdx, raw), col);
+            m_sectorColors[s] = col;
         }
-        m_lastTimingNow = now;
-
-        // Initialize per-car state once
-        if (!m_perCarInitialized) {
-            for (int i = 0; i < IR_MAX_CARS; ++i) {
-                float raw = ir_CarIdxLapDistPct.getFloat(i);
-                if (raw < 0.0f) { m_prevPctPerCar[i] = -1.0f; continue; }
-                m_prevPctPerCar[i] = adjustPctForOverlay(raw);
-                m_lastBoundaryTimePerCar[i] = -1.0;
-            }
-            m_perCarInitialized = true;
-            return;
-        }
-
-        auto isValidCar = [&](int i)->bool {
-            if (i < 0 || i >= IR_MAX_CARS) return false;
-            if (ir_session.cars[i].userName.empty()) return false;
-            if (ir_session.cars[i].isSpectator) return false;
-            return true;
-        };
-
-        const float4 purple = float4(0.70f, 0.30f, 1.00f, 0.9f);
-        const float4 green  = float4(0.20f, 0.85f, 0.25f, 0.9f);
-        const float4 yellow = float4(1.00f, 0.85f, 0.00f, 0.9f);
-
-        const int nBounds = (int)m_sectorStartsAdjusted.size();
-        for (int i = 0; i < IR_MAX_CARS; ++i) {
-            float raw = ir_CarIdxLapDistPct.getFloat(i);
-            if (raw < 0.0f) continue;
-
-            float cur = adjustPctForOverlay(raw);
-            float prev = m_prevPctPerCar[i];
-
-            // Optional gating for self to avoid flicker when stationary/pitting
-            if (i == selfIdx) {
-                bool inPitStall = ir_PlayerCarInPitStall.getBool();
-                bool onPitRoad  = ir_OnPitRoad.getBool();
-                float speedMs   = ir_Speed.getFloat();
-
-                // If we just entered pit stall, treat next run as a fresh outlap
-                if (inPitStall && !m_wasInPitStallSelf) {
-                    m_hasCrossedSFPerCar[selfIdx] = false;
-                    m_lastBoundaryTimePerCar[selfIdx] = -1.0;
-                    ensureSectorArraysSized();
-                    for (size_t si = 0; si < m_sectorColors.size(); ++si) m_sectorColors[si] = float4(0,0,0,0);
-                }
-                m_wasInPitStallSelf = inPitStall;
-
-                if (inPitStall || onPitRoad || speedMs < 0.5f) {
-                    m_prevPctPerCar[i] = cur;
-                    continue;
-                }
-            }
-
-            // Determine which boundaries were crossed between prev and cur
-            int idxPrev = (prev < 0.0f) ? boundaryIndexAt(cur) : boundaryIndexAt(prev);
-            int idxCur  = boundaryIndexAt(cur);
-
-            // Start processing from the next boundary after prev
-            int idx = (idxPrev + 1) % nBounds;
-            bool wrapped = prev > cur; // wrapped around 1.0 -> 0.0
-
-            // helper lambda to test if boundary idx lies between prev and cur on unit circle
-            auto boundaryInRange = [&](int bIdx)->bool {
-                float b = m_sectorStartsAdjusted[bIdx];
-                if (!wrapped) return prev < b && b <= cur;
-                return (b > prev) || (b <= cur);
-            };
-
-            for (int processed = 0; processed < nBounds; ++processed) {
-                if (boundaryInRange(idx)) {
-                    // We crossed boundary idx
-                    int s = idx - 1; if (s < 0) s = nBounds - 2;
-
-                    if (m_lastBoundaryTimePerCar[i] >= 0.0) {
-                        float sectorTime = float(now - m_lastBoundaryTimePerCar[i]);
-                        const float kMinValidSectorTime = 0.05f;
-                        if (sectorTime > kMinValidSectorTime && sectorTime < 600.0f) {
-                            bool isValidSector = true;
-                            if (i == selfIdx && isValidCar(i)) {
-                                int incNow = ir_session.cars[i].incidentCount;
-                                isValidSector = (incNow <= m_lastIncidentCountPerCar[i]);
-                                m_lastIncidentCountPerCar[i] = incNow;
-                            }
-
-                            if (sectorTime < m_sectorBestSession[s])
-                                m_sectorBestSession[s] = sectorTime;
-
-                            if (i == selfIdx && isValidCar(i)) {
-                                const bool newPB = (sectorTime < m_sectorBestPersonal[s]);
-                                if (newPB) m_sectorBestPersonal[s] = sectorTime;
-
-                                if (m_hasCrossedSFPerCar[selfIdx]) {
-                                    if (isValidSector && sectorTime <= m_sectorBestSession[s] + 1e-4f) {
-                                        m_sectorColors[s] = purple;
-                                    } else if (isValidSector && newPB) {
-                                        m_sectorColors[s] = green;
-                                    } else {
-                                        m_sectorColors[s] = yellow;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    // Start timing next sector from now
-                    m_lastBoundaryTimePerCar[i] = now;
-
-                    // Clear color for the sector just entered (idx)
-                    if (i == selfIdx && isValidCar(i)) {
-                        int sNext = idx; if (sNext >= nBounds - 1) sNext = 0;
-                        if (sNext >= 0 && sNext < (int)m_sectorColors.size())
-                            m_sectorColors[sNext] = float4(0,0,0,0);
-                    }
-
-                    // Mark S/F crossed for self
-                    if (i == selfIdx && idx == 0) {
-                        m_hasCrossedSFPerCar[selfIdx] = true;
-                    }
-
-                }
+    }
 
-                if (idx == idxCur) break;
-                idx = (idx + 1) % nBounds;
-            }
+    // Inverse of adjustPctForOverlay, then the raw SplitTimeInfo sector containing that point
+    int rawSectorAt(float adjustedPct) const
+    {
+        float startOffset = g_cfg.getFloat(m_name, "start_offset_pct", 0.0f);
+        if (m_hasAutoOffset) startOffset += m_autoOffset;
+        float pct = adjustedPct - startOffset;
+        while (pct >= 1.0f) pct -= 1.0f;
+        while (pct < 0.0f) pct += 1.0f;
+        if (g_cfg.getBool(m_name, "reverse_direction", false))
+            pct = 1.0f - pct;
 
-            m_prevPctPerCar[i] = cur;
-        }
+        const std::vector<float>& bounds = ir_session.sectorStartPct;
+        int idx = -1;
+        for (int i = 0; i + 1 < (int)bounds.size(); ++i)
+            if (bounds[i] <= pct) idx = i;
+        return idx;
     }
 };
\ No newline at end of file
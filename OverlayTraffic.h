@@ -27,7 +27,9 @@ SOFTWARE.
 #include <algorithm>
 #include <string>
 #include "Overlay.h"
+#include "StyleBrushes.h"
 #include "iracing.h"
+#include "RaceState.h"
 #include "Config.h"
 #include "ClassColors.h"
 #include "stub_data.h"
@@ -124,7 +126,7 @@ protected:
         const float holdS = g_cfg.getFloat(m_name, "hold_seconds", 1.25f);
         if (found)
         {
-            // Lock onto the closest faster-class car behind. If target changes, it's fine.
+            // Lock onto the faster-class car that will reach us first. If target changes, it's fine.
             m_activeCarIdx = best.carIdx;
             m_active = best;
             m_showUntil = std::max(m_showUntil, now + std::max(0.05f, holdS));
@@ -189,6 +191,8 @@ protected:
             drawT.classId = 2;
             drawT.gapBehindS = 1.3f;
             drawT.distanceBehindM = 45.0f;
+            drawT.catchInS = 4.2f;
+            drawT.catchSector = 1;
             drawT.isUrgent = true;
         }
 
@@ -290,7 +294,7 @@ protected:
                 swprintf_s(line1, L"%s  #%S  %s", wClass.c_str(), drawT.carNumberStr.c_str(), wName.c_str());
             }
 
-            // Line 2: gap and distance
+            // Line 2: gap and distance, then the predicted catch
             {
                 const bool showMeters = g_cfg.getBool(m_name, "show_distance_m", true);
                 if (showMeters && drawT.distanceBehindM > 0.0f) {
@@ -298,6 +302,15 @@ protected:
                 } else {
                     swprintf_s(line2, L"Behind: %.1fs", std::max(0.0f, drawT.gapBehindS));
                 }
+
+                if (drawT.catchInS >= 0.0f && g_cfg.getBool(m_name, "show_catch", true))
+                {
+                    const size_t len = wcslen(line2);
+                    if (drawT.catchSector >= 0)
+                        swprintf_s(line2 + len, _countof(line2) - len, L"  catch %.0fs (S%d)", drawT.catchInS, drawT.catchSector + 1);
+                    else
+                        swprintf_s(line2 + len, _countof(line2) - len, L"  catch %.0fs", drawT.catchInS);
+                }
             }
 
             // Text colors (use base yellow color as subtle accent)
@@ -359,6 +372,8 @@ private:
         std::string userName;
         float gapBehindS = 0.0f;      // seconds (positive)
         float distanceBehindM = 0.0f; // meters (approx)
+        float catchInS = -1.0f;       // seconds until it reaches us at its current closing rate, -1 if unknown
+        int catchSector = -1;         // sector we'll be in by then (0-based), -1 if unknown
         bool isUrgent = false;
     };
 
@@ -376,6 +391,8 @@ private:
             out.userName = "Faster Class";
             out.gapBehindS = 1.3f;
             out.distanceBehindM = 45.0f;
+            out.catchInS = 4.2f;
+            out.catchSector = 1;
             out.isUrgent = true;
             return true;
         }
@@ -386,35 +403,46 @@ private:
         const bool hideIfSelfPit = g_cfg.getBool(m_name, "hide_if_self_on_pit_road", true);
         if (hideIfSelfPit && ir_OnPitRoad.getBool()) return false;
 
+        const RaceState& rs = ir_race;
         const float selfClassEst = ir_session.cars[selfIdx].carClassEstLapTime;
-        const int selfClassId = ir_getClassId(selfIdx);
+        const int selfClassId = rs.selfClassId;
 
         const float warnGapS = std::max(0.1f, g_cfg.getFloat(m_name, "warn_gap_seconds", 2.5f));
         const float urgentGapS = std::max(0.05f, g_cfg.getFloat(m_name, "urgent_gap_seconds", 1.2f));
         const float fasterMarginS = std::max(0.0f, g_cfg.getFloat(m_name, "faster_class_laptime_margin_s", 1.0f));
         const bool requireDifferentClass = g_cfg.getBool(m_name, "require_different_class", true);
         const bool ignoreCarsOnPitRoad = g_cfg.getBool(m_name, "ignore_cars_on_pit_road", true);
+        const float warnCatchS = std::max(0.0f, g_cfg.getFloat(m_name, "warn_catch_seconds", 8.0f));
+        const float urgentCatchS = std::max(0.0f, g_cfg.getFloat(m_name, "urgent_catch_seconds", 3.0f));
+        const bool ignoreNotClosing = g_cfg.getBool(m_name, "ignore_not_closing", true);
+        const float minClosingRate = g_cfg.getFloat(m_name, "min_closing_rate", 0.02f);
 
         const float trackLenM = ir_session.trackLengthMeters;
-        const float selfPct = std::clamp(ir_LapDistPct.getFloat(), 0.0f, 1.0f);
-        const float selfEst = ir_CarIdxEstTime.getFloat(selfIdx);
+        const float selfEst = rs.estTime[selfIdx];
+
+        // Same lap time reference as OverlayRelative, used for wrap correction and distance conversion.
+        const float lapTimeRef = rs.refLapTime;
 
-        // Use an estimate of *our* lap time (same reference as OverlayRelative) to normalize wrap correction and distance conversion.
-        float lapTimeRef = selfClassEst;
-        if (lapTimeRef <= 0.1f) lapTimeRef = ir_estimateLaptime();
-        if (lapTimeRef <= 0.1f) lapTimeRef = 120.0f;
+        float bestEta = 1e9f;
 
-        float bestGap = 1e9f;
+        // Only cars within reach of the warning gap, or close enough to arrive within the catch
+        // warning at any plausible closing rate (0.2s/s), can qualify. Walk the shared track-order
+        // index backwards from us over that stretch (with some slack, since gaps below are measured
+        // in time) instead of scanning the whole field.
+        int candidates[IR_MAX_CARS];
+        const float reachS = std::max(warnGapS, warnCatchS * 0.2f);
+        const float windowPct = lapTimeRef > 0.1f ? std::min(0.5f, 1.5f * reachS / lapTimeRef) : 0.5f;
+        const int numCandidates = rs.order.nearestBehind(selfIdx, IR_MAX_CARS, windowPct, candidates);
 
-        for (int i = 0; i < IR_MAX_CARS; ++i)
+        for (int c = 0; c < numCandidates; ++c)
         {
-            if (i == selfIdx) continue;
+            const int i = candidates[c];
             const Car& car = ir_session.cars[i];
             if (car.isSpectator || car.carNumber < 0) continue;
             if (car.isPaceCar) continue;
-            if (ignoreCarsOnPitRoad && ir_CarIdxOnPitRoad.getBool(i)) continue;
+            if (ignoreCarsOnPitRoad && rs.onPitRoad[i]) continue;
 
-            const int otherClassId = ir_getClassId(i);
+            const int otherClassId = rs.classId[i];
             if (requireDifferentClass && otherClassId == selfClassId) continue;
 
             const float otherClassEst = car.carClassEstLapTime;
@@ -430,31 +458,31 @@ private:
                 continue;
             }
 
-            const float otherPct = ir_CarIdxLapDistPct.getFloat(i);
-            // Match OverlayRelative: normalize other car's EstTime into *our* class-time domain before comparing.
-            const float classRatio = (selfClassEst > 0.1f) ? (otherClassEst / selfClassEst) : 1.0f;
-            if (classRatio <= 0.01f) continue;
-            const float otherEstNorm = ir_CarIdxEstTime.getFloat(i) / classRatio;
-            if (otherPct < 0.0f || otherEstNorm <= 0.0f || selfEst <= 0.0f) continue;
-
-            // Delta in seconds, wrap-safe. Positive means other ahead, negative means other behind.
-            // (After normalization, this matches the sign behavior used by OverlayRelative.)
-            float delta = otherEstNorm - selfEst;
-            const bool wrap = fabsf(otherPct - selfPct) > 0.5f;
-            if (wrap)
-            {
-                // If we're "ahead" in lap pct, and the other is just after S/F, the other is behind.
-                delta = (selfPct > otherPct) ? (delta + lapTimeRef) : (delta - lapTimeRef);
-            }
+            if (rs.lapDistPct[i] < 0.0f || rs.estTime[i] <= 0.0f || selfEst <= 0.0f) continue;
+
+            // Class-normalized, wrap-safe delta shared with OverlayRelative. Positive means other ahead, negative means other behind.
+            const float delta = rs.relTime[i];
 
             if (delta >= 0.0f) continue; // only behind
 
             const float gapBehindS = -delta;
-            if (gapBehindS <= 0.0f || gapBehindS > warnGapS) continue;
-
-            if (gapBehindS < bestGap)
+            if (gapBehindS <= 0.0f) continue;
+
+            // Closing-rate model: skip cars that are holding station or dropping back, and warn
+            // early about cars that will be on us soon even if they're still outside the gap.
+            const bool knownRate = rs.closing.hasRate(i);
+            const float rate = rs.closing.closingRate(i);
+            const float catchInS = rs.closing.timeToCatch(i, gapBehindS);
+            if (ignoreNotClosing && knownRate && rate < minClosingRate) continue;
+            const bool arrivingSoon = catchInS >= 0.0f && catchInS <= warnCatchS;
+            if (gapBehindS > warnGapS && !arrivingSoon) continue;
+
+            // Rank by expected arrival. Cars without a rate yet fall back to the plain gap, behind
+            // any that are known to be closing.
+            const float eta = catchInS >= 0.0f ? catchInS : 1e6f + gapBehindS;
+            if (eta < bestEta)
             {
-                bestGap = gapBehindS;
+                bestEta = eta;
                 out.carIdx = i;
                 out.classId = otherClassId;
                 out.classShort = car.carClassShortName;
@@ -462,7 +490,15 @@ private:
                 out.userName = car.userName;
                 out.gapBehindS = gapBehindS;
                 out.distanceBehindM = (trackLenM > 1.0f) ? (trackLenM * (gapBehindS / lapTimeRef)) : 0.0f;
-                out.isUrgent = gapBehindS <= urgentGapS;
+                out.catchInS = catchInS;
+                out.catchSector = -1;
+                if (catchInS >= 0.0f && rs.sectors.numSectors() > 1 && rs.lapDistPct[selfIdx] >= 0.0f)
+                {
+                    float catchPct = rs.lapDistPct[selfIdx] + catchInS / lapTimeRef;
+                    catchPct -= floorf(catchPct);
+                    out.catchSector = rs.sectors.sectorAt(catchPct);
+                }
+                out.isUrgent = gapBehindS <= urgentGapS || (catchInS >= 0.0f && catchInS <= urgentCatchS);
             }
         }
 
@@ -474,51 +510,8 @@ private:
         if (!m_renderTarget) return;
         if (m_bgBrush && m_panelBrush) return;
 
-        // Card background gradient (same palette as OverlayPit/OverlayFlags/OverlayFuel)
-        {
-            D2D1_GRADIENT_STOP stops[3] = {};
-            stops[0].position = 0.0f;  stops[0].color = D2D1::ColorF(0.16f, 0.18f, 0.22f, 0.95f);
-            stops[1].position = 0.45f; stops[1].color = D2D1::ColorF(0.06f, 0.07f, 0.09f, 0.95f);
-            stops[2].position = 1.0f;  stops[2].color = D2D1::ColorF(0.02f, 0.02f, 0.03f, 0.95f);
-
-            Microsoft::WRL::ComPtr<ID2D1GradientStopCollection> stopCollection;
-            HRESULT hr = m_renderTarget->CreateGradientStopCollection(
-                stops,
-                ARRAYSIZE(stops),
-                D2D1_GAMMA_2_2,
-                D2D1_EXTEND_MODE_CLAMP,
-                stopCollection.GetAddressOf()
-            );
-            if (SUCCEEDED(hr)) {
-                D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES props = {};
-                props.startPoint = D2D1_POINT_2F{ 0,0 };
-                props.endPoint = D2D1_POINT_2F{ 0,1 };
-                m_renderTarget->CreateLinearGradientBrush(props, stopCollection.Get(), m_bgBrush.GetAddressOf());
-            }
-        }
-
-        // Inner panel gradient (same palette as OverlayPit/OverlayFlags/OverlayFuel)
-        {
-            D2D1_GRADIENT_STOP stops[3] = {};
-            stops[0].position = 0.0f;  stops[0].color = D2D1::ColorF(0.08f, 0.09f, 0.11f, 0.92f);
-            stops[1].position = 0.55f; stops[1].color = D2D1::ColorF(0.04f, 0.045f, 0.055f, 0.92f);
-            stops[2].position = 1.0f;  stops[2].color = D2D1::ColorF(0.02f, 0.02f, 0.03f, 0.92f);
-
-            Microsoft::WRL::ComPtr<ID2D1GradientStopCollection> stopCollection;
-            HRESULT hr = m_renderTarget->CreateGradientStopCollection(
-                stops,
-                ARRAYSIZE(stops),
-                D2D1_GAMMA_2_2,
-                D2D1_EXTEND_MODE_CLAMP,
-                stopCollection.GetAddressOf()
-            );
-            if (SUCCEEDED(hr)) {
-                D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES props = {};
-                props.startPoint = D2D1_POINT_2F{ 0,0 };
-                props.endPoint = D2D1_POINT_2F{ 0,1 };
-                m_renderTarget->CreateLinearGradientBrush(props, stopCollection.Get(), m_panelBrush.GetAddressOf());
-            }
-        }
+        StyleBrushes::createLinearGradient(m_renderTarget.Get(), StyleBrushes::card(), m_bgBrush.ReleaseAndGetAddressOf());
+        StyleBrushes::createLinearGradient(m_renderTarget.Get(), StyleBrushes::panel(), m_panelBrush.ReleaseAndGetAddressOf());
     }
 
 private:
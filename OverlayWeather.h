@@ -32,6 +32,8 @@ SOFTWARE.
 #include <wincodec.h>
 #include <cmath>
 #include "Overlay.h"
+#include "StyleBrushes.h"
+#include "ImageAssets.h"
 #include "iracing.h"
 #include "Units.h"
 #include "Config.h"
@@ -79,9 +81,6 @@ class OverlayWeather : public Overlay
 
         virtual void onEnable()
         {
-            (void)CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-            HRCHECK(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&m_wicFactory)));
-            
             onConfigChanged();
             loadIcons();
 
@@ -94,7 +93,6 @@ class OverlayWeather : public Overlay
         {
             m_text.reset();
             releaseIcons();
-            m_wicFactory.Reset();
             m_bgBrush.Reset();
             m_panelBrush.Reset();
         }
@@ -129,9 +127,7 @@ class OverlayWeather : public Overlay
             setupWeatherBoxes();
             
             // Load icons after render target is set up
-            if (m_wicFactory.Get()) {
-                loadIcons();
-            }
+            loadIcons();
 
             // Invalidate static text cache on layout changes
             m_staticTextBitmap.Reset();
@@ -139,6 +135,20 @@ class OverlayWeather : public Overlay
             // Per-overlay FPS (configurable; default 10)
             setTargetFPS(g_cfg.getInt(m_name, "target_fps", 10));
 
+            // Everything the card shows; weather rarely changes, so most ticks skip drawing entirely
+            clearRedrawDependencies();
+            addRedrawDependency(ir_TrackTempCrew, 0.05);
+            addRedrawDependency(ir_AirTemp, 0.05);
+            addRedrawDependency(ir_TrackWetness);
+            addRedrawDependency(ir_Precipitation, 0.005);
+            addRedrawDependency(ir_WindVel, 0.05);
+            addRedrawDependency(ir_WindDir, 0.01);
+            addRedrawDependency(ir_YawNorth, 0.01);
+            addRedrawDependency(ir_DisplayUnits);
+            addRedrawConfigKey("text_col");
+            addRedrawConfigKey("background_col");
+            addRedrawConfigKey("opacity");
+
             // Recreate D2D brushes (render target may change)
             m_bgBrush.Reset();
             m_panelBrush.Reset();
@@ -256,7 +266,7 @@ class OverlayWeather : public Overlay
 
                 // Icon on the left side of temperature value
                 const float iconX = m_trackTempBox.x0 + valuePadding;
-                drawIcon(m_trackTempIcon.Get(), iconX, tempValueY - iconAdjustment, iconSize, iconSize, true);
+                drawIcon(m_trackTempIcon.Get(m_renderTarget.Get()), iconX, tempValueY - iconAdjustment, iconSize, iconSize, true);
 
                 // Adjust text position to be after the icon
                 const float textOffset = iconX + iconSize + valuePadding;
@@ -299,10 +309,10 @@ class OverlayWeather : public Overlay
                     const float barY = m_trackWetnessBox.y0 + m_trackWetnessBox.h * 0.6f;
                     
                     // Sun icon aligned with left title padding
-                    drawIcon(m_sunIcon.Get(), m_trackWetnessBox.x0 + titlePadding, barY - sideIconAdjust, sideIconSize, sideIconSize, true);
+                    drawIcon(m_sunIcon.Get(m_renderTarget.Get()), m_trackWetnessBox.x0 + titlePadding, barY - sideIconAdjust, sideIconSize, sideIconSize, true);
                     
                     // Waterdrop icon aligned with right title padding
-                    drawIcon(m_trackWetnessIcon.Get(), m_trackWetnessBox.x1 - titlePadding - sideIconSize, barY - sideIconAdjust, sideIconSize, sideIconSize, true);
+                    drawIcon(m_trackWetnessIcon.Get(m_renderTarget.Get()), m_trackWetnessBox.x1 - titlePadding - sideIconSize, barY - sideIconAdjust, sideIconSize, sideIconSize, true);
                     
                     // Background bar with white outline
                     D2D1_RECT_F barBg = { barX, barY, barX + barWidth, barY + barHeight };
@@ -347,7 +357,7 @@ class OverlayWeather : public Overlay
                     float precipitation = useStubData ? StubDataManager::getStubPrecipitation() : getPrecipitationValue();
 
                     // Icon on the left
-                    drawIcon(m_precipitationIcon.Get(), iconX, valueY - iconAdjustment, iconSize, iconSize, true);
+                    drawIcon(m_precipitationIcon.Get(m_renderTarget.Get()), iconX, valueY - iconAdjustment, iconSize, iconSize, true);
 
                     // Percentage value - larger, to the right of the icon
                     m_brush->SetColor( precipCol );
@@ -363,7 +373,7 @@ class OverlayWeather : public Overlay
                     }
 
                     // Use air temp icon
-                    drawIcon(m_trackTempIcon.Get(), iconX, valueY - iconAdjustment, iconSize, iconSize, true);
+                    drawIcon(m_trackTempIcon.Get(m_renderTarget.Get()), iconX, valueY - iconAdjustment, iconSize, iconSize, true);
 
                     // Temperature value - larger, to the right of the icon
                     m_brush->SetColor( precipCol );
@@ -418,7 +428,7 @@ class OverlayWeather : public Overlay
                 // Wind icon aligned to the left like title
                 const float windIconSize = 50 * m_scaleFactor;
                 const float windIconAdjust = 25 * m_scaleFactor;
-                drawIcon(m_windIcon.Get(), m_windBox.x0 + titlePadding, windSpeedY - windIconAdjust, windIconSize, windIconSize, true);
+                drawIcon(m_windIcon.Get(m_renderTarget.Get()), m_windBox.x0 + titlePadding, windSpeedY - windIconAdjust, windIconSize, windIconSize, true);
                 
                 // Wind speed text left-aligned like title
                 const float windTextOffset = 75.0f * m_scaleFactor;
@@ -437,51 +447,8 @@ class OverlayWeather : public Overlay
             if (!m_renderTarget) return;
             if (m_bgBrush && m_panelBrush) return;
 
-            // Card background gradient (same palette as OverlayPit/OverlayFlags)
-            {
-                D2D1_GRADIENT_STOP stops[3] = {};
-                stops[0].position = 0.0f;  stops[0].color = D2D1::ColorF(0.16f, 0.18f, 0.22f, 1.0f);
-                stops[1].position = 0.45f; stops[1].color = D2D1::ColorF(0.06f, 0.07f, 0.09f, 1.0f);
-                stops[2].position = 1.0f;  stops[2].color = D2D1::ColorF(0.02f, 0.02f, 0.03f, 1.0f);
-
-                Microsoft::WRL::ComPtr<ID2D1GradientStopCollection> stopCollection;
-                HRESULT hr = m_renderTarget->CreateGradientStopCollection(
-                    stops,
-                    ARRAYSIZE(stops),
-                    D2D1_GAMMA_2_2,
-                    D2D1_EXTEND_MODE_CLAMP,
-                    stopCollection.GetAddressOf()
-                );
-                if (SUCCEEDED(hr)) {
-                    D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES props = {};
-                    props.startPoint = D2D1_POINT_2F{ 0,0 };
-                    props.endPoint = D2D1_POINT_2F{ 0,1 };
-                    m_renderTarget->CreateLinearGradientBrush(props, stopCollection.Get(), m_bgBrush.GetAddressOf());
-                }
-            }
-
-            // Inner panel gradient (same palette as OverlayPit/OverlayFlags)
-            {
-                D2D1_GRADIENT_STOP stops[3] = {};
-                stops[0].position = 0.0f;  stops[0].color = D2D1::ColorF(0.08f, 0.09f, 0.11f, 1.0f);
-                stops[1].position = 0.55f; stops[1].color = D2D1::ColorF(0.04f, 0.045f, 0.055f, 1.0f);
-                stops[2].position = 1.0f;  stops[2].color = D2D1::ColorF(0.02f, 0.02f, 0.03f, 1.0f);
-
-                Microsoft::WRL::ComPtr<ID2D1GradientStopCollection> stopCollection;
-                HRESULT hr = m_renderTarget->CreateGradientStopCollection(
-                    stops,
-                    ARRAYSIZE(stops),
-                    D2D1_GAMMA_2_2,
-                    D2D1_EXTEND_MODE_CLAMP,
-                    stopCollection.GetAddressOf()
-                );
-                if (SUCCEEDED(hr)) {
-                    D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES props = {};
-                    props.startPoint = D2D1_POINT_2F{ 0,0 };
-                    props.endPoint = D2D1_POINT_2F{ 0,1 };
-                    m_renderTarget->CreateLinearGradientBrush(props, stopCollection.Get(), m_panelBrush.GetAddressOf());
-                }
-            }
+            StyleBrushes::createLinearGradient(m_renderTarget.Get(), StyleBrushes::card(1.0f), m_bgBrush.ReleaseAndGetAddressOf());
+            StyleBrushes::createLinearGradient(m_renderTarget.Get(), StyleBrushes::panel(1.0f), m_panelBrush.ReleaseAndGetAddressOf());
         }
 
         void setupWeatherBoxes()
@@ -532,78 +499,17 @@ class OverlayWeather : public Overlay
             return box;
         }
 
-        // Helpers for robust asset path resolution
-        static bool ow_fileExistsW(const std::wstring& path)
-        {
-            DWORD a = GetFileAttributesW(path.c_str());
-            return a != INVALID_FILE_ATTRIBUTES && (a & FILE_ATTRIBUTE_DIRECTORY) == 0;
-        }
-
-        static std::wstring ow_getExecutableDirW()
-        {
-            wchar_t path[MAX_PATH] = {0};
-            GetModuleFileNameW(NULL, path, MAX_PATH);
-            wchar_t* last = wcsrchr(path, L'\\');
-            if (last) *last = 0;
-            return std::wstring(path);
-        }
-
-        static std::wstring ow_resolveAssetPath(const std::wstring& relative)
-        {
-            const std::wstring exeDir = ow_getExecutableDirW();
-            // Candidate 1: repo root two levels up from exe dir (mirrors GUI HTML loader)
-            std::wstring candidateRepo = exeDir + L"\\..\\..\\" + relative;
-            if (ow_fileExistsW(candidateRepo)) return candidateRepo;
-            // Candidate 2: next to the executable
-            std::wstring candidateLocal = exeDir + L"\\" + relative;
-            if (ow_fileExistsW(candidateLocal)) return candidateLocal;
-            // Fallback: provided relative path
-            return relative;
-        }
-
         void loadIcons()
         {
-            if (!m_wicFactory.Get() || !m_renderTarget.Get()) return;
-
-            // Helper function to load a single PNG file
-            auto loadPngIcon = [&](const std::wstring& filePath) -> Microsoft::WRL::ComPtr<ID2D1Bitmap> {
-                Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
-                
-                try {
-                    Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
-                    HRESULT hr = m_wicFactory->CreateDecoderFromFilename(filePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder);
-                    if (FAILED(hr)) return bitmap;
-
-                    Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
-                    hr = decoder->GetFrame(0, &frame);
-                    if (FAILED(hr)) return bitmap;
-
-                    Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
-                    hr = m_wicFactory->CreateFormatConverter(&converter);
-                    if (FAILED(hr)) return bitmap;
-
-                    hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut);
-                    if (FAILED(hr)) return bitmap;
-
-                    hr = m_renderTarget->CreateBitmapFromWicBitmap(converter.Get(), nullptr, &bitmap);
-                    if (FAILED(hr)) return bitmap;
-
-                } catch (...) {
-                    // Return null bitmap on any exception
-                    return bitmap;
-                }
-                
-                return bitmap;
-            };
-
-            // Load all weather icons using resolved absolute paths
-            m_trackTempIcon     = loadPngIcon(ow_resolveAssetPath(L"assets\\icons\\track_temp.png"));
-            m_trackWetnessIcon  = loadPngIcon(ow_resolveAssetPath(L"assets\\icons\\waterdrop.png"));
-            m_sunIcon           = loadPngIcon(ow_resolveAssetPath(L"assets\\icons\\sun.png"));
-            m_precipitationIcon = loadPngIcon(ow_resolveAssetPath(L"assets\\icons\\precipitation.png"));
-            m_windIcon          = loadPngIcon(ow_resolveAssetPath(L"assets\\icons\\wind.png"));
-            m_carIcon           = loadPngIcon(ow_resolveAssetPath(L"assets\\sports_car.png"));
-            m_windArrowIcon     = loadPngIcon(ow_resolveAssetPath(L"assets\\wind_arrow.png"));
+            // Decoded once and shared with other overlays; may still be loading in the background
+            ImageAssets& assets = ImageAssets::instance();
+            m_trackTempIcon     = assets.acquire(L"assets\\icons\\track_temp.png");
+            m_trackWetnessIcon  = assets.acquire(L"assets\\icons\\waterdrop.png");
+            m_sunIcon           = assets.acquire(L"assets\\icons\\sun.png");
+            m_precipitationIcon = assets.acquire(L"assets\\icons\\precipitation.png");
+            m_windIcon          = assets.acquire(L"assets\\icons\\wind.png");
+            m_carIcon           = assets.acquire(L"assets\\sports_car.png");
+            m_windArrowIcon     = assets.acquire(L"assets\\wind_arrow.png");
         }
 
         void releaseIcons()
@@ -715,7 +621,7 @@ class OverlayWeather : public Overlay
             // Draw car in EXACT center (always pointing north) - perfectly centered
             const float carX = centerX - carSize * 0.5f;
             const float carY = centerY - carSize * 0.5f;
-            drawIcon(m_carIcon.Get(), carX, carY, carSize, carSize, true);
+            drawIcon(m_carIcon.Get(m_renderTarget.Get()), carX, carY, carSize, carSize, true);
 
             const float arrowStartRadius = radius;
             const float arrowEndRadius = radius * 0.25f;
@@ -737,7 +643,7 @@ class OverlayWeather : public Overlay
             m_renderTarget->SetTransform(oldTx * D2D1::Matrix3x2F::Rotation(angleDeg, D2D1::Point2F(midX, midY)));
 
             m_renderTarget->DrawBitmap(
-                m_windArrowIcon.Get(),
+                m_windArrowIcon.Get(m_renderTarget.Get()),
                 D2D1::RectF(midX - arrowWidth*0.5f, midY - arrowLength*0.5f, midX + arrowWidth*0.5f, midY + arrowLength*0.5f),
                 0.75f // Opacity
             );
@@ -809,15 +715,14 @@ class OverlayWeather : public Overlay
         Microsoft::WRL::ComPtr<IDWriteTextFormat>  m_textFormatSmall;
         Microsoft::WRL::ComPtr<IDWriteTextFormat>  m_textFormatLarge;
 
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_trackTempIcon;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_trackWetnessIcon;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_sunIcon;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_precipitationIcon;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_windIcon;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_carIcon;
-        Microsoft::WRL::ComPtr<ID2D1Bitmap> m_windArrowIcon;
+        ImageAssets::Ref m_trackTempIcon;
+        ImageAssets::Ref m_trackWetnessIcon;
+        ImageAssets::Ref m_sunIcon;
+        ImageAssets::Ref m_precipitationIcon;
+        ImageAssets::Ref m_windIcon;
+        ImageAssets::Ref m_carIcon;
+        ImageAssets::Ref m_windArrowIcon;
 
-        Microsoft::WRL::ComPtr<IWICImagingFactory> m_wicFactory;
         TextCache m_text;
         float m_fontSpacing = getGlobalFontSpacing();
 
@@ -0,0 +1,152 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Profiler.h"
+#include <windows.h>
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+
+bool Profiler::s_enabled = false;
+
+Profiler& Profiler::instance()
+{
+    static Profiler s_instance;
+    return s_instance;
+}
+
+Profiler::Profiler()
+{
+    LARGE_INTEGER f;
+    QueryPerformanceFrequency( &f );
+    m_usPerTick = 1000000.0 / (double)f.QuadPart;
+}
+
+uint64_t Profiler::now()
+{
+    LARGE_INTEGER t;
+    QueryPerformanceCounter( &t );
+    return (uint64_t)t.QuadPart;
+}
+
+void Profiler::setEnabled( bool on )
+{
+    if( on && !s_enabled )
+        reset();
+    s_enabled = on;
+}
+
+Profiler::Zone* Profiler::zone( const std::string& name )
+{
+    for( auto& z : m_zones )
+        if( z->name == name )
+            return z.get();
+    m_zones.push_back( std::make_unique<Zone>() );
+    m_zones.back()->name = name;
+    return m_zones.back().get();
+}
+
+void Profiler::record( Zone* z, uint64_t startTicks, uint64_t endTicks )
+{
+    // Rotate the rolling window
+    const uint64_t windowTicks = (uint64_t)(ProfileWindowMs * 1000.0 / m_usPerTick);
+    if( endTicks - z->windowStart > windowTicks )
+    {
+        z->cur ^= 1;
+        z->win[z->cur] = Zone::Window();
+        z->windowStart = endTicks;
+    }
+
+    const float us = (float)((endTicks - startTicks) * m_usPerTick);
+    const int bucket = std::clamp( (int)(std::log2(1.0f + us) * 8.0f), 0, Buckets-1 );
+
+    Zone::Window& w = z->win[z->cur];
+    w.hist[bucket]++;
+    w.count++;
+    w.sumUs += us;
+    w.maxUs = std::max( w.maxUs, us );
+}
+
+void Profiler::snapshot( std::vector<Stats>& out ) const
+{
+    out.clear();
+    for( const auto& zp : m_zones )
+    {
+        const Zone& z = *zp;
+        const uint32_t count = z.win[0].count + z.win[1].count;
+        if( !count )
+            continue;
+
+        // Upper edge of the bucket holding the given rank
+        auto percentile = [&]( float p ) -> float {
+            const uint32_t rank = std::max( 1u, (uint32_t)std::ceil(p * count) );
+            uint32_t acc = 0;
+            for( int b=0; b<Buckets; ++b )
+            {
+                acc += z.win[0].hist[b] + z.win[1].hist[b];
+                if( acc >= rank )
+                    return (std::exp2((b + 1) / 8.0f) - 1.0f) / 1000.0f;
+            }
+            return 0.0f;
+        };
+
+        Stats s;
+        s.name   = z.name;
+        s.count  = count;
+        s.meanMs = (float)((z.win[0].sumUs + z.win[1].sumUs) / count / 1000.0);
+        s.maxMs  = std::max( z.win[0].maxUs, z.win[1].maxUs ) / 1000.0f;
+        s.p50Ms  = std::min( percentile(0.50f), s.maxMs );
+        s.p95Ms  = std::min( percentile(0.95f), s.maxMs );
+        s.p99Ms  = std::min( percentile(0.99f), s.maxMs );
+        out.push_back( s );
+    }
+}
+
+bool Profiler::exportCsv( const std::string& path ) const
+{
+    std::vector<Stats> stats;
+    snapshot( stats );
+
+    FILE* fp = fopen( path.c_str(), "wb" );
+    if( !fp )
+        return false;
+
+    fprintf( fp, "zone,count,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n" );
+    for( const Stats& s : stats )
+        fprintf( fp, "%s,%u,%.4f,%.4f,%.4f,%.4f,%.4f\n", s.name.c_str(), s.count, s.meanMs, s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs );
+    fclose( fp );
+    return true;
+}
+
+void Profiler::reset()
+{
+    const uint64_t t = now();
+    for( auto& z : m_zones )
+    {
+        z->win[0] = Zone::Window();
+        z->win[1] = Zone::Window();
+        z->cur = 0;
+        z->windowStart = t;
+    }
+}
@@ -0,0 +1,137 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include "Tracer.h"
+
+// Always-compiled frame-time profiler.
+// Named zones keep a log-scale histogram of their durations over a rolling window (two alternating
+// buckets of ProfileWindowMs each), from which p50/p95/p99 are read. Zones are only touched from the
+// main thread. When disabled, a ProfileScope costs one load and a branch.
+// While the Tracer is on, every ProfileScope also lands in the trace under its zone name.
+
+class Profiler
+{
+    public:
+
+        static constexpr int        Buckets = 160;          // 8 per octave, 1us .. ~1s
+        static constexpr unsigned   ProfileWindowMs = 5000;
+
+        struct Zone
+        {
+            std::string name;
+            struct Window
+            {
+                uint32_t    hist[Buckets] = {};
+                uint32_t    count = 0;
+                double      sumUs = 0;
+                float       maxUs = 0;
+            };
+            Window      win[2];
+            int         cur = 0;
+            uint64_t    windowStart = 0;    // QPC ticks
+        };
+
+        struct Stats
+        {
+            std::string name;
+            uint32_t    count = 0;
+            float       meanMs = 0;
+            float       p50Ms = 0;
+            float       p95Ms = 0;
+            float       p99Ms = 0;
+            float       maxMs = 0;
+        };
+
+        static Profiler&    instance();
+        static bool         enabled() { return s_enabled; }
+
+        void                setEnabled( bool on );
+
+        // Returns a stable zone for this name, creating it on first use.
+        Zone*               zone( const std::string& name );
+
+        void                record( Zone* z, uint64_t startTicks, uint64_t endTicks );
+
+        // Zones with samples in the current window, in creation order
+        void                snapshot( std::vector<Stats>& out ) const;
+        bool                exportCsv( const std::string& path ) const;
+        void                reset();
+
+        static uint64_t     now();
+
+    private:
+
+        Profiler();
+
+        static bool                         s_enabled;
+        double                              m_usPerTick = 0;
+        std::vector<std::unique_ptr<Zone>>  m_zones;
+};
+
+class ProfileScope
+{
+    public:
+
+        explicit ProfileScope( Profiler::Zone* z )
+        {
+            if( z && (Profiler::enabled() || Tracer::enabled()) )
+            {
+                m_zone = z;
+                m_start = Profiler::now();
+            }
+        }
+
+        ~ProfileScope()
+        {
+            if( !m_zone )
+                return;
+            const uint64_t end = Profiler::now();
+            if( Profiler::enabled() )
+                Profiler::instance().record( m_zone, m_start, end );
+            if( Tracer::enabled() )
+                Tracer::record( m_zone->name.c_str(), m_start, end );
+        }
+
+        ProfileScope( const ProfileScope& ) = delete;
+        ProfileScope& operator=( const ProfileScope& ) = delete;
+
+    private:
+
+        Profiler::Zone* m_zone = nullptr;
+        uint64_t        m_start = 0;
+};
+
+#define IFL03_PROFILE_CONCAT2(a,b) a##b
+#define IFL03_PROFILE_CONCAT(a,b) IFL03_PROFILE_CONCAT2(a,b)
+
+// Times the rest of the enclosing block under a fixed zone name.
+#define PROFILE_SCOPE( name ) \
+    static Profiler::Zone* IFL03_PROFILE_CONCAT(s_profZone,__LINE__) = Profiler::instance().zone( name ); \
+    ProfileScope IFL03_PROFILE_CONCAT(profScope,__LINE__)( IFL03_PROFILE_CONCAT(s_profZone,__LINE__) )
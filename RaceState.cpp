@@ -0,0 +1,230 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "RaceState.h"
+#include "Profiler.h"
+#include <math.h>
+#include <algorithm>
+
+RaceState ir_race;
+
+namespace
+{
+    constexpr int MaxClasses = 16;
+
+    // Scratch for the class-position -> carIdx lookup, reused every tick
+    int s_classIds[MaxClasses];
+    int s_carAtClassPos[MaxClasses][IR_MAX_CARS+1];
+
+    int classSlot( int classId, int& numClasses )
+    {
+        for( int c=0; c<numClasses; ++c )
+            if( s_classIds[c] == classId )
+                return c;
+        if( numClasses >= MaxClasses )
+            return -1;
+        s_classIds[numClasses] = classId;
+        std::fill( s_carAtClassPos[numClasses], s_carAtClassPos[numClasses]+IR_MAX_CARS+1, -1 );
+        return numClasses++;
+    }
+}
+
+bool RaceState::update()
+{
+    if( !ir_hasValidDriver() )
+    {
+        // Don't leave the last session's cars around for anyone who forgets to check `valid`.
+        // (Copied from a static: the history and timing members are too big for a stack temporary.)
+        static const RaceSnapshot s_empty{};
+        if( valid )
+        {
+            static_cast<RaceSnapshot&>( *this ) = s_empty;
+            delta.reset();
+        }
+        return false;
+    }
+
+    const int t = ir_SessionTick.getInt();
+    if( valid && t == tick )
+        return false;
+
+    PROFILE_SCOPE( "race.state" );
+
+    tick       = t;
+    valid      = true;
+    selfIdx    = ir_session.driverCarIdx;
+    isRace     = ir_session.sessionType == SessionType::RACE;
+    isPreStart = ir_isPreStart();
+
+    const int sn = ir_SessionNum.getInt();
+    if( sn != sessionNum )
+    {
+        sessionNum = sn;
+        sectors.reset();
+        closing.reset();
+        delta.reset();
+    }
+
+    // Raw per-car values, and who sits at which class position
+    int numClasses = 0;
+    int slotOf[IR_MAX_CARS];
+    for( int i=0; i<IR_MAX_CARS; ++i )
+    {
+        const Car& car = ir_session.cars[i];
+
+        lap[i]              = ir_CarIdxLap.getInt(i);
+        lapCount[i]         = std::max( lap[i], ir_CarIdxLapCompleted.getInt(i) );
+        position[i]         = ir_getPosition(i);
+        positionsChanged[i] = ir_getPositionsChanged(i);
+        classId[i]          = ir_getClassId(i);
+        pitAge[i]           = lap[i] - car.lastLapInPits;
+        onPitRoad[i]        = ir_CarIdxOnPitRoad.getBool(i);
+        lapDistPct[i]       = ir_CarIdxLapDistPct.getFloat(i);
+        estTime[i]          = ir_CarIdxEstTime.getFloat(i);
+        f2Time[i]           = ir_CarIdxF2Time.getFloat(i);
+        lastLapTime[i]      = ir_CarIdxLastLapTime.getFloat(i);
+
+        slotOf[i] = -1;
+        if( car.isPaceCar || car.isSpectator || car.userName.empty() )
+            continue;
+        const int slot = classSlot( classId[i], numClasses );
+        slotOf[i] = slot;
+        if( slot >= 0 && position[i] > 0 && position[i] <= IR_MAX_CARS )
+            s_carAtClassPos[slot][position[i]] = i;
+    }
+
+    order.build( lapDistPct );
+
+    const double sessionTime = ir_SessionTime.getDouble();
+    lines.update( sessionTime, lapDistPct, lap );
+    sectors.update( sessionTime, ir_session.sectorStartPct, lapDistPct, onPitRoad, classId, selfIdx, ir_session.cars[selfIdx].incidentCount );
+
+    // Class-relative gaps. Timing loops give the exact interval whenever the car in front is
+    // within a lap; F2Time covers the rest.
+    for( int i=0; i<IR_MAX_CARS; ++i )
+    {
+        const int slot   = slotOf[i];
+        const int leader = slot >= 0 ? s_carAtClassPos[slot][1] : -1;
+
+        classLeaderIdx[i] = leader;
+        lapsToLeader[i]   = ir_getLapDeltaToLeader( i, leader );
+        gapToLeader[i]    = 0;
+        interval[i]       = 0;
+        if( isRace && leader >= 0 && leader != i && !lines.raceGap( i, leader, gapToLeader[i] ) )
+            gapToLeader[i] = std::max( 0.0f, f2Time[i] - f2Time[leader] );
+    }
+    for( int i=0; i<IR_MAX_CARS; ++i )
+    {
+        const int slot  = slotOf[i];
+        const int ahead = isRace && slot >= 0 && position[i] > 1 && position[i] <= IR_MAX_CARS ? s_carAtClassPos[slot][position[i]-1] : -1;
+        if( ahead >= 0 && !lines.raceGap( i, ahead, interval[i] ) )
+            interval[i] = std::max( 0.0f, gapToLeader[i] - gapToLeader[ahead] );
+    }
+
+    // Relative to us. Other cars' EstTime is scaled into our class' time domain before comparing,
+    // and gaps that span the S/F line are unwrapped by one reference lap.
+    const float selfClassEst = ir_session.cars[selfIdx].carClassEstLapTime;
+    selfClassId = classId[selfIdx];
+    refLapTime  = selfClassEst > 0.1f ? selfClassEst : ir_estimateLaptime();
+    if( refLapTime <= 0.1f )
+        refLapTime = 120.0f;
+
+    const int   selfLap = ir_Lap.getInt();
+    const float selfPct = ir_LapDistPct.getFloat();
+    const float selfEst = estTime[selfIdx];
+    for( int i=0; i<IR_MAX_CARS; ++i )
+    {
+        const Car&  car    = ir_session.cars[i];
+        const float carPct = lapDistPct[i];
+
+        float dPct = carPct - selfPct;
+        if( fabsf(dPct) > 0.5f )
+            dPct += dPct > 0 ? -1.0f : 1.0f;
+        relPct[i] = carPct < 0 ? 0 : dPct;
+
+        const float classRatio = (selfClassEst > 0.1f && car.carClassEstLapTime > 0.1f) ? car.carClassEstLapTime / selfClassEst : 1.0f;
+        float rel      = estTime[i] / classRatio - selfEst;
+        int   lapDelta = lap[i] - selfLap;
+        int   wrap     = 0;
+        if( fabsf(carPct - selfPct) > 0.5f )
+        {
+            if( selfPct > carPct ) {
+                rel += refLapTime;
+                lapDelta -= 1;
+                wrap = 1;
+            }
+            else {
+                rel -= refLapTime;
+                lapDelta += 1;
+                wrap = -1;
+            }
+        }
+        // Prefer the timing loops, measured at whichever of the two cars crossed a loop last
+        // behind the other, as long as that crossing is recent and the result is plausible.
+        // Otherwise, once we have a clean lap, use the time our own lap took over the same stretch.
+        if( i != selfIdx && carPct >= 0 )
+        {
+            const int   behind = relPct[i] > 0 ? selfIdx : i;
+            const int   front  = relPct[i] > 0 ? i : selfIdx;
+            const float maxAge = refLapTime * 4.0f / TimingLines::NumLoops + 0.5f;
+            float gap;
+            if( sessionTime - lines.lastCrossing(behind) < maxAge && lines.trackGap( behind, front, gap ) && gap < refLapTime * 0.75f )
+                rel = relPct[i] > 0 ? gap : -gap;
+            else if( delta.timeBetween( lapDistPct[behind], lapDistPct[front], gap ) && gap < refLapTime * 0.75f )
+                rel = relPct[i] > 0 ? gap : -gap;
+        }
+
+        relTime[i]     = rel;
+        relWrap[i]     = wrap;
+        relLapDelta[i] = (!isRace || isPreStart || car.isPaceCar) ? 0 : lapDelta;
+    }
+    closing.update( sessionTime, relTime, lapDistPct, onPitRoad, selfIdx );
+
+    // iRating prediction over everyone with a class position. Expected scores are only rebuilt
+    // when the roster changes; otherwise this just re-derives deltas for cars that moved.
+    int irClass[IR_MAX_CARS], irRating[IR_MAX_CARS], irPos[IR_MAX_CARS];
+    for( int i=0; i<IR_MAX_CARS; ++i )
+    {
+        const Car& car = ir_session.cars[i];
+        irClass[i]  = car.classId;
+        irRating[i] = car.irating;
+        irPos[i]    = (car.isSpectator || car.carNumber < 0 || car.isPaceCar) ? 0 : position[i];
+    }
+    irPred.update( irClass, irRating, irPos );
+
+    // Lap history
+    int   lapsCompleted[IR_MAX_CARS], compound[IR_MAX_CARS];
+    for( int i=0; i<IR_MAX_CARS; ++i )
+    {
+        lapsCompleted[i] = ir_CarIdxLapCompleted.getInt(i);
+        compound[i]      = ir_CarIdxTireCompound.isValid() ? ir_CarIdxTireCompound.getInt(i) : -1;
+        if( compound[i] < 0 )
+            compound[i] = ir_session.cars[i].tireCompound;
+    }
+    const bool underCaution = (ir_SessionFlags.getInt() & (irsdk_caution | irsdk_cautionWaving)) != 0 || ir_SessionState.getInt() < irsdk_StateRacing;
+    laps.update( sessionNum, underCaution, lapsCompleted, lastLapTime, onPitRoad, compound );
+
+    delta.update( ir_LapDistPct.getFloat(), ir_SessionTime.getDouble(), ir_IsOnTrack.getBool() || ir_isReplayActive(), ir_OnPitRoad.getBool() );
+
+    return true;
+}
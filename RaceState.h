@@ -0,0 +1,104 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include <stdint.h>
+#include "iracing.h"
+#include "IRatingPredictor.h"
+#include "LapHistory.h"
+#include "DeltaEngine.h"
+#include "TimingLines.h"
+#include "SectorTiming.h"
+#include "TrackOrder.h"
+#include "ClosingRate.h"
+
+// Per-car race data derived from telemetry once per sim tick, right after ir_tick(), and shared by
+// all overlays instead of each of them re-deriving it from the raw ir_CarIdx* arrays every frame.
+// Structure-of-arrays indexed by carIdx. Only meaningful while `valid` is set; preview/stub data
+// paths in the overlays don't go through here.
+
+// Everything derived from the session, dropped as a whole when we leave it
+struct RaceSnapshot
+{
+    bool    valid = false;
+    int     tick = -1;                          // ir_SessionTick this snapshot was built from
+    int     selfIdx = -1;
+    int     selfClassId = 0;
+    bool    isRace = false;
+    bool    isPreStart = false;
+    int     sessionNum = -1;
+    float   refLapTime = 0;                     // own class lap estimate, used to unwrap relative times
+
+    int     lap[IR_MAX_CARS] = {};              // raw CarIdxLap
+    int     lapCount[IR_MAX_CARS] = {};         // max(CarIdxLap, CarIdxLapCompleted)
+    int     position[IR_MAX_CARS] = {};         // best known class position, see ir_getPosition()
+    int     positionsChanged[IR_MAX_CARS] = {}; // see ir_getPositionsChanged()
+    int     classId[IR_MAX_CARS] = {};          // see ir_getClassId()
+    int     classLeaderIdx[IR_MAX_CARS] = {};   // carIdx of P1 in this car's class, -1 if unknown
+    int     lapsToLeader[IR_MAX_CARS] = {};     // see ir_getLapDeltaToLeader(), against the class leader
+    int     pitAge[IR_MAX_CARS] = {};           // laps since last seen on pit road
+    bool    onPitRoad[IR_MAX_CARS] = {};
+    float   lapDistPct[IR_MAX_CARS] = {};
+    float   estTime[IR_MAX_CARS] = {};
+    float   f2Time[IR_MAX_CARS] = {};           // raw CarIdxF2Time
+    float   lastLapTime[IR_MAX_CARS] = {};
+    float   gapToLeader[IR_MAX_CARS] = {};      // races only: seconds behind the class leader (timing loops, else F2Time)
+    float   interval[IR_MAX_CARS] = {};         // races only: seconds behind the car one class position ahead (likewise)
+
+    // Relative to our own car
+    float   relPct[IR_MAX_CARS] = {};           // lap fraction ahead (+) or behind (-), in [-0.5,0.5]; 0 if not in world
+    float   relTime[IR_MAX_CARS] = {};          // seconds ahead (+) or behind (-); timing loops, else our own lap, else class-normalized EstTime
+    int     relLapDelta[IR_MAX_CARS] = {};      // laps ahead (+) or behind (-); 0 outside of races
+    int     relWrap[IR_MAX_CARS] = {};          // +1/-1 when the gap spans S/F with the car ahead/behind
+
+    // Cars in the world sorted by lap distance, for nearest-neighbor queries
+    TrackOrder  order;
+
+    // Crossing times of every car at fixed points around the lap, for exact car-to-car intervals
+    TimingLines lines;
+
+    // How fast each car's relTime gap is shrinking, from a short rolling window. Reset on session change.
+    ClosingRate closing;
+
+    // Last/best sector times and sector colors for every car. Reset on session change.
+    SectorTiming sectors;
+
+    // Predicted iRating change at the current class positions. Only meaningful in races.
+    IRatingPredictor irPred;
+
+    // Recent laps of every car, with pit/caution tagging and stints. Kept across ticks; reset on session change.
+    LapHistory laps;
+};
+
+struct RaceState : RaceSnapshot
+{
+    // Own-car delta against our last, session-best and pinned laps. Last/best reset on session change
+    // and when we leave the session; a pinned lap is the user's and outlives both.
+    DeltaEngine delta;
+
+    // Rebuilds the snapshot if the sim has produced a new tick. Returns true if it did.
+    bool    update();
+};
+
+extern RaceState ir_race;
@@ -0,0 +1,254 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Sector times for the whole field. Every sim tick each car's CarIdxLapDistPct movement is checked
+// against the session's sector boundaries (SplitTimeInfo); crossing times are interpolated between
+// the two samples, so sector times don't carry the tick's quantization. Per car we keep the last
+// and best time of every sector, plus the best per car class, all in flat fixed-size arrays.
+//
+// Each finished sector also gets a state for coloring: purple for a class best, green for a personal
+// best, yellow otherwise. A sector the car is currently in has no state. Sectors that touched pit
+// road (or, for the player, picked up an incident) are shown yellow and never count as bests.
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include "iracing.h"
+#include "util.h"
+
+class SectorTiming
+{
+    public:
+
+        static constexpr int MaxSectors = 16;
+        static constexpr int MaxClasses = 16;
+
+        enum State : uint8_t { None = 0, Slower, PersonalBest, ClassBest };
+
+        // Display color of a finished sector's state; `none` for a sector without one.
+        static float4 stateColor( State s, const float4& none )
+        {
+            switch( s )
+            {
+                case ClassBest:    return float4( 0.70f, 0.30f, 1.00f, 0.9f );
+                case PersonalBest: return float4( 0.20f, 0.85f, 0.25f, 0.9f );
+                case Slower:       return float4( 1.00f, 0.85f, 0.00f, 0.9f );
+                default:           return none;
+            }
+        }
+
+        SectorTiming()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            m_numSectors = 0;
+            m_numClasses = 0;
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                resetCar( i );
+                for( int s=0; s<MaxSectors; ++s )
+                    m_last[i][s] = m_best[i][s] = 0;
+            }
+        }
+
+        // Arrays indexed by carIdx. `bounds` are ascending lap fractions starting at 0 and ending at 1.
+        void update( double sessionTime, const std::vector<float>& bounds, const float* pct, const bool* onPitRoad, const int* classId, int selfIdx, int selfIncidents )
+        {
+            const int n = std::min( (int)bounds.size() - 1, MaxSectors );
+            if( n != m_numSectors || (n > 0 && !sameBounds( bounds, n )) )
+            {
+                reset();
+                m_numSectors = n;
+                for( int s=0; s<n; ++s )
+                    m_bounds[s] = bounds[s];
+            }
+            if( n <= 0 )
+                return;
+
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                const float cur  = pct[i];
+                const float prev = m_prevPct[i];
+                if( cur < 0 || prev < 0 || sessionTime < m_prevTime[i] )
+                {
+                    // Left or (re)entered the world, or a replay seek: restart the car's timing
+                    resetCar( i );
+                    m_prevPct[i]  = cur;
+                    m_prevTime[i] = sessionTime;
+                    continue;
+                }
+
+                const bool  wrapped = cur < prev - 0.5f;
+                const float cur1    = wrapped ? cur + 1.0f : cur;
+                const float step    = cur1 - prev;
+                if( step > 0.25f || step < -0.01f )
+                    m_sectorStart[i] = -1;      // teleported; the sector in progress is meaningless
+
+                if( onPitRoad[i] )
+                    m_dirty[i] = true;
+                if( i == selfIdx && selfIncidents > m_selfIncidents )
+                    m_dirty[i] = true;
+
+                if( step > 0 && step <= 0.25f )
+                {
+                    // Boundaries in (prev, cur1], in crossing order. Boundary s starts sector s.
+                    const int from = sectorAt( prev );
+                    for( int k=0; k<n; ++k )
+                    {
+                        const int   s = (from + 1 + k) % n;
+                        float       b = m_bounds[s];
+                        if( b <= prev )
+                            b += 1.0f;
+                        if( b > cur1 )
+                            break;
+                        const double t = m_prevTime[i] + (sessionTime - m_prevTime[i]) * ((b - prev) / step);
+                        crossed( i, s, t, classId[i] );
+                    }
+                }
+
+                m_prevPct[i]  = cur;
+                m_prevTime[i] = sessionTime;
+            }
+            m_selfIncidents = selfIncidents;
+        }
+
+        int     numSectors() const                      { return m_numSectors; }
+        float   lastTime( int carIdx, int s ) const     { return m_last[carIdx][s]; }   // 0 if none yet
+        float   bestTime( int carIdx, int s ) const     { return m_best[carIdx][s]; }   // 0 if none yet
+        State   state( int carIdx, int s ) const        { return (State)m_state[carIdx][s]; }
+
+        // Sector containing lap position p
+        int sectorAt( float p ) const
+        {
+            int s = 0;
+            while( s + 1 < m_numSectors && m_bounds[s+1] <= p )
+                ++s;
+            return s;
+        }
+
+        // Best time in a class for sector s, 0 if nobody has one yet
+        float classBest( int classId, int s ) const
+        {
+            for( int c=0; c<m_numClasses; ++c )
+                if( m_classIds[c] == classId )
+                    return m_classBest[c][s];
+            return 0;
+        }
+
+    private:
+
+        void resetCar( int carIdx )
+        {
+            m_prevPct[carIdx]     = -1;
+            m_prevTime[carIdx]    = 0;
+            m_sectorStart[carIdx] = -1;
+            m_curSector[carIdx]   = -1;
+            m_dirty[carIdx]       = false;
+            for( int s=0; s<MaxSectors; ++s )
+                m_state[carIdx][s] = None;
+        }
+
+        bool sameBounds( const std::vector<float>& bounds, int n ) const
+        {
+            for( int s=0; s<n; ++s )
+                if( bounds[s] != m_bounds[s] )
+                    return false;
+            return true;
+        }
+
+        int classSlot( int classId )
+        {
+            for( int c=0; c<m_numClasses; ++c )
+                if( m_classIds[c] == classId )
+                    return c;
+            if( m_numClasses >= MaxClasses )
+                return -1;
+            m_classIds[m_numClasses] = classId;
+            for( int s=0; s<MaxSectors; ++s )
+                m_classBest[m_numClasses][s] = 0;
+            return m_numClasses++;
+        }
+
+        // Car crossed the boundary that starts sector `next` at session time t
+        void crossed( int carIdx, int next, double t, int classId )
+        {
+            const int n    = m_numSectors;
+            const int done = (next + n - 1) % n;
+
+            if( m_sectorStart[carIdx] >= 0 && m_curSector[carIdx] == done )
+            {
+                const float time  = (float)(t - m_sectorStart[carIdx]);
+                const bool  valid = !m_dirty[carIdx] && time > 0.05f;
+                m_last[carIdx][done] = time;
+
+                State st = Slower;
+                if( valid )
+                {
+                    float& best = m_best[carIdx][done];
+                    if( best <= 0 || time < best ) {
+                        best = time;
+                        st = PersonalBest;
+                    }
+                    const int c = classSlot( classId );
+                    if( c >= 0 )
+                    {
+                        float& cb = m_classBest[c][done];
+                        if( cb <= 0 || time <= cb ) {
+                            cb = time;
+                            st = ClassBest;
+                        }
+                    }
+                }
+                m_state[carIdx][done] = st;
+            }
+
+            m_curSector[carIdx]   = next;
+            m_sectorStart[carIdx] = t;
+            m_dirty[carIdx]       = false;
+            m_state[carIdx][next] = None;
+        }
+
+        int     m_numSectors = 0;
+        float   m_bounds[MaxSectors] = {};
+
+        float   m_last[IR_MAX_CARS][MaxSectors] = {};
+        float   m_best[IR_MAX_CARS][MaxSectors] = {};
+        uint8_t m_state[IR_MAX_CARS][MaxSectors] = {};
+
+        int     m_numClasses = 0;
+        int     m_classIds[MaxClasses] = {};
+        float   m_classBest[MaxClasses][MaxSectors] = {};
+
+        float   m_prevPct[IR_MAX_CARS] = {};
+        double  m_prevTime[IR_MAX_CARS] = {};
+        double  m_sectorStart[IR_MAX_CARS] = {};    // session time the current sector began, -1 if unknown
+        int     m_curSector[IR_MAX_CARS] = {};      // -1 until the first boundary crossing
+        bool    m_dirty[IR_MAX_CARS] = {};          // current sector touched pit road or an incident
+        int     m_selfIncidents = 0;
+};
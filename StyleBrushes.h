@@ -0,0 +1,144 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Shared gradient resources for the card/panel look used by most overlays.
+// Gradient stop collections are the GPU-side part of a gradient brush; they're immutable, so one
+// per (D2D factory, style) is created and handed to every overlay. Overlays share a D3D device and
+// D2D factory (see Overlay::enable), which is what makes these resources usable across them.
+// The brushes themselves are cheap wrappers that carry per-draw state (start/end point, opacity),
+// so each overlay still owns its own.
+
+#include <vector>
+#include <d2d1_3.h>
+#include <wrl.h>
+#include "util.h"
+
+struct GradientStyle
+{
+    static constexpr int MaxStops = 4;
+
+    int                 count = 0;
+    D2D1_GRADIENT_STOP  stops[MaxStops] = {};
+
+    GradientStyle& add( float position, const float4& color )
+    {
+        if( count < MaxStops )
+        {
+            stops[count].position = position;
+            stops[count].color = color;
+            count++;
+        }
+        return *this;
+    }
+
+    bool operator==( const GradientStyle& o ) const
+    {
+        return count == o.count && memcmp( stops, o.stops, count*sizeof(D2D1_GRADIENT_STOP) ) == 0;
+    }
+};
+
+class StyleBrushes
+{
+    public:
+
+        // Outer card background, top to bottom
+        static GradientStyle card( float alpha = 0.95f )
+        {
+            return GradientStyle()
+                .add( 0.0f,  float4(0.16f, 0.18f, 0.22f, alpha) )
+                .add( 0.45f, float4(0.06f, 0.07f, 0.09f, alpha) )
+                .add( 1.0f,  float4(0.02f, 0.02f, 0.03f, alpha) );
+        }
+
+        // Inner panels, top to bottom
+        static GradientStyle panel( float alpha = 0.92f )
+        {
+            return GradientStyle()
+                .add( 0.0f,  float4(0.08f, 0.09f, 0.11f, alpha) )
+                .add( 0.55f, float4(0.04f, 0.045f, 0.055f, alpha) )
+                .add( 1.0f,  float4(0.02f, 0.02f, 0.03f, alpha) );
+        }
+
+        // Vertical (0,0)->(0,1) linear gradient brush; callers set start/end points per draw.
+        static HRESULT createLinearGradient( ID2D1RenderTarget* renderTarget, const GradientStyle& style, ID2D1LinearGradientBrush** brush )
+        {
+            if( !renderTarget || !brush )
+                return E_INVALIDARG;
+
+            ID2D1GradientStopCollection* stops = getStops( renderTarget, style );
+            if( !stops )
+                return E_FAIL;
+
+            D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES props = {};
+            props.startPoint = D2D1_POINT_2F{ 0,0 };
+            props.endPoint = D2D1_POINT_2F{ 0,1 };
+            return renderTarget->CreateLinearGradientBrush( props, stops, brush );
+        }
+
+        // Drops everything; called when the shared device goes away.
+        static void releaseAll()
+        {
+            entries().clear();
+        }
+
+        static size_t size()
+        {
+            return entries().size();
+        }
+
+    private:
+
+        struct Entry
+        {
+            ID2D1Factory*                                           factory;
+            GradientStyle                                           style;
+            Microsoft::WRL::ComPtr<ID2D1GradientStopCollection>     stops;
+        };
+
+        static std::vector<Entry>& entries()
+        {
+            static std::vector<Entry> s_entries;
+            return s_entries;
+        }
+
+        static ID2D1GradientStopCollection* getStops( ID2D1RenderTarget* renderTarget, const GradientStyle& style )
+        {
+            Microsoft::WRL::ComPtr<ID2D1Factory> factory;
+            renderTarget->GetFactory( &factory );
+
+            // Only a handful of styles exist, a linear scan beats hashing here
+            for( const Entry& e : entries() )
+                if( e.factory == factory.Get() && e.style == style )
+                    return e.stops.Get();
+
+            Entry e = { factory.Get(), style };
+            if( FAILED(renderTarget->CreateGradientStopCollection( style.stops, style.count, D2D1_GAMMA_2_2, D2D1_EXTEND_MODE_CLAMP, &e.stops )) )
+                return nullptr;
+
+            entries().push_back( e );
+            return entries().back().stops.Get();
+        }
+};
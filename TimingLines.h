@@ -0,0 +1,166 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Virtual timing loops for the whole field. The lap is cut into NumLoops equally spaced loops;
+// every sim tick each car's LapDistPct movement is checked against them and the crossing time is
+// interpolated between the two samples. The interval between two cars is then simply the time
+// between their crossings of the same loop, which is exact wherever they are on track and whatever
+// class they're in, unlike EstTime-based estimates.
+//
+// Storage is fixed: two laps' worth of crossings per car and loop (so a car up to a lap ahead can
+// still be matched on the same lap). Per tick the cost is one pass over the cars plus the handful
+// of loops each of them crossed.
+
+#include <math.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "iracing.h"
+
+class TimingLines
+{
+    public:
+
+        static constexpr int NumLoops = 256;
+
+        TimingLines()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                m_prevPct[i]  = -1;
+                m_lastLoop[i] = -1;
+                for( int s=0; s<2; ++s )
+                    for( int k=0; k<NumLoops; ++k )
+                        m_lapAt[i][s][k] = INT_MIN;
+            }
+        }
+
+        // Arrays indexed by carIdx. pct < 0 means the car isn't in the world.
+        void update( double sessionTime, const float* pct, const int* lap )
+        {
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                const float p    = pct[i];
+                const float prev = m_prevPct[i];
+                if( p < 0 || prev < 0 || lap[i] < 0 )
+                {
+                    // (Re)entering the world: just take the position as the starting point
+                    m_prevPct[i] = p;
+                    m_lap[i]     = lap[i];
+                    m_prevTime[i] = sessionTime;
+                    continue;
+                }
+
+                const bool  wrapped = p < prev - 0.5f;
+                const float p1      = wrapped ? p + 1.0f : p;
+                const float step    = p1 - prev;
+                if( step > 0 && step < 0.25f && sessionTime > m_prevTime[i] )
+                {
+                    // Loops in (prev, p1], in crossing order
+                    const int first = (int)floorf( prev * NumLoops ) + 1;
+                    const int last  = (int)floorf( p1 * NumLoops );
+                    for( int n=first; n<=last; ++n )
+                    {
+                        const int   k      = n % NumLoops;
+                        const float loopAt = (float)n / NumLoops;
+                        if( k == 0 )
+                            m_lap[i]++;
+                        const double t = m_prevTime[i] + (sessionTime - m_prevTime[i]) * ((loopAt - prev) / step);
+                        const int    s = m_lap[i] & 1;
+                        m_time[i][s][k]  = t;
+                        m_lapAt[i][s][k] = m_lap[i];
+                        m_lastLoop[i]    = k;
+                        m_lastLap[i]     = m_lap[i];
+                        m_lastTime[i]    = t;
+                    }
+                }
+
+                // Resync our lap count if the sim disagrees by more than the odd late tick (tows, resets)
+                if( abs( m_lap[i] - lap[i] ) > 1 )
+                    m_lap[i] = lap[i];
+
+                if( step >= 0.25f || step < -0.01f )
+                    m_lastLoop[i] = -1;     // teleported; don't trust the old crossing as "latest"
+
+                m_prevPct[i]  = p;
+                m_prevTime[i] = sessionTime;
+            }
+        }
+
+        // Session time at which the car last crossed a loop, or a negative value if it hasn't
+        double lastCrossing( int car ) const
+        {
+            return m_lastLoop[car] >= 0 ? m_lastTime[car] : -1.0;
+        }
+
+        // Seconds `car` trails `target` on track, measured at the loop `car` crossed last: the time
+        // since `target`'s most recent crossing of it. Laps don't matter.
+        bool trackGap( int car, int target, float& out ) const
+        {
+            const int k = m_lastLoop[car];
+            if( k < 0 || car == target )
+                return false;
+            const double tc = m_lastTime[car];
+            double best = -1;
+            for( int s=0; s<2; ++s )
+                if( m_lapAt[target][s][k] != INT_MIN && m_time[target][s][k] <= tc && m_time[target][s][k] > best )
+                    best = m_time[target][s][k];
+            if( best < 0 )
+                return false;
+            out = (float)(tc - best);
+            return true;
+        }
+
+        // Race interval: seconds `car` trails `target` at the loop `car` crossed last, with `target`
+        // having crossed it on the same lap. Fails if `target` isn't within a lap ahead.
+        bool raceGap( int car, int target, float& out ) const
+        {
+            const int k = m_lastLoop[car];
+            if( k < 0 || car == target )
+                return false;
+            const int lap = m_lastLap[car];
+            const int s   = lap & 1;
+            if( m_lapAt[target][s][k] != lap )
+                return false;
+            out = (float)(m_lastTime[car] - m_time[target][s][k]);
+            return out >= 0;
+        }
+
+    private:
+
+        double  m_time[IR_MAX_CARS][2][NumLoops];   // crossing time, by lap parity and loop
+        int     m_lapAt[IR_MAX_CARS][2][NumLoops];  // lap the crossing happened on, INT_MIN if never
+        float   m_prevPct[IR_MAX_CARS];
+        double  m_prevTime[IR_MAX_CARS] = {};
+        int     m_lap[IR_MAX_CARS] = {};            // own lap count, bumped at loop 0 and kept close to CarIdxLap
+        int     m_lastLoop[IR_MAX_CARS];                // -1 if there's no trustworthy latest crossing
+        int     m_lastLap[IR_MAX_CARS] = {};
+        double  m_lastTime[IR_MAX_CARS] = {};
+};
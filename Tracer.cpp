@@ -0,0 +1,231 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "Tracer.h"
+#include <windows.h>
+#include <stdio.h>
+#include <vector>
+#include <mutex>
+#include <unordered_set>
+#include <algorithm>
+
+std::atomic<bool> Tracer::s_enabled = false;
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        uint64_t    start;
+        uint64_t    end;
+    };
+
+    // Single producer (the owning thread), any number of readers in dump().
+    // A ring outlives its thread: its events stay dumpable until another thread claims it. Claiming
+    // bumps 'epoch' around the owner fields, so dump() can tell it raced with a new owner.
+    struct TraceRing
+    {
+        std::atomic<uint64_t>   head = 0;
+        std::atomic<bool>       owned = false;
+        std::atomic<bool>       live = false;
+        std::atomic<uint32_t>   epoch = 0;
+        uint64_t                base = 0;       // head when the current owner claimed the ring
+        DWORD                   tid = 0;
+        const char*             threadName = nullptr;
+        TraceEvent              events[Tracer::RingSize];
+    };
+
+    // Static storage so that neither recording nor thread registration ever allocates. Pages of
+    // rings that are never claimed are never touched.
+    TraceRing               s_rings[Tracer::MaxThreads];
+    std::atomic<int>        s_ringCount = 0;    // rings ever claimed; dump() only looks at these
+
+    // Hands the ring back when the thread exits
+    struct RingOwner
+    {
+        TraceRing* ring = nullptr;
+        ~RingOwner() { if( ring ) ring->owned.store( false, std::memory_order_release ); }
+    };
+
+    thread_local RingOwner   t_owner;
+    thread_local const char* t_threadName = nullptr;
+
+    TraceRing* ringForThisThread()
+    {
+        if( t_owner.ring )
+            return t_owner.ring;
+
+        for( int i=0; i<Tracer::MaxThreads; ++i )
+        {
+            TraceRing* r = &s_rings[i];
+            bool expected = false;
+            if( r->owned.load(std::memory_order_relaxed) || !r->owned.compare_exchange_strong(expected, true, std::memory_order_acquire) )
+                continue;
+
+            r->epoch.fetch_add( 1, std::memory_order_acq_rel );
+            r->base = r->head.load( std::memory_order_relaxed );
+            r->tid = GetCurrentThreadId();
+            r->threadName = t_threadName;
+            r->epoch.fetch_add( 1, std::memory_order_release );
+            r->live.store( true, std::memory_order_release );
+
+            int count = s_ringCount.load( std::memory_order_relaxed );
+            while( count < i+1 && !s_ringCount.compare_exchange_weak(count, i+1, std::memory_order_release) ) {}
+
+            t_owner.ring = r;
+            return r;
+        }
+        return nullptr;     // MaxThreads threads are being traced already
+    }
+
+    double usPerTick()
+    {
+        static const double s = []{
+            LARGE_INTEGER f;
+            QueryPerformanceFrequency( &f );
+            return 1000000.0 / (double)f.QuadPart;
+        }();
+        return s;
+    }
+
+    void writeJsonString( FILE* fp, const char* s )
+    {
+        fputc( '"', fp );
+        for( ; s && *s; ++s )
+        {
+            const unsigned char c = (unsigned char)*s;
+            if( c == '"' || c == '\\' )
+                fputc( '\\', fp ), fputc( c, fp );
+            else if( c < 0x20 )
+                fprintf( fp, "\\u%04x", c );
+            else
+                fputc( c, fp );
+        }
+        fputc( '"', fp );
+    }
+}
+
+void Tracer::setEnabled( bool on )
+{
+    s_enabled.store( on, std::memory_order_relaxed );
+}
+
+void Tracer::setThreadName( const char* name )
+{
+    t_threadName = name;
+    if( t_owner.ring )
+        t_owner.ring->threadName = name;
+}
+
+const char* Tracer::intern( const std::string& name )
+{
+    static std::mutex                       s_mutex;
+    static std::unordered_set<std::string>  s_names;   // node-based: element addresses are stable
+
+    std::lock_guard<std::mutex> lock( s_mutex );
+    return s_names.insert( name ).first->c_str();
+}
+
+uint64_t Tracer::now()
+{
+    LARGE_INTEGER t;
+    QueryPerformanceCounter( &t );
+    return (uint64_t)t.QuadPart;
+}
+
+void Tracer::record( const char* name, uint64_t startTicks, uint64_t endTicks )
+{
+    TraceRing* r = ringForThisThread();
+    if( !r )
+        return;
+
+    const uint64_t h = r->head.load( std::memory_order_relaxed );
+    TraceEvent& e = r->events[h & (RingSize-1)];
+    e.name  = name;
+    e.start = startTicks;
+    e.end   = endTicks;
+    r->head.store( h + 1, std::memory_order_release );
+}
+
+bool Tracer::dump( const std::string& path, float seconds )
+{
+    const uint64_t dumpTime = now();
+    const double   toUs     = usPerTick();
+    const uint64_t window   = (uint64_t)(std::max( 0.1f, seconds ) * 1000000.0 / toUs);
+    const uint64_t minEnd   = dumpTime > window ? dumpTime - window : 0;
+
+    FILE* fp = fopen( path.c_str(), "wb" );
+    if( !fp )
+        return false;
+
+    fprintf( fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+    fprintf( fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"iFL03\"}}" );
+
+    std::vector<TraceEvent> copy;
+    const int ringCount = std::min( s_ringCount.load(std::memory_order_acquire), MaxThreads );
+    for( int i=0; i<ringCount; ++i )
+    {
+        const TraceRing& r = s_rings[i];
+        if( !r.live.load(std::memory_order_acquire) )
+            continue;
+
+        // Owner fields are only consistent between two equal, even epoch reads
+        const uint32_t   epoch      = r.epoch.load( std::memory_order_acquire );
+        const uint64_t   base       = r.base;
+        const DWORD      tid        = r.tid;
+        const char*      threadName = r.threadName;
+
+        // Copy first, then re-read the head: anything the writer may have lapped meanwhile is dropped.
+        const uint64_t h1    = r.head.load( std::memory_order_acquire );
+        const uint64_t begin = std::max( base, h1 > RingSize ? h1 - RingSize : 0 );
+        copy.clear();
+        for( uint64_t j=begin; j<h1; ++j )
+            copy.push_back( r.events[j & (RingSize-1)] );
+        const uint64_t h2    = r.head.load( std::memory_order_acquire );
+        const uint64_t valid = std::max( begin, h2 >= RingSize ? h2 - RingSize + 1 : 0 );
+        if( (epoch & 1) || r.epoch.load(std::memory_order_acquire) != epoch )
+            continue;   // claimed by a new thread while we were reading; its old events are gone
+
+        if( threadName )
+        {
+            fprintf( fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":", tid );
+            writeJsonString( fp, threadName );
+            fprintf( fp, "}}" );
+        }
+
+        for( uint64_t j=valid; j<h1; ++j )
+        {
+            const TraceEvent& e = copy[j - begin];
+            if( e.end < minEnd || e.end < e.start )
+                continue;
+            fprintf( fp, ",\n{\"name\":" );
+            writeJsonString( fp, e.name );
+            fprintf( fp, ",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}",
+                tid, (double)((int64_t)e.start - (int64_t)minEnd) * toUs, (double)(e.end - e.start) * toUs );
+        }
+    }
+
+    fprintf( fp, "\n]}\n" );
+    fclose( fp );
+    return true;
+}
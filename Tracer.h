@@ -0,0 +1,98 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+// Always-compiled scoped-event tracer for hunting frame hitches.
+// Every thread appends complete events to its own fixed-size ring: no locks and no allocation on
+// the recording path. dump() writes the last N seconds of all rings as Chrome trace-event JSON,
+// which opens in chrome://tracing or ui.perfetto.dev.
+// Event names are stored by pointer, so they must be string literals or come from intern().
+// A thread's ring is handed back when the thread exits and reused by the next new thread; at most
+// MaxThreads threads can be traced at the same time.
+
+class Tracer
+{
+    public:
+
+        static constexpr int        MaxThreads = 8;
+        static constexpr uint32_t   RingSize = 1u << 16;    // events per thread, power of two
+
+        static bool     enabled() { return s_enabled.load( std::memory_order_relaxed ); }
+        static void     setEnabled( bool on );
+
+        // Label for the calling thread in the timeline. Must be a static string.
+        static void     setThreadName( const char* name );
+
+        // Stable copy of a runtime-built event name, for TRACE_SCOPE. Takes a lock; call it once and keep the pointer.
+        static const char* intern( const std::string& name );
+
+        static void     record( const char* name, uint64_t startTicks, uint64_t endTicks );
+        static uint64_t now();
+
+        // Safe to call while other threads are recording.
+        static bool     dump( const std::string& path, float seconds );
+
+    private:
+
+        static std::atomic<bool>    s_enabled;
+};
+
+class TraceScope
+{
+    public:
+
+        explicit TraceScope( const char* name )
+        {
+            if( Tracer::enabled() )
+            {
+                m_name = name;
+                m_start = Tracer::now();
+            }
+        }
+
+        ~TraceScope()
+        {
+            if( m_name )
+                Tracer::record( m_name, m_start, Tracer::now() );
+        }
+
+        TraceScope( const TraceScope& ) = delete;
+        TraceScope& operator=( const TraceScope& ) = delete;
+
+    private:
+
+        const char* m_name = nullptr;
+        uint64_t    m_start = 0;
+};
+
+#define IFL03_TRACE_CONCAT2(a,b) a##b
+#define IFL03_TRACE_CONCAT(a,b) IFL03_TRACE_CONCAT2(a,b)
+
+// Emits one trace event covering the rest of the enclosing block.
+#define TRACE_SCOPE( name ) \
+    TraceScope IFL03_TRACE_CONCAT(traceScope,__LINE__)( name )
@@ -0,0 +1,205 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include <stdint.h>
+#include "iracing.h"
+
+// Cars in the world sorted by lap distance, rebuilt once per sim tick. Positions barely change from
+// one tick to the next, so the previous order is kept and fixed up with an insertion sort: a pass
+// over the field when nobody moved past anyone, a few swaps for an overtake, one longer move for
+// a car crossing S/F.
+//
+// Neighbor queries start at a car's slot (O(1)) or a binary-searched position (O(log n)) and walk
+// outwards around the lap, so they cost O(k) in the number of cars they visit.
+
+class TrackOrder
+{
+    public:
+
+        // lapDistPct indexed by carIdx; cars with a negative value aren't in the world and are left out
+        void build( const float* lapDistPct )
+        {
+            int n = 0;
+            bool seen[IR_MAX_CARS] = {};
+
+            // Keep last tick's order for cars that are still around, then add the newcomers
+            for( int s=0; s<m_count; ++s )
+            {
+                const int ci = m_car[s];
+                if( lapDistPct[ci] >= 0 )
+                {
+                    m_car[n++] = ci;
+                    seen[ci] = true;
+                }
+            }
+            for( int ci=0; ci<IR_MAX_CARS; ++ci )
+                if( !seen[ci] && lapDistPct[ci] >= 0 )
+                    m_car[n++] = ci;
+            m_count = n;
+
+            for( int s=0; s<n; ++s )
+                m_pct[s] = lapDistPct[m_car[s]];
+
+            for( int s=1; s<n; ++s )
+            {
+                const int   ci = m_car[s];
+                const float p  = m_pct[s];
+                int j = s;
+                for( ; j>0 && m_pct[j-1] > p; --j )
+                {
+                    m_car[j] = m_car[j-1];
+                    m_pct[j] = m_pct[j-1];
+                }
+                m_car[j] = ci;
+                m_pct[j] = p;
+            }
+
+            for( int ci=0; ci<IR_MAX_CARS; ++ci )
+                m_slot[ci] = -1;
+            for( int s=0; s<n; ++s )
+                m_slot[m_car[s]] = (int8_t)s;
+        }
+
+        int     count() const { return m_count; }
+        int     carAt( int slot ) const { return m_car[slot]; }
+        float   pctAt( int slot ) const { return m_pct[slot]; }
+        int     slotOf( int carIdx ) const
+        {
+            if( carIdx < 0 || carIdx >= IR_MAX_CARS )
+                return -1;
+            const int s = m_slot[carIdx];
+            return s >= 0 && s < m_count && m_car[s] == carIdx ? s : -1;   // also covers "never built"
+        }
+
+        // First slot at or after pct, wrapping to 0 past the last car
+        int lowerBound( float pct ) const
+        {
+            int lo = 0, hi = m_count;
+            while( lo < hi )
+            {
+                const int mid = (lo + hi) / 2;
+                if( m_pct[mid] < pct ) lo = mid + 1;
+                else                   hi = mid;
+            }
+            return lo < m_count ? lo : 0;
+        }
+
+        // Visits cars ahead of carIdx, nearest first, up to maxPct of a lap away.
+        // f(int carIdx, float pctAhead) returns false to stop. Returns the number of cars visited.
+        template<typename F>
+        int walkAhead( int carIdx, float maxPct, F f ) const
+        {
+            const int s = slotOf( carIdx );
+            return s < 0 ? 0 : walk( s+1, m_pct[s], +1, m_count-1, maxPct, f );
+        }
+
+        // Same, for cars behind carIdx, nearest first. pctBehind is positive.
+        template<typename F>
+        int walkBehind( int carIdx, float maxPct, F f ) const
+        {
+            const int s = slotOf( carIdx );
+            return s < 0 ? 0 : walk( s-1, m_pct[s], -1, m_count-1, maxPct, f );
+        }
+
+        // Visits cars at or ahead of an arbitrary track position, nearest first
+        template<typename F>
+        int walkAheadOf( float pct, float maxPct, F f ) const
+        {
+            return m_count ? walk( lowerBound( pct ), pct, +1, m_count, maxPct, f ) : 0;
+        }
+
+        // Up to k nearest cars ahead of / behind carIdx within maxPct, nearest first. Returns how many.
+        int nearestAhead( int carIdx, int k, float maxPct, int* out ) const
+        {
+            if( k <= 0 )
+                return 0;
+            int n = 0;
+            walkAhead( carIdx, maxPct, [&]( int ci, float ) { out[n++] = ci; return n < k; } );
+            return n;
+        }
+
+        int nearestBehind( int carIdx, int k, float maxPct, int* out ) const
+        {
+            if( k <= 0 )
+                return 0;
+            int n = 0;
+            walkBehind( carIdx, maxPct, [&]( int ci, float ) { out[n++] = ci; return n < k; } );
+            return n;
+        }
+
+        // The whole field as seen from carIdx: up to half a lap ahead, furthest first, then carIdx,
+        // then the rest behind, nearest first. Returns the count and the position of carIdx in out.
+        int around( int carIdx, int* out, int& selfPos ) const
+        {
+            selfPos = -1;
+            const int s = slotOf( carIdx );
+            if( s < 0 )
+                return 0;
+
+            // Walking forwards, distance grows up to half a lap; everyone past that is behind us
+            int numAhead = 0;
+            while( numAhead < m_count-1 && fwd( m_pct[s], m_pct[(s+1+numAhead) % m_count] ) <= 0.5f )
+                numAhead++;
+
+            int n = 0;
+            for( int i=numAhead; i>=1; --i )
+                out[n++] = m_car[(s+i) % m_count];
+            selfPos = n;
+            out[n++] = carIdx;
+            for( int i=1; i<m_count-numAhead; ++i )
+                out[n++] = m_car[(s-i+m_count) % m_count];
+            return n;
+        }
+
+    private:
+
+        static float fwd( float from, float to )
+        {
+            const float d = to - from;
+            return d < 0 ? d + 1.0f : d;
+        }
+
+        template<typename F>
+        int walk( int start, float origin, int dir, int maxVisit, float maxPct, F& f ) const
+        {
+            int visited = 0;
+            for( int i=0; i<maxVisit; ++i )
+            {
+                const int   s = ((start + dir*i) % m_count + m_count) % m_count;
+                const float d = dir > 0 ? fwd( origin, m_pct[s] ) : fwd( m_pct[s], origin );
+                if( d > maxPct )
+                    break;
+                visited++;
+                if( !f( m_car[s], d ) )
+                    break;
+            }
+            return visited;
+        }
+
+        int     m_count = 0;
+        int     m_car[IR_MAX_CARS] = {};
+        float   m_pct[IR_MAX_CARS] = {};
+        int8_t  m_slot[IR_MAX_CARS] = {};
+};
@@ -0,0 +1,245 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "TrackPathDb.h"
+#include <algorithm>
+#include <vector>
+#include <string.h>
+#include <stdlib.h>
+#include "picojson.h"
+#include "Logger.h"
+
+// track-paths.db layout (little endian): Header, IndexEntry[trackCount] sorted by trackId, then the
+// per-track data the entries point at. Everything is 4-byte aligned. Keep in sync with buildTrackDb()
+// in assets/tracks/generation/track-db.js.
+static constexpr uint32_t TrackDbVersion = 1;
+
+TrackPathDb& TrackPathDb::instance()
+{
+    static TrackPathDb s_instance;
+    return s_instance;
+}
+
+bool TrackPathDb::find( int trackId, Track& out )
+{
+    out = Track();
+    if( !ensureOpen() )
+        return false;
+
+    const IndexEntry* end = m_index + m_count;
+    const IndexEntry* it = std::lower_bound( m_index, end, trackId, []( const IndexEntry& e, int id ) { return e.trackId < id; } );
+    if( it == end || it->trackId != trackId )
+        return false;
+
+    out.points            = (const float2*)(m_data + it->offset);
+    out.pointCount        = it->pointCount;
+    out.extendedLine      = (const float*)(m_data + it->offset + it->pointCount * sizeof(float2));
+    out.extendedLineCount = it->extCount;
+    return true;
+}
+
+bool TrackPathDb::ensureOpen()
+{
+    if( m_build.valid() )
+    {
+        if( m_build.wait_for( std::chrono::seconds(0) ) != std::future_status::ready )
+            return false;
+        finishBuild();
+    }
+    if( m_opened )
+        return m_index != nullptr;
+    m_opened = true;
+
+    m_dbPath = resolveAssetPathW( L"assets\\tracks\\track-paths.db" );
+    const std::wstring jsonPath = resolveAssetPathW( L"assets\\tracks\\track-paths.json" );
+
+    // Parsing the JSON takes a while; keep it off the render thread
+    if( !isFileUpToDateW( m_dbPath, jsonPath ) && fileExistsW( jsonPath ) )
+    {
+        m_build = std::async( std::launch::async, build, jsonPath, m_dbPath );
+        return false;
+    }
+    return openMapped();
+}
+
+void TrackPathDb::finishBuild()
+{
+    Built b = m_build.get();
+    if( b.saved )
+        openMapped();
+    else if( !b.blob.empty() )
+    {
+        // Read-only install location: keep this run's copy in memory
+        m_owned.swap( b.blob );
+        attach( m_owned.data(), m_owned.size() );
+    }
+    else
+        openMapped();   // JSON unusable: fall back to whatever database there is
+    ++m_generation;
+}
+
+bool TrackPathDb::openMapped()
+{
+    if( !m_map.open( m_dbPath ) )
+        return false;
+    if( !attach( m_map.data(), m_map.size() ) )
+    {
+        Logger::instance().log( LogLevel::Warning, L"Ignoring " + m_dbPath + L": unknown format" );
+        m_map.close();
+        return false;
+    }
+    return true;
+}
+
+TrackPathDb::Built TrackPathDb::build( std::wstring jsonPath, std::wstring dbPath )
+{
+    Built b;
+    std::string json;
+    if( !loadFileW( jsonPath, json ) || !buildFromJson( json, b.blob ) )
+    {
+        Logger::instance().log( LogLevel::Warning, L"Ignoring " + jsonPath + L": can't read track paths" );
+        b.blob.clear();
+        return b;
+    }
+    b.saved = replaceFileW( dbPath, b.blob );
+    Logger::instance().log( LogLevel::Info, L"Rebuilt track paths from " + jsonPath + (b.saved ? L"" : L" (in memory only)") );
+    return b;
+}
+
+bool TrackPathDb::attach( const char* data, size_t size )
+{
+    if( size < sizeof(Header) )
+        return false;
+
+    Header h;
+    memcpy( &h, data, sizeof(h) );
+    if( memcmp( h.magic, "IFTP", 4 ) != 0 || h.version != TrackDbVersion )
+        return false;
+    if( sizeof(Header) + (size_t)h.trackCount * sizeof(IndexEntry) > size )
+        return false;
+
+    // Validate every entry once, so lookups can trust the offsets
+    const IndexEntry* index = (const IndexEntry*)(data + sizeof(Header));
+    for( uint32_t i=0; i<h.trackCount; ++i )
+    {
+        const IndexEntry& e = index[i];
+        const size_t bytes = (size_t)e.pointCount * sizeof(float2) + (size_t)e.extCount * sizeof(float);
+        if( (e.offset & 3) || e.offset > size || bytes > size - e.offset )
+            return false;
+        if( i > 0 && index[i-1].trackId >= e.trackId )
+            return false;
+    }
+
+    m_data  = data;
+    m_index = index;
+    m_count = h.trackCount;
+    return true;
+}
+
+bool TrackPathDb::buildFromJson( const std::string& json, std::string& out )
+{
+    picojson::value root;
+    const std::string err = picojson::parse( root, json );
+    if( !err.empty() || !root.is<picojson::object>() )
+        return false;
+    const picojson::object& obj = root.get<picojson::object>();
+    auto itById = obj.find( "tracksById" );
+    if( itById == obj.end() || !itById->second.is<picojson::object>() )
+        return false;
+
+    struct Entry
+    {
+        int                 id = 0;
+        std::vector<float>  points;     // x,y pairs
+        std::vector<float>  ext;
+    };
+    std::vector<Entry> entries;
+
+    for( const auto& kv : itById->second.get<picojson::object>() )
+    {
+        Entry e;
+        e.id = atoi( kv.first.c_str() );
+        if( e.id <= 0 || !kv.second.is<picojson::object>() )
+            continue;
+        const picojson::object& trk = kv.second.get<picojson::object>();
+
+        auto itPts = trk.find( "points" );
+        if( itPts != trk.end() && itPts->second.is<picojson::array>() )
+        {
+            for( const picojson::value& v : itPts->second.get<picojson::array>() )
+            {
+                if( !v.is<picojson::array>() )
+                    continue;
+                const picojson::array& pair = v.get<picojson::array>();
+                if( pair.size() < 2 || !pair[0].is<double>() || !pair[1].is<double>() )
+                    continue;
+                e.points.push_back( (float)pair[0].get<double>() );
+                e.points.push_back( (float)pair[1].get<double>() );
+            }
+        }
+
+        auto itExt = trk.find( "extendedLine" );
+        if( itExt != trk.end() && itExt->second.is<picojson::array>() )
+        {
+            for( const picojson::value& v : itExt->second.get<picojson::array>() )
+                if( v.is<double>() )
+                    e.ext.push_back( (float)v.get<double>() );
+        }
+
+        entries.push_back( std::move(e) );
+    }
+    std::sort( entries.begin(), entries.end(), []( const Entry& a, const Entry& b ) { return a.id < b.id; } );
+    entries.erase( std::unique( entries.begin(), entries.end(), []( const Entry& a, const Entry& b ) { return a.id == b.id; } ), entries.end() );
+
+    size_t size = sizeof(Header) + entries.size() * sizeof(IndexEntry);
+    for( const Entry& e : entries )
+        size += (e.points.size() + e.ext.size()) * sizeof(float);
+    out.assign( size, '\0' );
+
+    Header h = {};
+    memcpy( h.magic, "IFTP", 4 );
+    h.version    = TrackDbVersion;
+    h.trackCount = (uint32_t)entries.size();
+    memcpy( &out[0], &h, sizeof(h) );
+
+    size_t offset = sizeof(Header) + entries.size() * sizeof(IndexEntry);
+    for( size_t i=0; i<entries.size(); ++i )
+    {
+        const Entry& e = entries[i];
+        IndexEntry ie = {};
+        ie.trackId    = e.id;
+        ie.offset     = (uint32_t)offset;
+        ie.pointCount = (uint32_t)(e.points.size() / 2);
+        ie.extCount   = (uint32_t)e.ext.size();
+        memcpy( &out[sizeof(Header) + i * sizeof(IndexEntry)], &ie, sizeof(ie) );
+
+        if( !e.points.empty() )
+            memcpy( &out[offset], e.points.data(), e.points.size() * sizeof(float) );
+        offset += e.points.size() * sizeof(float);
+        if( !e.ext.empty() )
+            memcpy( &out[offset], e.ext.data(), e.ext.size() * sizeof(float) );
+        offset += e.ext.size() * sizeof(float);
+    }
+    return true;
+}
@@ -0,0 +1,104 @@
+/*
+MIT License
+
+Copyright (c) 2021-2025 L. E. Spalt & Contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <future>
+#include "MappedFile.h"
+#include "util.h"
+
+// Track map paths for the Track overlay, from a prebuilt binary database (assets\tracks\track-paths.db)
+// that is memory-mapped on first use: a header, an index sorted by track id, and per track a packed
+// float2 path followed by its extended-line positions. Looking up a track is a binary search over
+// the index; nothing is parsed or copied.
+// The database is produced from track-paths.json at build time (assets\tracks\generation\build-track-db.js)
+// and shipped next to it. If the JSON is newer than the database anyway (or there is no database), it
+// is rebuilt from the JSON in the background on first use; find() reports nothing until that's done.
+// iRacing track ids are unique per layout, so the id alone identifies a track config.
+
+class TrackPathDb
+{
+    public:
+
+        struct Track
+        {
+            const float2*   points = nullptr;       // normalized 0..1, as stored
+            uint32_t        pointCount = 0;
+            const float*    extendedLine = nullptr; // lap pct positions
+            uint32_t        extendedLineCount = 0;
+        };
+
+        static TrackPathDb& instance();
+
+        // Finds a track by iRacing track id. The returned pointers stay valid for the process lifetime.
+        bool        find( int trackId, Track& out );
+
+        // Bumped when the database becomes available after a background rebuild; retry failed lookups then
+        unsigned    generation() const { return m_generation; }
+
+        // Serializes a track-paths.json document ({"tracksById":{"<id>":{"points":[[x,y],...],"extendedLine":[...]}}})
+        static bool buildFromJson( const std::string& json, std::string& out );
+
+    private:
+
+        struct Header
+        {
+            char     magic[4];      // "IFTP"
+            uint32_t version;
+            uint32_t trackCount;
+            uint32_t reserved;
+        };
+
+        struct IndexEntry
+        {
+            int32_t  trackId;
+            uint32_t offset;        // from start of file: float2 points[pointCount], then float extendedLine[extCount]
+            uint32_t pointCount;
+            uint32_t extCount;
+        };
+
+        struct Built
+        {
+            std::string blob;
+            bool        saved = false;
+        };
+
+        bool        ensureOpen();
+        void        finishBuild();
+        bool        openMapped();
+        bool        attach( const char* data, size_t size );
+        static Built build( std::wstring jsonPath, std::wstring dbPath );
+
+        MappedFile          m_map;
+        std::string         m_owned;    // used instead of the mapping if the rebuilt database can't be saved
+        std::future<Built>  m_build;    // background rebuild from the JSON
+        std::wstring        m_dbPath;
+        unsigned            m_generation = 0;
+        bool                m_opened = false;
+        const char*         m_data = nullptr;
+        const IndexEntry*   m_index = nullptr;
+        uint32_t            m_count = 0;
+};
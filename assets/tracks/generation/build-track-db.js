@@ -0,0 +1,22 @@
+// Build step: turns assets/tracks/track-paths.json into the track-paths.db the app memory-maps.
+//   node build-track-db.js [track-paths.json] [track-paths.db]
+// Does nothing if the JSON doesn't exist or the database is already newer than it.
+const fs = require('fs');
+const path = require('path');
+const { buildTrackDb } = require('./track-db.js');
+
+const jsonPath = process.argv[2] || path.join(__dirname, '..', 'track-paths.json');
+const dbPath = process.argv[3] || path.join(__dirname, '..', 'track-paths.db');
+
+if (!fs.existsSync(jsonPath)) {
+  console.log(`build-track-db: ${jsonPath} not found, skipping`);
+  process.exit(0);
+}
+if (fs.existsSync(dbPath) && fs.statSync(dbPath).mtimeMs >= fs.statSync(jsonPath).mtimeMs) {
+  process.exit(0);
+}
+
+const db = buildTrackDb(JSON.parse(fs.readFileSync(jsonPath, 'utf8')));
+fs.writeFileSync(dbPath + '.tmp', Buffer.from(db));
+fs.renameSync(dbPath + '.tmp', dbPath);
+console.log(`build-track-db: wrote ${dbPath}`);
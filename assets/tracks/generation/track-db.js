@@ -0,0 +1,50 @@
+// Writes track-paths.db, the binary track database loaded by the app, from a track-paths.json document.
+// Shared by track-gen.html and build-track-db.js.
+// Layout (see TrackPathDb.cpp, keep both in sync):
+// header "IFTP", version, track count, reserved; then per track id (ascending) an index entry
+// { id, offset, pointCount, extCount }; then each track's float32 x,y pairs followed by its extendedLine.
+function buildTrackDb(tracks) {
+  const entries = Object.entries(tracks.tracksById)
+    .filter(([id, t]) => t && typeof t === 'object' && !Array.isArray(t))
+    .map(([id, t]) => ({
+      id: parseInt(id, 10),
+      points: (t.points || []).filter(p => Array.isArray(p) && p.length >= 2 && typeof p[0] === 'number' && typeof p[1] === 'number'),
+      ext: (t.extendedLine || []).filter(v => typeof v === 'number')
+    }))
+    .filter(e => e.id > 0)
+    .sort((a, b) => a.id - b.id)
+    .filter((e, i, arr) => i === 0 || arr[i - 1].id !== e.id);
+
+  const headerSize = 16, entrySize = 16;
+  let size = headerSize + entries.length * entrySize;
+  for (const e of entries) size += e.points.length * 8 + e.ext.length * 4;
+
+  const buf = new ArrayBuffer(size);
+  const dv = new DataView(buf);
+  'IFTP'.split('').forEach((c, i) => dv.setUint8(i, c.charCodeAt(0)));
+  dv.setUint32(4, 1, true);
+  dv.setUint32(8, entries.length, true);
+  dv.setUint32(12, 0, true);
+
+  let offset = headerSize + entries.length * entrySize;
+  entries.forEach((e, i) => {
+    const base = headerSize + i * entrySize;
+    dv.setInt32(base, e.id, true);
+    dv.setUint32(base + 4, offset, true);
+    dv.setUint32(base + 8, e.points.length, true);
+    dv.setUint32(base + 12, e.ext.length, true);
+    for (const p of e.points) {
+      dv.setFloat32(offset, p[0], true);
+      dv.setFloat32(offset + 4, p[1], true);
+      offset += 8;
+    }
+    for (const v of e.ext) {
+      dv.setFloat32(offset, v, true);
+      offset += 4;
+    }
+  });
+  return buf;
+}
+
+if (typeof module !== 'undefined')
+  module.exports = { buildTrackDb };
@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include "iracing.h"
 #include "Config.h"
+#include "Profiler.h"
 
 irsdkCVar ir_SessionTime("SessionTime");    // double[1] Seconds since session start (s)
 irsdkCVar ir_SessionTick("SessionTick");    // int[1] Current update number ()
@@ -404,13 +405,17 @@ ConnectionStatus ir_tick()
 {
     irsdkClient& irsdk = irsdkClient::instance();
 
-    irsdk.waitForData(16);
+    {
+        PROFILE_SCOPE( "ir.wait" );
+        irsdk.waitForData(16);
+    }
 
     if( !irsdk.isConnected() )
         return ConnectionStatus::DISCONNECTED;
 
     if( irsdk.wasSessionStrUpdated() )
     {
+        PROFILE_SCOPE( "ir.session" );
         const char* sessionYaml = irsdk.getSessionStr();
 #ifdef _DEBUG
         //printf("%s\n", sessionYaml);
@@ -45,6 +45,11 @@ SOFTWARE.
 #include "iracing.h"
 #include "Config.h"
 #include "Logger.h"
+#include "Profiler.h"
+#include "RaceState.h"
+#include "FuelModel.h"
+#include "FuelStrategy.h"
+#include "GhostRecorder.h"
 #include "OverlayCover.h"
 #include "OverlayRelative.h"
 #include "OverlayInputs.h"
@@ -60,6 +65,8 @@ SOFTWARE.
 #include "OverlayTire.h"
 #include "OverlayPit.h"
 #include "OverlayTraffic.h"
+#include "CarBrandIcons.h"
+#include "ImageAssets.h"
 #include "GuiCEF.h"
 #include "AppControl.h"
 #include "preview_mode.h"
@@ -112,7 +119,8 @@ enum class Hotkey
     Radar, 
     Track,
     Pit,
-    Traffic
+    Traffic,
+    DeltaPin
 };
 
 static void registerHotkeys()
@@ -132,6 +140,7 @@ static void registerHotkeys()
     UnregisterHotKey( NULL, (int)Hotkey::Track );
     UnregisterHotKey( NULL, (int)Hotkey::Pit );
     UnregisterHotKey( NULL, (int)Hotkey::Traffic );
+    UnregisterHotKey( NULL, (int)Hotkey::DeltaPin );
     // Custom overlays can add more hotkeys by extending this enum & list
 
     UINT vk, mod;
@@ -180,6 +189,10 @@ static void registerHotkeys()
     
     if( parseHotkey( g_cfg.getString("OverlayTraffic","toggle_hotkey","ctrl+shift+4"),&mod,&vk) )
         RegisterHotKey( NULL, (int)Hotkey::Traffic, mod, vk );
+
+    // Not a toggle: pins the last clean lap as the delta overlay's "pinned" reference
+    if( parseHotkey( g_cfg.getString("OverlayDelta","pin_hotkey","ctrl+shift+9"),&mod,&vk) )
+        RegisterHotKey( NULL, (int)Hotkey::DeltaPin, mod, vk );
     // Optional: user can bind OverlayTire via config; reuse General/ui to avoid extra enum churn
 }
 
@@ -189,11 +202,14 @@ static void handleConfigChange( std::vector<Overlay*> overlays, ConnectionStatus
 
     ir_handleConfigChange();
 
+    Profiler::instance().setEnabled( g_cfg.getBool("General", "profiler_enabled", false) );
+    Tracer::setEnabled( g_cfg.getBool("General", "trace_enabled", false) );
+
     const bool replaySession = ir_session.isReplay;
 
     for( Overlay* o : overlays )
     {
-        bool overlayEnabled = g_cfg.getBool(o->getName(),"enabled",true);
+        bool overlayEnabled = o->isEnabledInConfig();
         
         // Check show_in_menu and show_in_race settings
         bool showInMenu = g_cfg.getBool(o->getName(), "show_in_menu", true);
@@ -272,6 +288,7 @@ static DWORD g_lastConfigReloadLogTick = 0;
 int main()
 {
     Logger::instance().logInfo("iFL03 starting");
+    Tracer::setThreadName( "main" );
 
     // Single-instance guard for the main/browser process only (skip CEF sub-processes)
     HANDLE singleInstanceMutex = NULL;
@@ -431,6 +448,7 @@ int main()
     printf("    Toggle track overlay:         %s\n", g_cfg.getString("OverlayTrack","toggle_hotkey","").c_str() );
     printf("    Toggle pit overlay:           %s\n", g_cfg.getString("OverlayPit","toggle_hotkey","").c_str() );
     printf("    Toggle traffic overlay:       %s\n", g_cfg.getString("OverlayTraffic","toggle_hotkey","").c_str() );
+    printf("    Pin delta reference lap:      %s\n", g_cfg.getString("OverlayDelta","pin_hotkey","").c_str() );
     printf("\niFL03 will generate a file called \'config.json\' in its current directory. This file\n"\
            "stores your settings. You can edit the file at any time, even while iFL03 is running,\n"\
            "to customize your overlays and hotkeys.\n\n");
@@ -441,20 +459,25 @@ int main()
     printf("\nHappy Racing!\n");
     printf("====================================================================================\n\n");
 
-    // Preload car brand icons once
-    std::map<std::string, IWICFormatConverter*> carBrandIcons;
-    const bool carBrandIconsLoaded = loadCarBrandIcons(carBrandIcons);
+    // Enumerate car brand icons; they are decoded on demand as cars show up
+    CarBrandIcons::instance().init();
+
+    // Decode shared overlay images in the background so enabling an overlay doesn't wait on disk
+    ImageAssets::instance().prefetch({
+        L"assets\\icons\\up.png", L"assets\\icons\\down.png", L"assets\\icons\\equal.png", L"assets\\icons\\pushtotalk.png",
+        L"assets\\icons\\incidents.png", L"assets\\icons\\SoF.png", L"assets\\icons\\temp_dark.png",
+        L"assets\\icons\\session_time.png", L"assets\\icons\\laps.png",
+        L"assets\\icons\\track_temp.png", L"assets\\icons\\waterdrop.png", L"assets\\icons\\sun.png",
+        L"assets\\icons\\precipitation.png", L"assets\\icons\\wind.png",
+        L"assets\\sports_car.png", L"assets\\wind_arrow.png"
+    });
 
     // Create overlays
     std::vector<Overlay*> overlays;
     overlays.push_back( new OverlayCover() );
     overlays.push_back( new OverlayRelative() );
     overlays.push_back( new OverlayInputs() );
-    {
-        auto* st = new OverlayStandings();
-        st->setCarBrandIcons(carBrandIcons, carBrandIconsLoaded);
-        overlays.push_back(st);
-    }
+    overlays.push_back( new OverlayStandings() );
     overlays.push_back( new OverlayDDU() );
     overlays.push_back( new OverlayFuel() );
     overlays.push_back( new OverlayTire() );
@@ -469,9 +492,7 @@ int main()
     overlays.push_back( new OverlayTrack() );
     overlays.push_back( new OverlayPit() );
     overlays.push_back( new OverlayTraffic() );
-#ifdef _DEBUG
     overlays.push_back( new OverlayDebug() );
-#endif
 
     ConnectionStatus  status   = ConnectionStatus::UNKNOWN;
     bool              uiEdit   = false;
@@ -490,7 +511,15 @@ int main()
         bool             prevHasDriver    = ir_hasValidDriver();
 
         // Refresh connection and session info
-        status = ir_tick();
+        {
+            TRACE_SCOPE( "ir_tick" );
+            status = ir_tick();
+        }
+
+        // Per-car derived state shared by all overlays, once per new sim tick
+        ir_race.update();
+        ir_fuel.update();
+        ir_ghost.update();
         const bool nowHasDriver = ir_hasValidDriver();
         const int  nowStatusID  = irsdkClient::instance().getStatusID();
         if( status != prevStatus )
@@ -585,6 +614,7 @@ int main()
         // Watch for config change signal
         if( g_cfg.hasChanged() )
         {
+            PROFILE_SCOPE( "config.reload" );
             if (!g_cfg.load())
             {
                 Logger::instance().logError("Config reload failed");
@@ -629,6 +659,10 @@ int main()
                     if( !uiEdit )
                         giveFocusToIracing();
                 }
+                else if( msg.wParam == (int)Hotkey::DeltaPin )
+                {
+                    ir_race.delta.pinLastLap();
+                }
                 else
                 {
                     switch( msg.wParam )
@@ -696,7 +730,10 @@ int main()
 
 #ifdef IFL03_USE_CEF
         // Allow CEF to process pending work when using the external pump
-        cefDoMessageLoopWork();
+        {
+            TRACE_SCOPE( "cef.loop" );
+            cefDoMessageLoopWork();
+        }
 #endif
 
         frameCnt++;
@@ -710,12 +747,12 @@ int main()
         delete o;
     overlays.clear();
 
-    // Release car brand icon converters (loadCarBrandIcons() AddRef's them into this map).
-    for (auto& it : carBrandIcons)
-    {
-        if (it.second) it.second->Release();
-    }
-    carBrandIcons.clear();
+    // Persist any newly decoded car brand icons
+    CarBrandIcons::instance().shutdown();
+    ImageAssets::instance().shutdown();
+    ir_fuel.shutdown();
+    ir_strategy.shutdown();
+    ir_ghost.shutdown();
 
 #ifdef IFL03_USE_CEF
     cefShutdown();
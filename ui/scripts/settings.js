@@ -29,6 +29,34 @@ function setupEventListeners() {
 		});
 	}
 
+	// Frame profiler toggle and CSV export
+	const profilerCheckbox = document.getElementById('chk_profiler');
+	if (profilerCheckbox) {
+		profilerCheckbox.addEventListener('change', function() {
+			sendCommand('setConfigBool', { component: 'General', key: 'profiler_enabled', value: this.checked });
+		});
+	}
+	const exportProfileBtn = document.getElementById('btn-export-profile');
+	if (exportProfileBtn) {
+		exportProfileBtn.addEventListener('click', function() {
+			sendCommand('exportProfile', {});
+		});
+	}
+
+	// Event tracer toggle and dump
+	const tracerCheckbox = document.getElementById('chk_tracer');
+	if (tracerCheckbox) {
+		tracerCheckbox.addEventListener('change', function() {
+			sendCommand('setConfigBool', { component: 'General', key: 'trace_enabled', value: this.checked });
+		});
+	}
+	const dumpTraceBtn = document.getElementById('btn-dump-trace');
+	if (dumpTraceBtn) {
+		dumpTraceBtn.addEventListener('click', function() {
+			sendCommand('dumpTrace', {});
+		});
+	}
+
 	// Save settings button
 	const saveButton = document.getElementById('save_settings');
 	if (saveButton) {
@@ -99,6 +127,18 @@ function updateUI() {
 		performanceModeCheckbox.checked = currentState.config.General?.performance_mode_30hz || false;
 	}
 
+	// Update frame profiler
+	const profilerCheckbox = document.getElementById('chk_profiler');
+	if (profilerCheckbox && currentState.config) {
+		profilerCheckbox.checked = currentState.config.General?.profiler_enabled || false;
+	}
+
+	// Update event tracer
+	const tracerCheckbox = document.getElementById('chk_tracer');
+	if (tracerCheckbox && currentState.config) {
+		tracerCheckbox.checked = currentState.config.General?.trace_enabled || false;
+	}
+
 	// Update units
 	const unitsSel = document.getElementById('sel_units');
 	if (unitsSel && currentState.config) {
@@ -37,6 +37,10 @@ SOFTWARE.
 #include <wrl.h>
 #include <wincodec.h>
 #include <unordered_map>
+#include <list>
+#include <memory>
+#include <string_view>
+#include <algorithm>
 #include <ctype.h>
 #include <map>
 #include <filesystem>
@@ -164,6 +168,35 @@ inline bool loadFileW( const std::wstring& fnameW, std::string& output )
     return true;
 }
 
+// Writes to a temporary file next to the target and swaps it in, so readers never see a partial file
+inline bool replaceFileW( const std::wstring& fnameW, const std::string& s )
+{
+    const std::wstring tmp = fnameW + L".tmp";
+    FILE* fp = _wfopen( tmp.c_str(), L"wb" );
+    if( !fp )
+        return false;
+
+    const bool ok = fwrite( s.data(), 1, s.length(), fp ) == s.length();
+    fclose( fp );
+    if( !ok || !MoveFileExW( tmp.c_str(), fnameW.c_str(), MOVEFILE_REPLACE_EXISTING ) )
+    {
+        DeleteFileW( tmp.c_str() );
+        return false;
+    }
+    return true;
+}
+
+// True if 'derived' exists and was written no earlier than 'source' (or 'source' doesn't exist)
+inline bool isFileUpToDateW( const std::wstring& derived, const std::wstring& source )
+{
+    WIN32_FILE_ATTRIBUTE_DATA d = {}, s = {};
+    if( !GetFileAttributesExW( derived.c_str(), GetFileExInfoStandard, &d ) )
+        return false;
+    if( !GetFileAttributesExW( source.c_str(), GetFileExInfoStandard, &s ) )
+        return true;
+    return CompareFileTime( &d.ftLastWriteTime, &s.ftLastWriteTime ) >= 0;
+}
+
 inline std::wstring toWide(const std::string& narrow)
 {
     if (narrow.empty()) return L"";
@@ -238,86 +271,6 @@ inline std::wstring resolveAssetPathW(const std::wstring& relative)
     return relative;
 }
 
-// --------------------
-// Car brand icons
-// --------------------
-inline bool loadCarBrandIcons(std::map<std::string, IWICFormatConverter*>& outIconMap)
-{
-    outIconMap.clear();
-
-    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    (void)hr; // safe to ignore S_FALSE
-
-    Microsoft::WRL::ComPtr<IWICImagingFactory> wic;
-    if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wic))))
-        return false;
-
-    const std::wstring dir = resolveAssetPathW(L"assets\\carIcons\\");
-
-    WIN32_FIND_DATAW fd = {};
-    HANDLE h = FindFirstFileW((dir + L"*.png").c_str(), &fd);
-    if (h == INVALID_HANDLE_VALUE)
-        return false;
-
-    do {
-        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
-            continue;
-        std::wstring fileW = dir + fd.cFileName;
-
-        Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
-        if (FAILED(wic->CreateDecoderFromFilename(fileW.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder)))
-            continue;
-        Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
-        if (FAILED(decoder->GetFrame(0, &frame)))
-            continue;
-        Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
-        if (FAILED(wic->CreateFormatConverter(&converter)))
-            continue;
-        if (FAILED(converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut)))
-            continue;
-
-        // Key name = filename without extension (lowercased)
-        std::wstring fnameW(fd.cFileName);
-        size_t dot = fnameW.find_last_of(L'.');
-        if (dot != std::wstring::npos) fnameW = fnameW.substr(0, dot);
-        std::string key;
-        key.reserve(fnameW.size());
-        for (wchar_t c : fnameW) key.push_back((char)tolower((unsigned short)c));
-
-        // Store raw pointer and AddRef to keep alive beyond ComPtr lifetime
-        IWICFormatConverter* raw = converter.Get();
-        if (raw) raw->AddRef();
-        outIconMap[key] = raw;
-    } while (FindNextFileW(h, &fd));
-
-    FindClose(h);
-    return !outIconMap.empty();
-}
-
-inline IWICFormatConverter* findCarBrandIcon(const std::string& carName, const std::map<std::string, IWICFormatConverter*>& iconMap)
-{
-    // Normalize car name
-    std::string name = carName;
-    for (char& c : name) c = (char)tolower((unsigned char)c);
-
-    // Try simple contains on known keys
-    IWICFormatConverter* best = nullptr;
-    size_t bestLen = 0;
-    for (const auto& [key, conv] : iconMap)
-    {
-        if (!conv) continue;
-        if (key == "00error") { if (!best) best = conv; continue; }
-        // Allow underscore or space equivalence
-        std::string k = key;
-        for (char& c : k) if (c == '_') c = ' ';
-        if (name.find(k) != std::string::npos)
-        {
-            if (k.length() > bestLen) { best = conv; bestLen = k.length(); }
-        }
-    }
-    return best; // may be nullptr; caller can fallback to default
-}
-
 inline std::string formatLaptime( float secs )
 {
     char s[32];
@@ -483,26 +436,58 @@ class TextCache
 {
     public:
 
+        struct Stats
+        {
+            uint64_t    hits = 0;
+            uint64_t    misses = 0;
+            uint64_t    evictions = 0;
+            size_t      size = 0;
+            size_t      capacity = 0;
+        };
+
+        explicit TextCache( size_t capacity = 512 )
+            : m_capacity( std::max<size_t>(1, capacity) )
+        {}
+
         ~TextCache()
         {
             reset();
         }
 
+        TextCache( const TextCache& ) = delete;
+        TextCache& operator=( const TextCache& ) = delete;
+
         void reset( IDWriteFactory* factory=nullptr )
         {
-            for( auto& it : m_cache )
-                it.second->Release();
+            for( Entry& e : m_lru )
+                e.layout->Release();
 
-            m_cache.clear();
+            m_lru.clear();
+            m_index.clear();
             m_factory = factory;
         }
 
+        // Least recently used layouts get evicted once 'capacity' is exceeded.
+        void setCapacity( size_t capacity )
+        {
+            m_capacity = std::max<size_t>( 1, capacity );
+            trim();
+        }
+
+        Stats getStats() const
+        {
+            Stats st = m_stats;
+            st.size = m_lru.size();
+            st.capacity = m_capacity;
+            return st;
+        }
+
         //
         // Render some text, using a cached TextLayout if possible.
         // This works around spending ungodly amount of CPU cycles on ID2D1RenderTarget::DrawText.
         //
         // Assumption: all values stored in 'textFormat' are invariant between calls to this function, except horizontal alignment.
-        // Which is why we're including alignment in the hash explicitly, and otherwise just include the text format pointer.
+        // Which is why the key holds alignment explicitly, and otherwise just the text format pointer.
         // This isn't bullet proof, since a user could get the same address again for a newly (re-)created text format. But in our usage
         // patterns, recreating text formats always implies nuking this cache anyway, so don't bother with a more complicated design.
         //
@@ -520,7 +505,6 @@ class TextCache
 
             const float fontSize = textFormat->GetFontSize();
 
-            const D2D1_RECT_F r = { xmin, ycenter-fontSize, xmax, ycenter+fontSize };
             renderTarget->DrawTextLayout( float2(xmin,ycenter-fontSize), textLayout, brush, D2D1_DRAW_TEXT_OPTIONS_CLIP );
         }
 
@@ -541,6 +525,69 @@ class TextCache
 
     private:
 
+        // Everything that determines the layout. Compared in full, so a hash collision can't
+        // hand back a layout for different text.
+        struct KeyView
+        {
+            std::wstring_view       str;
+            IDWriteTextFormat*      format;
+            float                   width;
+            DWRITE_TEXT_ALIGNMENT   align;
+            float                   spacing;
+        };
+
+        struct Key
+        {
+            std::wstring            str;
+            IDWriteTextFormat*      format;
+            float                   width;
+            DWRITE_TEXT_ALIGNMENT   align;
+            float                   spacing;
+
+            KeyView view() const { return { str, format, width, align, spacing }; }
+        };
+
+        struct KeyHash
+        {
+            using is_transparent = void;
+
+            size_t operator()( const KeyView& k ) const
+            {
+                unsigned h = MurmurHash2( k.str.data(), (int)(k.str.size()*sizeof(wchar_t)), 0x12341234 );
+                h = MurmurHash2( &k.format, sizeof(k.format), h );
+                h = MurmurHash2( &k.width, sizeof(k.width), h );
+                h = MurmurHash2( &k.align, sizeof(k.align), h );
+                h = MurmurHash2( &k.spacing, sizeof(k.spacing), h );
+                return h;
+            }
+            size_t operator()( const Key& k ) const { return (*this)( k.view() ); }
+        };
+
+        struct KeyEq
+        {
+            using is_transparent = void;
+
+            static bool eq( const KeyView& a, const KeyView& b )
+            {
+                return a.format == b.format && a.align == b.align
+                    && memcmp( &a.width, &b.width, sizeof(float) ) == 0
+                    && memcmp( &a.spacing, &b.spacing, sizeof(float) ) == 0
+                    && a.str == b.str;
+            }
+            bool operator()( const KeyView& a, const KeyView& b ) const { return eq( a, b ); }
+            bool operator()( const Key& a, const KeyView& b ) const { return eq( a.view(), b ); }
+            bool operator()( const KeyView& a, const Key& b ) const { return eq( a, b.view() ); }
+            bool operator()( const Key& a, const Key& b ) const { return eq( a.view(), b.view() ); }
+        };
+
+        struct Entry
+        {
+            Key                 key;
+            IDWriteTextLayout*  layout;
+        };
+
+        using LruList = std::list<Entry>;
+
         IDWriteTextLayout* getOrCreateTextLayout( const wchar_t* str, IDWriteTextFormat* textFormat, float xmin, float xmax, DWRITE_TEXT_ALIGNMENT align, float characterSpacing = 0.0f )
         {
             // Defensive: this can be called during overlay config changes where
@@ -560,45 +607,245 @@ class TextCache
 
             textFormat->SetTextAlignment( align );
 
-            unsigned hash = MurmurHash2( str, len*sizeof(wchar_t), 0x12341234 );
-            hash ^= (unsigned)(uint64_t(textFormat) & 0xffffffff);
-            hash ^= (unsigned)(uint64_t(textFormat) >> 32);
-            hash ^= *((unsigned*)&width);
-            hash ^= (unsigned)align;
-            hash ^= *((unsigned*)&characterSpacing);
+            const KeyView kv = { std::wstring_view(str,len), textFormat, width, align, characterSpacing };
+
+            auto it = m_index.find( kv );
+            if( it != m_index.end() )
+            {
+                // Move to front (most recently used)
+                m_lru.splice( m_lru.begin(), m_lru, it->second );
+                m_stats.hits++;
+                return it->second->layout;
+            }
+
+            m_stats.misses++;
 
             IDWriteTextLayout* textLayout = nullptr;
+            const HRESULT hr = m_factory->CreateTextLayout( str, len, textFormat, width, fontSize*2, &textLayout );
+            if( FAILED(hr) || !textLayout )
+                return nullptr;
+            
+            // Apply character spacing if specified
+            if( characterSpacing != 0.0f && textLayout )
+            {
+                Microsoft::WRL::ComPtr<IDWriteTextLayout1> textLayout1;
+                if( SUCCEEDED(textLayout->QueryInterface(__uuidof(IDWriteTextLayout1), &textLayout1)) )
+                {
+                    DWRITE_TEXT_RANGE textRange = { 0, (UINT32)len };
+                    textLayout1->SetCharacterSpacing( characterSpacing, characterSpacing, 0, textRange );
+                }
+            }
 
-            auto it = m_cache.find( hash );
+            m_lru.push_front( Entry{ Key{ std::wstring(str,len), textFormat, width, align, characterSpacing }, textLayout } );
+            m_index.emplace( m_lru.front().key, m_lru.begin() );
+            trim();
+
+            return textLayout;
+        }
 
-            if( it == m_cache.end() )
+        void trim()
+        {
+            while( m_lru.size() > m_capacity )
             {
-                const HRESULT hr = m_factory->CreateTextLayout( str, len, textFormat, width, fontSize*2, &textLayout );
-                if( FAILED(hr) || !textLayout )
-                    return nullptr;
-                
-                // Apply character spacing if specified
-                if( characterSpacing != 0.0f && textLayout )
+                Entry& victim = m_lru.back();
+                m_index.erase( victim.key );
+                victim.layout->Release();
+                m_lru.pop_back();
+                m_stats.evictions++;
+            }
+        }
+
+        LruList                                                 m_lru;
+        std::unordered_map<Key,LruList::iterator,KeyHash,KeyEq> m_index;
+        size_t                                                  m_capacity;
+        Stats                                                   m_stats;
+        IDWriteFactory*                                         m_factory = nullptr;
+};
+
+//
+// Renders short, frequently changing strings (deltas, lap times, gaps, fuel numbers) as glyph runs
+// composed from per-format glyph indices/advances that are shaped once, instead of creating a new
+// IDWriteTextLayout for every distinct value. Latin-1 only, no kerning/ligatures, single line;
+// anything else (or text that doesn't fit the box) is handed to the fallback TextCache, so callers
+// can use it as a drop-in replacement for TextCache::render().
+//
+class NumericText
+{
+    public:
+
+        void reset( IDWriteFactory* factory=nullptr, TextCache* fallback=nullptr )
+        {
+            m_fonts.clear();
+            m_factory = factory;
+            m_fallback = fallback;
+        }
+
+        void render( ID2D1RenderTarget* renderTarget, const wchar_t* str, IDWriteTextFormat* textFormat, float xmin, float xmax, float ycenter, ID2D1SolidColorBrush* brush, DWRITE_TEXT_ALIGNMENT align, float characterSpacing = 0.0f )
+        {
+            if( !renderTarget || !brush || !str || !textFormat )
+                return;
+
+            const FontGlyphs* fg = getFontGlyphs( textFormat );
+            const int len = (int)wcslen( str );
+            if( !fg || len <= 0 || len > MaxChars || xmax <= xmin )
+            {
+                fallback( renderTarget, str, textFormat, xmin, xmax, ycenter, brush, align, characterSpacing );
+                return;
+            }
+
+            // DWrite's character spacing adds 'leading' before and 'trailing' after every glyph
+            UINT16 indices[MaxChars];
+            float  advances[MaxChars];
+            float  width = 0;
+            for( int i=0; i<len; ++i )
+            {
+                const wchar_t c = str[i];
+                if( c < FirstChar || c > LastChar || fg->index[c-FirstChar] == 0 )
                 {
-                    Microsoft::WRL::ComPtr<IDWriteTextLayout1> textLayout1;
-                    if( SUCCEEDED(textLayout->QueryInterface(__uuidof(IDWriteTextLayout1), &textLayout1)) )
-                    {
-                        DWRITE_TEXT_RANGE textRange = { 0, (UINT32)len };
-                        textLayout1->SetCharacterSpacing( characterSpacing, characterSpacing, 0, textRange );
-                    }
+                    fallback( renderTarget, str, textFormat, xmin, xmax, ycenter, brush, align, characterSpacing );
+                    return;
                 }
-                m_cache.insert( std::make_pair(hash, textLayout) );
+                indices[i]  = fg->index[c-FirstChar];
+                advances[i] = fg->advance[c-FirstChar] + 2*characterSpacing;
+                width += advances[i];
             }
-            else
+
+            // Layouts clip to their box; we don't, so let the layout path handle overflow
+            if( width > xmax - xmin )
             {
-                textLayout = it->second;
+                fallback( renderTarget, str, textFormat, xmin, xmax, ycenter, brush, align, characterSpacing );
+                return;
             }
 
-            return textLayout;
+            float x = xmin;
+            if( align == DWRITE_TEXT_ALIGNMENT_TRAILING )
+                x = xmax - width;
+            else if( align == DWRITE_TEXT_ALIGNMENT_CENTER )
+                x = xmin + (xmax - xmin - width) * 0.5f;
+
+            DWRITE_GLYPH_RUN run = {};
+            run.fontFace      = fg->face.Get();
+            run.fontEmSize    = fg->emSize;
+            run.glyphCount    = (UINT32)len;
+            run.glyphIndices  = indices;
+            run.glyphAdvances = advances;
+
+            renderTarget->DrawGlyphRun( float2(x + characterSpacing, ycenter - fg->emSize + fg->baseline), &run, brush, DWRITE_MEASURING_MODE_NATURAL );
+        }
+
+    private:
+
+        static constexpr wchar_t FirstChar = 0x20;
+        static constexpr wchar_t LastChar  = 0xff;
+        static constexpr int     MaxChars  = 64;
+
+        struct FontGlyphs
+        {
+            Microsoft::WRL::ComPtr<IDWriteFontFace> face;
+            float               emSize = 0;
+            DWRITE_FONT_WEIGHT  weight = DWRITE_FONT_WEIGHT_NORMAL;
+            DWRITE_FONT_STYLE   style = DWRITE_FONT_STYLE_NORMAL;
+            DWRITE_FONT_STRETCH stretch = DWRITE_FONT_STRETCH_NORMAL;
+            float               baseline = 0;   // relative to the top of TextCache's layout box
+            bool                ok = false;
+            UINT16              index[LastChar-FirstChar+1] = {};
+            float               advance[LastChar-FirstChar+1] = {};
+        };
+
+        void fallback( ID2D1RenderTarget* renderTarget, const wchar_t* str, IDWriteTextFormat* textFormat, float xmin, float xmax, float ycenter, ID2D1SolidColorBrush* brush, DWRITE_TEXT_ALIGNMENT align, float characterSpacing )
+        {
+            if( m_fallback )
+                m_fallback->render( renderTarget, str, textFormat, xmin, xmax, ycenter, brush, align, characterSpacing );
+        }
+
+        const FontGlyphs* getFontGlyphs( IDWriteTextFormat* textFormat )
+        {
+            if( !m_factory )
+                return nullptr;
+
+            // Text formats get recreated on config changes, possibly at the same address. The
+            // cheap properties below catch that, unlike a plain pointer key.
+            auto it = m_fonts.find( textFormat );
+            if( it != m_fonts.end() )
+            {
+                const FontGlyphs& fg = *it->second;
+                if( fg.emSize == textFormat->GetFontSize() && fg.weight == textFormat->GetFontWeight() &&
+                    fg.style == textFormat->GetFontStyle() && fg.stretch == textFormat->GetFontStretch() )
+                    return fg.ok ? &fg : nullptr;
+            }
+
+            auto fg = std::make_unique<FontGlyphs>();
+            fg->emSize  = textFormat->GetFontSize();
+            fg->weight  = textFormat->GetFontWeight();
+            fg->style   = textFormat->GetFontStyle();
+            fg->stretch = textFormat->GetFontStretch();
+            fg->ok      = shape( textFormat, *fg );
+
+            const FontGlyphs* ret = fg->ok ? fg.get() : nullptr;
+            m_fonts[textFormat] = std::move( fg );
+            return ret;
+        }
+
+        bool shape( IDWriteTextFormat* textFormat, FontGlyphs& fg )
+        {
+            Microsoft::WRL::ComPtr<IDWriteFontCollection> collection;
+            textFormat->GetFontCollection( &collection );
+            if( !collection && FAILED(m_factory->GetSystemFontCollection( &collection )) )
+                return false;
+
+            wchar_t family[256] = {};
+            if( textFormat->GetFontFamilyNameLength() >= _countof(family) || FAILED(textFormat->GetFontFamilyName( family, _countof(family) )) )
+                return false;
+
+            UINT32 familyIdx = 0;
+            BOOL exists = FALSE;
+            if( FAILED(collection->FindFamilyName( family, &familyIdx, &exists )) || !exists )
+                return false;
+
+            Microsoft::WRL::ComPtr<IDWriteFontFamily> fontFamily;
+            Microsoft::WRL::ComPtr<IDWriteFont> font;
+            if( FAILED(collection->GetFontFamily( familyIdx, &fontFamily )) ||
+                FAILED(fontFamily->GetFirstMatchingFont( fg.weight, fg.stretch, fg.style, &font )) ||
+                FAILED(font->CreateFontFace( &fg.face )) )
+                return false;
+
+            DWRITE_FONT_METRICS fm = {};
+            fg.face->GetMetrics( &fm );
+            if( fm.designUnitsPerEm == 0 )
+                return false;
+
+            UINT32 codepoints[LastChar-FirstChar+1];
+            for( int i=0; i<=LastChar-FirstChar; ++i )
+                codepoints[i] = FirstChar + i;
+            if( FAILED(fg.face->GetGlyphIndices( codepoints, _countof(codepoints), fg.index )) )
+                return false;
+
+            DWRITE_GLYPH_METRICS gm[LastChar-FirstChar+1] = {};
+            if( FAILED(fg.face->GetDesignGlyphMetrics( fg.index, _countof(fg.index), gm, FALSE )) )
+                return false;
+            const float scale = fg.emSize / (float)fm.designUnitsPerEm;
+            for( int i=0; i<=LastChar-FirstChar; ++i )
+                fg.advance[i] = (float)gm[i].advanceWidth * scale;
+
+            // Vertical placement must match the layout path exactly, so measure the baseline from
+            // a one-off layout with the same box TextCache uses.
+            Microsoft::WRL::ComPtr<IDWriteTextLayout> layout;
+            if( FAILED(m_factory->CreateTextLayout( L"0", 1, textFormat, 1000.0f, fg.emSize*2, &layout )) )
+                return false;
+            DWRITE_TEXT_METRICS tm = {};
+            DWRITE_LINE_METRICS lm = {};
+            UINT32 lineCount = 0;
+            layout->GetMetrics( &tm );
+            if( FAILED(layout->GetLineMetrics( &lm, 1, &lineCount )) || lineCount < 1 )
+                return false;
+            fg.baseline = tm.top + lm.baseline;
+
+            return true;
         }
 
-        std::unordered_map<unsigned int,IDWriteTextLayout*>  m_cache;
-        IDWriteFactory*                                      m_factory = nullptr;
+        std::unordered_map<IDWriteTextFormat*,std::unique_ptr<FontGlyphs>>  m_fonts;
+        IDWriteFactory*     m_factory = nullptr;
+        TextCache*          m_fallback = nullptr;
 };
 
 inline float2 computeTextExtent( const wchar_t* str, IDWriteFactory* factory, IDWriteTextFormat* textFormat, float characterSpacing = 0.0f )